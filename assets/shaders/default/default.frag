@@ -1,7 +1,21 @@
 #version 330 core
 out vec4 FragColor;
 
+struct MaterialParams {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 params;
+};
+
+layout (std140) uniform MaterialData {
+    MaterialParams materials[256];
+};
+
+flat in int vMaterial;
+in vec4 vTint;
+
 void main()
 {
-    FragColor = vec4(0.7, 0.7, 0.7, 1.0);
+    FragColor = vec4(vec3(0.7) * vTint.rgb, materials[vMaterial].params.y * vTint.a);
 } 
\ No newline at end of file
@@ -1,11 +1,24 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 4) in mat4 aModel;
+layout (location = 8) in vec4 aPositionScale;
+layout (location = 9) in vec4 aPositionOffset;
+layout (location = 10) in vec4 aTint;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 viewPos;
+};
+
+flat out int vMaterial;
+out vec4 vTint;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vMaterial = int(aPositionOffset.w);
+    vTint = aTint;
+    gl_Position = projection * view * aModel * vec4(aPos * aPositionScale.xyz + aPositionOffset.xyz, 1.0);
 }
\ No newline at end of file
@@ -1,13 +1,50 @@
 #include "Engine.h"
 #include "renderer/RendererInit.h"
 #include "backend/OBJLoader.h"
+#include "backend/ThreadPool.h"
+#include "backend/MeshSimplifier.h"
+#include "backend/ModelBVH.h"
+#include "backend/MeshCache.h"
+#include "backend/FileWatcher.h"
+#include "backend/VirtualFileSystem.h"
+#include "backend/StageBundle.h"
+#include "backend/StageStreamer.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <future>
 
 class OGLRenderer;
 
+const std::string Engine::ASSET_ARCHIVE = "assets.pfpak";
+const std::string Engine::DEFAULT_STAGE = "assets/maps/default";
+
+struct Engine::PendingLoad {
+    std::string name;
+    std::string filepath;
+    bool activate;
+    bool loaded;
+    bool reload;
+    std::chrono::steady_clock::time_point started;
+    Model model;
+    std::future<OBJLoader::LoadResult> result;
+    std::future<bool> bvhBuilt;
+    std::unique_ptr<ModelBVH> bvh;
+    
+    PendingLoad() : activate(false), loaded(false), reload(false) {}
+};
+
+struct Engine::PendingBVH {
+    std::string name;
+    const Model* model;
+    std::chrono::steady_clock::time_point started;
+    std::unique_ptr<ModelBVH> bvh;
+    std::future<bool> built;
+    
+    PendingBVH() : model(nullptr) {}
+};
+
 Engine::Engine() 
     : m_initialized(false)
     , m_running(false)
@@ -18,7 +55,10 @@ Engine::Engine()
     , m_deltaTime(0.0f)
     , m_fps(0.0f)
     , m_lastFrameTime(0.0f)
-    , m_targetFrameTime(0.0f) {
+    , m_targetFrameTime(0.0f)
+    , m_models(std::make_unique<AssetRegistry<Model>>())
+    , m_stageStreamer(std::make_unique<StageStreamer>())
+    , m_stageStreaming(true) {
 }
 
 Engine::~Engine() {
@@ -42,6 +82,13 @@ bool Engine::Initialize(int width, int height, const char* title, RendererType t
     }
 
     m_modelLoader = std::make_unique<OBJLoader>();
+    ConfigureModelLoader(*m_modelLoader);
+    m_threadPool = std::make_unique<ThreadPool>();
+    
+    VirtualFileSystem& fileSystem = VirtualFileSystem::GetDefault();
+    if (fileSystem.GetMountCount() == 0) {
+        fileSystem.MountArchive(ASSET_ARCHIVE);
+    }
     
     if (!InitializeRenderer()) {
         std::cerr << "Failed to initialize renderer system" << std::endl;
@@ -55,16 +102,47 @@ bool Engine::Initialize(int width, int height, const char* title, RendererType t
     return true;
 }
 
+void Engine::ConfigureModelLoader(OBJLoader& loader) {
+    loader.SetWeldMode(OBJLoader::WeldMode::Indices);
+    loader.SetOptimizeMeshes(true);
+    loader.SetLodLevels(MeshSimplifier::DEFAULT_LOD_LEVELS);
+    loader.SetBuildMeshlets(true);
+    loader.SetUseArena(true);
+}
+
 void Engine::Shutdown() {
     if (!m_initialized) {
         return;
     }
+    
+    for (auto& load : m_pendingLoads) {
+        if (load->result.valid()) {
+            load->result.wait();
+        }
+        if (load->bvhBuilt.valid()) {
+            load->bvhBuilt.wait();
+        }
+    }
+    m_pendingLoads.clear();
+    for (auto& pending : m_pendingBVHs) {
+        pending->built.wait();
+    }
+    m_pendingBVHs.clear();
+    StopStreaming();
 
     if (m_rendererSystem) {
         m_rendererSystem->ShutdownRenderer();
     }
 
+    m_fileWatcher.reset();
+    m_modelSources.clear();
     m_loadedModels.clear();
+    m_activeModelBVH.reset();
+    m_activeModel = AssetHandle();
+    m_models->Clear();
+    m_stageBundle.reset();
+    m_stage.reset();
+    m_threadPool.reset();
     m_modelLoader.reset();
     m_rendererSystem.reset();
     
@@ -115,25 +193,15 @@ bool Engine::LoadModel(const std::string& filepath, const std::string& modelName
     }
 
     std::string name = modelName.empty() ? filepath : modelName;
-    
-    for (const auto& pair : m_loadedModels) {
-        if (pair.first == name) {
-            std::cout << "Model '" << name << "' already loaded" << std::endl;
-            return true;
-        }
+    if (IsModelLoaded(name)) {
+        std::cout << "Model '" << name << "' already loaded" << std::endl;
+        return true;
     }
 
     Model model;
     if (m_modelLoader->LoadModel(filepath, model)) {
-        m_loadedModels.emplace_back(name, std::move(model));
-        
-        if (m_loadedModels.size() == 1) {
-            m_activeModelName = name;
-            if (m_rendererSystem) {
-                m_rendererSystem->SetModel(&m_loadedModels.back().second);
-            }
-        }
-        
+        AddModel(name, std::move(model));
+        WatchModelSource(name, filepath);
         std::cout << "SUCCESS: Model '" << name << "' loaded from " << filepath << std::endl;
         return true;
     } else {
@@ -147,28 +215,571 @@ bool Engine::LoadModel(const std::string& filepath, const Model& model) {
     return LoadModel(filepath, filepath);
 }
 
-void Engine::SetActiveModel(const std::string& modelName) {
-    for (const auto& pair : m_loadedModels) {
-        if (pair.first == modelName) {
-            m_activeModelName = modelName;
+AssetHandle Engine::AddModel(const std::string& modelName, Model&& model) {
+    AssetHandle handle = AdoptModel(modelName, std::move(model));
+    if (handle.IsValid() && !GetActiveModel()) {
+        m_activeModel = handle;
+        if (m_rendererSystem) {
+            m_rendererSystem->SetModel(GetActiveModel());
+        }
+        RebuildActiveModelBVH();
+    }
+    return handle;
+}
+
+AssetHandle Engine::AdoptModel(const std::string& modelName, Model&& model) {
+    AssetHandle handle = m_models->Find(modelName);
+    if (handle.IsValid()) {
+        m_models->Replace(handle, std::make_unique<Model>(std::move(model)));
+        m_models->AddRef(handle);
+    } else {
+        handle = m_models->Add(modelName, std::make_unique<Model>(std::move(model)));
+    }
+    if (handle.IsValid()) {
+        m_loadedModels.insert(modelName);
+    }
+    return handle;
+}
+
+bool Engine::LoadStage(const std::string& stageDirectory, const std::string& modelName) {
+    std::string name = modelName.empty() ? stageDirectory : modelName;
+    if (IsModelLoaded(name) || IsStageStreaming(name)) {
+        std::cout << "Stage '" << name << "' already loaded" << std::endl;
+        return true;
+    }
+    
+    auto bundle = std::make_unique<StageBundle>();
+    std::string bundlePath = StageBundle::GetBundlePath(stageDirectory);
+    Model model;
+    if (VirtualFileSystem::GetDefault().Exists(bundlePath) && bundle->Load(bundlePath)) {
+        if (m_modelLoader && bundle->GetLoaderFlags() != m_modelLoader->GetOptionFlags()) {
+            std::cout << "Stage bundle " << bundlePath << " was cooked with different loader settings, loading sources" << std::endl;
+        } else if (m_stageStreaming && StartStreaming(bundle, name)) {
+            std::cout << "SUCCESS: Stage '" << m_stage->GetName() << "' streaming from " << bundlePath << std::endl;
+            return true;
+        } else if (bundle->GetModel(StageBundle::Variant::Small, model)) {
+            StopStreaming();
+            m_stage = std::make_unique<StageDefinition>(bundle->GetDefinition());
+            m_stageBundle = std::move(bundle);
+            AddModel(name, std::move(model));
+            std::cout << "SUCCESS: Stage '" << m_stage->GetName() << "' loaded from " << bundlePath << std::endl;
+            return true;
+        }
+    } else if (!bundle->GetError().empty()) {
+        std::cerr << bundle->GetError() << std::endl;
+    }
+    
+    auto stage = std::make_unique<StageDefinition>();
+    if (!stage->Load(stageDirectory)) {
+        std::cerr << "FAILED: " << stage->GetError() << std::endl;
+        return false;
+    }
+    if (!LoadModel(stage->GetModelPath(StageDefinition::Variant::Small), name)) {
+        return false;
+    }
+    StopStreaming();
+    m_stage = std::move(stage);
+    m_stageBundle.reset();
+    std::cout << "SUCCESS: Stage '" << m_stage->GetName() << "' loaded from " << stageDirectory << " (uncooked)" << std::endl;
+    return true;
+}
+
+bool Engine::StartStreaming(std::unique_ptr<StageBundle>& bundle, const std::string& stageName) {
+    StageBundle::Variant variant = StageBundle::Variant::Big;
+    if (!bundle->HasVariant(variant) || bundle->GetCellCount(variant) == 0) {
+        variant = StageBundle::Variant::Small;
+        if (bundle->GetCellCount(variant) == 0) {
+            return false;
+        }
+    }
+
+    StopStreaming();
+    if (!m_stageStreamer->Open(bundle.get(), variant, m_threadPool.get())) {
+        return false;
+    }
+    m_stage = std::make_unique<StageDefinition>(bundle->GetDefinition());
+    m_stageBundle = std::move(bundle);
+    m_streamingStageName = stageName;
+    return true;
+}
+
+void Engine::StopStreaming() {
+    if (!m_stageStreamer->IsOpen()) {
+        return;
+    }
+
+    if (m_rendererSystem) {
+        std::vector<const Model*> models;
+        m_stageStreamer->GetResidentModels(models);
+        for (const Model* model : models) {
+            m_rendererSystem->ReleaseModel(*model);
+        }
+        m_rendererSystem->SetStreamedModels(std::vector<const Model*>());
+    }
+    m_stageStreamer->Close();
+    m_streamingStageName.clear();
+}
+
+bool Engine::IsStageStreaming(const std::string& stageName) const {
+    return m_stageStreamer && m_stageStreamer->IsOpen() && m_streamingStageName == stageName;
+}
+
+void Engine::UpdateStreaming(const glm::vec3& focus) {
+    if (!m_stageStreamer->IsOpen()) {
+        return;
+    }
+
+    std::vector<glm::vec3> focusPoints(1, focus);
+    if (m_stage) {
+        for (const auto& spawn : m_stage->GetSpawnPoints()) {
+            focusPoints.push_back(spawn.position);
+        }
+    }
+
+    RendererInit* renderer = m_rendererSystem.get();
+    m_stageStreamer->Update(focusPoints, [renderer](const Model& model) {
+        if (renderer) {
+            renderer->ReleaseModel(model);
+        }
+    });
+
+    if (renderer) {
+        std::vector<const Model*> models;
+        m_stageStreamer->GetResidentModels(models);
+        renderer->SetStreamedModels(models);
+    }
+}
+
+void Engine::SetStreamingBudget(size_t bytes) {
+    StageStreamer::Settings settings = m_stageStreamer->GetSettings();
+    settings.memoryBudget = bytes;
+    m_stageStreamer->SetSettings(settings);
+}
+
+void Engine::SetStreamingRadius(float loadRadius, float unloadRadius) {
+    StageStreamer::Settings settings = m_stageStreamer->GetSettings();
+    settings.loadRadius = loadRadius;
+    settings.unloadRadius = std::max(loadRadius, unloadRadius);
+    m_stageStreamer->SetSettings(settings);
+}
+
+bool Engine::LoadModels(const std::vector<std::pair<std::string, std::string>>& requests) {
+    if (!m_modelLoader || !m_threadPool) {
+        std::cerr << "Model loader not initialized" << std::endl;
+        return false;
+    }
+    
+    std::vector<std::string> filepaths;
+    std::vector<std::string> names;
+    for (const auto& request : requests) {
+        std::string name = request.second.empty() ? request.first : request.second;
+        
+        if (IsModelLoaded(name) || std::find(names.begin(), names.end(), name) != names.end()) {
+            std::cout << "Model '" << name << "' already loaded" << std::endl;
+            continue;
+        }
+        
+        filepaths.push_back(request.first);
+        names.push_back(name);
+    }
+    
+    std::vector<OBJLoader::LoadResult> results = m_modelLoader->LoadModelsParallel(filepaths, *m_threadPool);
+    
+    bool allLoaded = true;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].success) {
+            AddModel(names[i], std::move(results[i].model));
+            WatchModelSource(names[i], filepaths[i]);
+            std::cout << "SUCCESS: Model '" << names[i] << "' loaded from " << filepaths[i] << std::endl;
+        } else {
+            std::cerr << "FAILED: Could not load model from " << filepaths[i] << std::endl;
+            std::cerr << "Error: " << results[i].error << std::endl;
+            allLoaded = false;
+        }
+    }
+    
+    return allLoaded;
+}
+
+bool Engine::LoadModelAsync(const std::string& filepath, const std::string& modelName, bool activateWhenReady) {
+    if (!m_modelLoader || !m_threadPool) {
+        std::cerr << "Model loader not initialized" << std::endl;
+        return false;
+    }
+    
+    std::string name = modelName.empty() ? filepath : modelName;
+    if (IsModelLoaded(name)) {
+        std::cout << "Model '" << name << "' already loaded" << std::endl;
+        if (activateWhenReady) {
+            SetActiveModel(name);
+        }
+        return true;
+    }
+    
+    for (auto& load : m_pendingLoads) {
+        if (load->name == name) {
+            load->activate = load->activate || activateWhenReady;
+            return true;
+        }
+    }
+    
+    QueueLoad(filepath, name, activateWhenReady, false);
+    std::cout << "Queued async load of '" << name << "' from " << filepath << std::endl;
+    return true;
+}
+
+bool Engine::ReloadModel(const std::string& modelName) {
+    auto source = m_modelSources.find(modelName);
+    if (!m_modelLoader || !m_threadPool || source == m_modelSources.end() || !m_models->Find(modelName).IsValid()) {
+        std::cerr << "Cannot reload model '" << modelName << "'" << std::endl;
+        return false;
+    }
+    
+    std::string realPath;
+    if (VirtualFileSystem::GetDefault().ResolveLoosePath(source->second.filepath, realPath)) {
+        MeshCache::Invalidate(realPath);
+    }
+    QueueLoad(source->second.filepath, modelName, m_models->Find(modelName) == m_activeModel, true);
+    return true;
+}
+
+void Engine::QueueLoad(const std::string& filepath, const std::string& modelName, bool activate, bool reload) {
+    std::unique_ptr<PendingLoad> load = std::make_unique<PendingLoad>();
+    load->name = modelName;
+    load->filepath = filepath;
+    load->activate = activate;
+    load->reload = reload;
+    load->started = std::chrono::steady_clock::now();
+    load->result = m_modelLoader->LoadModelAsync(filepath, *m_threadPool);
+    m_pendingLoads.push_back(std::move(load));
+}
+
+void Engine::UpdateAsyncLoads() {
+    for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end();) {
+        PendingLoad& load = **it;
+        
+        if (!load.loaded) {
+            if (load.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            
+            OBJLoader::LoadResult result = load.result.get();
+            if (!result.success) {
+                std::cerr << "FAILED: Could not load model from " << load.filepath << std::endl;
+                std::cerr << "Error: " << result.error << std::endl;
+                if (load.reload) {
+                    std::cerr << "Keeping previous version of '" << load.name << "'" << std::endl;
+                }
+                it = m_pendingLoads.erase(it);
+                continue;
+            }
+            
+            load.model = std::move(result.model);
+            load.loaded = true;
+            load.activate = load.activate || !GetActiveModel();
             if (m_rendererSystem) {
-                m_rendererSystem->SetModel(&pair.second);
+                m_rendererSystem->QueueModelUpload(load.model);
             }
-            std::cout << "Active model set to: " << modelName << std::endl;
-            return;
         }
+        
+        if (load.activate && !load.bvh) {
+            load.bvh = std::make_unique<ModelBVH>();
+            ModelBVH* bvh = load.bvh.get();
+            const Model* model = &load.model;
+            ThreadPool* pool = m_threadPool.get();
+            load.bvhBuilt = m_threadPool->Submit([bvh, model, pool]() {
+                return bvh->Build(*model, pool);
+            });
+        }
+        
+        if (load.activate) {
+            if (load.bvhBuilt.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            if (m_rendererSystem && !m_rendererSystem->IsModelResident(load.model)) {
+                ++it;
+                continue;
+            }
+            load.bvhBuilt.get();
+        }
+        
+        AssetHandle handle = m_models->Find(load.name);
+        if (load.reload && handle.IsValid()) {
+            m_models->Replace(handle, std::make_unique<Model>(std::move(load.model)));
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - load.started);
+            std::cout << "Reloaded model '" << load.name << "' in " << elapsed.count() << "ms" << std::endl;
+        } else if (load.reload) {
+            std::cout << "Discarding reload of '" << load.name << "', it is no longer loaded" << std::endl;
+            if (m_rendererSystem) {
+                m_rendererSystem->ReleaseModel(load.model);
+            }
+            it = m_pendingLoads.erase(it);
+            continue;
+        } else {
+            handle = AdoptModel(load.name, std::move(load.model));
+            WatchModelSource(load.name, load.filepath);
+            std::cout << "SUCCESS: Model '" << load.name << "' loaded from " << load.filepath << std::endl;
+        }
+        
+        if (load.activate) {
+            m_activeModel = handle;
+            m_activeModelBVH = std::move(load.bvh);
+            if (!load.reload) {
+                std::cout << "Active model set to: " << load.name << std::endl;
+            }
+        }
+        if (m_rendererSystem) {
+            m_rendererSystem->SetModel(GetActiveModel());
+        }
+        
+        it = m_pendingLoads.erase(it);
+    }
+    
+    UpdateBVHBuilds();
+    CollectRetiredModels();
+}
+
+void Engine::SetHotReload(bool enabled) {
+    if (!enabled) {
+        m_fileWatcher.reset();
+        return;
+    }
+    if (m_fileWatcher) {
+        return;
+    }
+    
+    m_fileWatcher = std::make_unique<FileWatcher>();
+    std::vector<std::pair<std::string, std::string>> sources;
+    for (const auto& source : m_modelSources) {
+        sources.emplace_back(source.first, source.second.filepath);
+    }
+    for (const auto& source : sources) {
+        WatchModelSource(source.first, source.second);
+    }
+    WatchShaderFiles();
+}
+
+void Engine::UpdateHotReload() {
+    if (!m_fileWatcher) {
+        return;
+    }
+    
+    std::vector<std::string> changedPaths;
+    if (m_fileWatcher->Poll(changedPaths) == 0) {
+        return;
+    }
+    
+    for (const auto& path : changedPaths) {
+        bool handled = false;
+        for (const auto& source : m_modelSources) {
+            if (source.second.filepath == path || source.second.materialPath == path) {
+                std::cout << "Detected change to " << path << ", reloading '" << source.first << "'" << std::endl;
+                ReloadModel(source.first);
+                handled = true;
+            }
+        }
+        if (m_rendererSystem && m_rendererSystem->ReloadShaderFile(path)) {
+            handled = true;
+        }
+        if (!handled) {
+            std::cout << "Ignoring change to " << path << std::endl;
+        }
+    }
+}
+
+void Engine::WatchModelSource(const std::string& modelName, const std::string& filepath) {
+    ForgetModelSource(modelName);
+    ModelSource& source = m_modelSources[modelName];
+    source.filepath = filepath;
+    source.materialPath.clear();
+    
+    if (!m_fileWatcher) {
+        return;
+    }
+    
+    size_t extension = filepath.find_last_of('.');
+    std::string materialPath = (extension == std::string::npos ? filepath : filepath.substr(0, extension)) + ".mtl";
+    m_fileWatcher->WatchFile(filepath);
+    if (m_fileWatcher->WatchFile(materialPath)) {
+        source.materialPath = materialPath;
+    }
+}
+
+void Engine::WatchShaderFiles() {
+    if (!m_fileWatcher || !m_rendererSystem) {
+        return;
+    }
+    
+    std::vector<std::string> files;
+    m_rendererSystem->GetShaderFiles(files);
+    for (const auto& file : files) {
+        m_fileWatcher->WatchFile(file);
+    }
+}
+
+void Engine::ForgetModelSource(const std::string& modelName) {
+    auto source = m_modelSources.find(modelName);
+    if (source == m_modelSources.end()) {
+        return;
     }
     
-    std::cerr << "Model '" << modelName << "' not found" << std::endl;
+    if (m_fileWatcher) {
+        m_fileWatcher->UnwatchFile(source->second.filepath);
+        if (!source->second.materialPath.empty()) {
+            m_fileWatcher->UnwatchFile(source->second.materialPath);
+        }
+    }
+    m_modelSources.erase(source);
+}
+
+bool Engine::IsModelLoaded(const std::string& modelName) const {
+    return m_loadedModels.count(modelName) != 0 && FindModel(modelName) != nullptr;
+}
+
+bool Engine::UnloadModel(const std::string& modelName) {
+    AssetHandle handle = m_models->Find(modelName);
+    if (!handle.IsValid() || !IsModelLoaded(modelName)) {
+        std::cerr << "Model '" << modelName << "' not found" << std::endl;
+        return false;
+    }
+    
+    m_loadedModels.erase(modelName);
+    if (handle == m_activeModel) {
+        m_activeModel = AssetHandle();
+        m_activeModelBVH.reset();
+        if (m_rendererSystem) {
+            m_rendererSystem->SetModel(nullptr);
+        }
+    }
+    
+    if (!ReleaseModelReference(handle)) {
+        std::cout << "Released model '" << modelName << "', " << m_models->GetRefCount(handle) << " references keep it alive" << std::endl;
+    }
+    return true;
+}
+
+bool Engine::ReleaseModelReference(AssetHandle handle) {
+    std::string modelName = m_models->GetName(handle);
+    if (!m_models->Release(handle) || m_models->IsValid(handle)) {
+        return false;
+    }
+    
+    ForgetModelSource(modelName);
+    std::cout << "Unloaded model '" << modelName << "'" << std::endl;
+    return true;
+}
+
+AssetHandle Engine::FindModelHandle(const std::string& modelName) const {
+    return m_models->Find(modelName);
+}
+
+AssetHandle Engine::AcquireModel(const std::string& modelName) {
+    AssetHandle handle = m_models->Find(modelName);
+    m_models->AddRef(handle);
+    return handle;
+}
+
+void Engine::ReleaseModel(AssetHandle handle) {
+    ReleaseModelReference(handle);
+}
+
+const Model* Engine::GetModel(AssetHandle handle) const {
+    return m_models->Get(handle);
+}
+
+size_t Engine::GetLoadedModelCount() const {
+    return m_models->GetCount();
+}
+
+const Model* Engine::FindModel(const std::string& modelName) const {
+    return m_models->Get(m_models->Find(modelName));
+}
+
+void Engine::CollectRetiredModels() {
+    if (!m_pendingBVHs.empty()) {
+        return;
+    }
+    
+    RendererInit* renderer = m_rendererSystem.get();
+    m_models->Collect([renderer](Model& model) {
+        if (renderer) {
+            renderer->ReleaseModel(model);
+        }
+    });
+}
+
+void Engine::SetActiveModel(const std::string& modelName) {
+    AssetHandle handle = m_models->Find(modelName);
+    if (!handle.IsValid()) {
+        std::cerr << "Model '" << modelName << "' not found" << std::endl;
+        return;
+    }
+    
+    m_activeModel = handle;
+    if (m_rendererSystem) {
+        m_rendererSystem->SetModel(GetActiveModel());
+    }
+    RebuildActiveModelBVH();
+    std::cout << "Active model set to: " << modelName << std::endl;
 }
 
 const Model* Engine::GetActiveModel() const {
-    for (const auto& pair : m_loadedModels) {
-        if (pair.first == m_activeModelName) {
-            return &pair.second;
+    return m_models->Get(m_activeModel);
+}
+
+const ModelBVH* Engine::GetActiveModelBVH() const {
+    return m_activeModelBVH && !m_activeModelBVH->IsEmpty() ? m_activeModelBVH.get() : nullptr;
+}
+
+void Engine::RebuildActiveModelBVH() {
+    m_activeModelBVH.reset();
+    const Model* model = GetActiveModel();
+    if (!model || !m_threadPool) {
+        return;
+    }
+    
+    for (const auto& pending : m_pendingBVHs) {
+        if (pending->model == model) {
+            return;
         }
     }
-    return nullptr;
+    
+    std::unique_ptr<PendingBVH> pending = std::make_unique<PendingBVH>();
+    pending->name = m_models->GetName(m_activeModel);
+    pending->model = model;
+    pending->started = std::chrono::steady_clock::now();
+    pending->bvh = std::make_unique<ModelBVH>();
+    ModelBVH* bvh = pending->bvh.get();
+    ThreadPool* pool = m_threadPool.get();
+    pending->built = m_threadPool->Submit([bvh, model, pool]() {
+        return bvh->Build(*model, pool);
+    });
+    m_pendingBVHs.push_back(std::move(pending));
+}
+
+void Engine::UpdateBVHBuilds() {
+    for (auto it = m_pendingBVHs.begin(); it != m_pendingBVHs.end();) {
+        PendingBVH& pending = **it;
+        if (pending.built.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        
+        bool built = pending.built.get();
+        if (pending.model == GetActiveModel()) {
+            if (!built) {
+                std::cout << "No triangles to build BVH for '" << pending.name << "'" << std::endl;
+            } else {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pending.started);
+                std::cout << "Built BVH for '" << pending.name << "': " << pending.bvh->GetTriangleCount() << " triangles, "
+                          << pending.bvh->GetNodeCount() << " nodes in " << elapsed.count() << "ms" << std::endl;
+                m_activeModelBVH = std::move(pending.bvh);
+            }
+        }
+        it = m_pendingBVHs.erase(it);
+    }
 }
 
 bool Engine::LoadBackgroundShader(const std::string& shaderName) {
@@ -179,6 +790,7 @@ bool Engine::LoadBackgroundShader(const std::string& shaderName) {
     
     bool success = m_rendererSystem->LoadBackgroundShader(shaderName);
     if (success) {
+        WatchShaderFiles();
         std::cout << "Background shader '" << shaderName << "' loaded successfully" << std::endl;
     } else {
         std::cout << "Failed to load background shader '" << shaderName << "', using fallback" << std::endl;
@@ -225,6 +837,12 @@ void Engine::SetVSync(bool enabled) {
     }
 }
 
+void Engine::SetGpuMemoryBudget(size_t bytes) {
+    if (m_rendererSystem) {
+        m_rendererSystem->SetGpuMemoryBudget(bytes);
+    }
+}
+
 void Engine::SetFPSLimit(int fps) {
     if (fps > 0) {
         m_targetFrameTime = 1.0f / static_cast<float>(fps);
@@ -248,8 +866,21 @@ void Engine::PrintSystemInfo() const {
     std::cout << "Window: " << m_width << "x" << m_height << std::endl;
     std::cout << "Title: " << m_title << std::endl;
     std::cout << "Renderer: " << (int)m_currentRenderer << std::endl;
-    std::cout << "Models loaded: " << m_loadedModels.size() << std::endl;
-    std::cout << "Active model: " << (m_activeModelName.empty() ? "None" : m_activeModelName) << std::endl;
+    std::cout << "Models loaded: " << m_models->GetCount() << std::endl;
+    if (m_stageStreamer && m_stageStreamer->IsOpen()) {
+        std::cout << "Streaming stage: " << m_streamingStageName << std::endl;
+    }
+    std::cout << "Active model: " << (GetActiveModel() ? m_models->GetName(m_activeModel) : "None") << std::endl;
+    if (m_rendererSystem) {
+        GpuResidency::Stats gpuMemory = m_rendererSystem->GetGpuMemoryStats();
+        std::cout << "GPU memory: " << gpuMemory.usedBytes / (1024 * 1024) << " / " << gpuMemory.budget / (1024 * 1024)
+                  << " MB (peak " << gpuMemory.peakBytes / (1024 * 1024) << " MB, " << gpuMemory.evictions << " evictions)" << std::endl;
+        GLStateCache::Stats glState = m_rendererSystem->GetStateCacheStats();
+        std::cout << "GL state calls: " << glState.issued << " issued, " << glState.skipped << " skipped (last frame)" << std::endl;
+        ModelRenderer::CullingStats culling = m_rendererSystem->GetCullingStats();
+        std::cout << "Frustum culling: " << culling.objectsVisible << " visible, " << culling.objectsCulled << " culled of "
+                  << culling.objectsTested << " (" << culling.cullJobs << " jobs, last frame)" << std::endl;
+    }
     std::cout << "FPS: " << m_fps << std::endl;
     std::cout << "Delta time: " << m_deltaTime << std::endl;
     std::cout << "FPS Limit: " << (m_targetFrameTime > 0.0f ? std::to_string(static_cast<int>(1.0f / m_targetFrameTime)) : "None") << std::endl;
@@ -277,6 +908,7 @@ bool Engine::InitializeRenderer() {
     if (auto* renderer = m_rendererSystem->GetRenderer()) {
         if (auto* oglRenderer = dynamic_cast<OGLRenderer*>(renderer)) {
             oglRenderer->SetEngine(this);
+            oglRenderer->SetThreadPool(m_threadPool.get());
         }
     }
     
@@ -308,8 +940,7 @@ void Engine::UpdatePerformanceMetrics() {
 }
 
 void Engine::LoadDefaultAssets() {
-    std::string defaultMapPath = "assets/maps/default/map.obj";
-    if (LoadModel(defaultMapPath, "default_map")) {
+    if (LoadStage(DEFAULT_STAGE, "default_map")) {
         std::cout << "Default map loaded successfully" << std::endl;
     } else {
         std::cout << "Default map not found, continuing without it" << std::endl;
@@ -3,11 +3,20 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <glm/glm.hpp>
+#include "backend/AssetRegistry.h"
 
 class RendererInit;
 class OBJLoader;
-class Model;
+class ThreadPool;
+class ModelBVH;
+class FileWatcher;
+class StageDefinition;
+class StageBundle;
+class StageStreamer;
+struct Model;
 
 class Engine {
 public:
@@ -16,6 +25,11 @@ public:
         Auto
     };
 
+    static const std::string ASSET_ARCHIVE;
+    static const std::string DEFAULT_STAGE;
+    
+    static void ConfigureModelLoader(OBJLoader& loader);
+
     Engine();
     ~Engine();
 
@@ -29,8 +43,32 @@ public:
     
     bool LoadModel(const std::string& filepath, const std::string& modelName = "");
     bool LoadModel(const std::string& filepath, const Model& model);
+    bool LoadModels(const std::vector<std::pair<std::string, std::string>>& requests);
+    bool LoadModelAsync(const std::string& filepath, const std::string& modelName = "", bool activateWhenReady = false);
+    void UpdateAsyncLoads();
+    bool IsModelLoaded(const std::string& modelName) const;
+    bool UnloadModel(const std::string& modelName);
+    AssetHandle FindModelHandle(const std::string& modelName) const;
+    AssetHandle AcquireModel(const std::string& modelName);
+    void ReleaseModel(AssetHandle handle);
+    const Model* GetModel(AssetHandle handle) const;
+    size_t GetLoadedModelCount() const;
+    size_t GetPendingLoadCount() const { return m_pendingLoads.size(); }
+    bool ReloadModel(const std::string& modelName);
+    bool LoadStage(const std::string& stageDirectory, const std::string& modelName = "");
+    const StageDefinition* GetStage() const { return m_stage.get(); }
+    const StageBundle* GetStageBundle() const { return m_stageBundle.get(); }
+    const StageStreamer* GetStageStreamer() const { return m_stageStreamer.get(); }
+    bool IsStageStreaming(const std::string& stageName) const;
+    void SetStageStreaming(bool enabled) { m_stageStreaming = enabled; }
+    void SetStreamingBudget(size_t bytes);
+    void SetStreamingRadius(float loadRadius, float unloadRadius);
+    void UpdateStreaming(const glm::vec3& focus);
+    void SetHotReload(bool enabled);
+    void UpdateHotReload();
     void SetActiveModel(const std::string& modelName);
     const Model* GetActiveModel() const;
+    const ModelBVH* GetActiveModelBVH() const;
     
     bool LoadBackgroundShader(const std::string& shaderName);
     void SetBackgroundColor(const glm::vec4& color);
@@ -41,6 +79,7 @@ public:
     void SetWindowTitle(const std::string& title);
     void SetVSync(bool enabled);
     void SetFPSLimit(int fps);
+    void SetGpuMemoryBudget(size_t bytes);
     
     float GetDeltaTime() const;
     float GetFPS() const;
@@ -48,8 +87,18 @@ public:
     void UpdatePerformanceMetrics();
 
 private:
+    struct PendingLoad;
+    struct PendingBVH;
+    
+    struct ModelSource {
+        std::string filepath;
+        std::string materialPath;
+    };
+    
     std::unique_ptr<RendererInit> m_rendererSystem;
     std::unique_ptr<OBJLoader> m_modelLoader;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    std::unique_ptr<FileWatcher> m_fileWatcher;
     
     bool m_initialized;
     bool m_running;
@@ -64,9 +113,32 @@ private:
     float m_lastFrameTime;
     float m_targetFrameTime;
     
-    std::string m_activeModelName;
-    std::vector<std::pair<std::string, Model>> m_loadedModels;
+    std::unique_ptr<AssetRegistry<Model>> m_models;
+    AssetHandle m_activeModel;
+    std::unique_ptr<ModelBVH> m_activeModelBVH;
+    std::vector<std::unique_ptr<PendingLoad>> m_pendingLoads;
+    std::vector<std::unique_ptr<PendingBVH>> m_pendingBVHs;
+    std::unordered_set<std::string> m_loadedModels;
+    std::unordered_map<std::string, ModelSource> m_modelSources;
+    std::unique_ptr<StageDefinition> m_stage;
+    std::unique_ptr<StageBundle> m_stageBundle;
+    std::unique_ptr<StageStreamer> m_stageStreamer;
+    bool m_stageStreaming;
+    std::string m_streamingStageName;
     
     bool InitializeRenderer();
+    void RebuildActiveModelBVH();
+    void UpdateBVHBuilds();
+    bool StartStreaming(std::unique_ptr<StageBundle>& bundle, const std::string& stageName);
+    void StopStreaming();
+    AssetHandle AddModel(const std::string& modelName, Model&& model);
+    AssetHandle AdoptModel(const std::string& modelName, Model&& model);
+    bool ReleaseModelReference(AssetHandle handle);
+    const Model* FindModel(const std::string& modelName) const;
+    void CollectRetiredModels();
+    void QueueLoad(const std::string& filepath, const std::string& modelName, bool activate, bool reload);
+    void WatchModelSource(const std::string& modelName, const std::string& filepath);
+    void ForgetModelSource(const std::string& modelName);
+    void WatchShaderFiles();
     void LoadDefaultAssets();
 };
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct AssetHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    AssetHandle() : index(0), generation(0) {}
+    AssetHandle(uint32_t slotIndex, uint32_t slotGeneration) : index(slotIndex), generation(slotGeneration) {}
+
+    bool IsValid() const { return generation != 0; }
+    bool operator==(const AssetHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const AssetHandle& other) const { return !(*this == other); }
+};
+
+template<typename T>
+class AssetRegistry {
+public:
+    static const uint64_t DEFAULT_RETIRE_FRAMES = 2;
+
+    typedef std::function<void(T&)> DestroyCallback;
+
+    AssetRegistry() : m_frame(0), m_retireFrames(DEFAULT_RETIRE_FRAMES), m_count(0) {}
+
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+    AssetHandle Add(const std::string& name, std::unique_ptr<T> asset) {
+        if (!asset || m_names.count(name)) {
+            return AssetHandle();
+        }
+
+        uint32_t index;
+        if (!m_freeSlots.empty()) {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.asset = std::move(asset);
+        slot.name = name;
+        slot.refCount = 1;
+        AssetHandle handle(index, slot.generation);
+        m_names[name] = handle;
+        ++m_count;
+        return handle;
+    }
+
+    AssetHandle Find(const std::string& name) const {
+        auto it = m_names.find(name);
+        return it != m_names.end() ? it->second : AssetHandle();
+    }
+
+    bool IsValid(AssetHandle handle) const {
+        return handle.IsValid() && handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation
+            && m_slots[handle.index].asset;
+    }
+
+    T* Get(AssetHandle handle) { return IsValid(handle) ? m_slots[handle.index].asset.get() : nullptr; }
+    const T* Get(AssetHandle handle) const { return IsValid(handle) ? m_slots[handle.index].asset.get() : nullptr; }
+
+    const std::string& GetName(AssetHandle handle) const {
+        static const std::string empty;
+        return IsValid(handle) ? m_slots[handle.index].name : empty;
+    }
+
+    uint32_t GetRefCount(AssetHandle handle) const { return IsValid(handle) ? m_slots[handle.index].refCount : 0; }
+
+    bool AddRef(AssetHandle handle) {
+        if (!IsValid(handle)) {
+            return false;
+        }
+        ++m_slots[handle.index].refCount;
+        return true;
+    }
+
+    bool Release(AssetHandle handle) {
+        if (!IsValid(handle)) {
+            return false;
+        }
+        Slot& slot = m_slots[handle.index];
+        if (--slot.refCount == 0) {
+            Retire(handle.index);
+        }
+        return true;
+    }
+
+    bool Replace(AssetHandle handle, std::unique_ptr<T> asset) {
+        if (!IsValid(handle) || !asset) {
+            return false;
+        }
+        Slot& slot = m_slots[handle.index];
+        m_retired.push_back(RetiredAsset(std::move(slot.asset), m_frame, 0xFFFFFFFFu));
+        slot.asset = std::move(asset);
+        return true;
+    }
+
+    size_t Collect(const DestroyCallback& onDestroy = DestroyCallback()) {
+        ++m_frame;
+        size_t destroyed = 0;
+        for (size_t i = 0; i < m_retired.size();) {
+            RetiredAsset& retired = m_retired[i];
+            if (m_frame - retired.frame < m_retireFrames) {
+                ++i;
+                continue;
+            }
+            if (onDestroy) {
+                onDestroy(*retired.asset);
+            }
+            if (retired.slot != 0xFFFFFFFFu) {
+                m_freeSlots.push_back(retired.slot);
+            }
+            m_retired[i] = std::move(m_retired.back());
+            m_retired.pop_back();
+            ++destroyed;
+        }
+        return destroyed;
+    }
+
+    void Clear(const DestroyCallback& onDestroy = DestroyCallback()) {
+        for (auto& slot : m_slots) {
+            if (slot.asset && onDestroy) {
+                onDestroy(*slot.asset);
+            }
+        }
+        for (auto& retired : m_retired) {
+            if (onDestroy) {
+                onDestroy(*retired.asset);
+            }
+        }
+        m_slots.clear();
+        m_freeSlots.clear();
+        m_retired.clear();
+        m_names.clear();
+        m_count = 0;
+    }
+
+    template<typename F>
+    void ForEach(F&& visit) const {
+        for (uint32_t i = 0; i < m_slots.size(); ++i) {
+            const Slot& slot = m_slots[i];
+            if (slot.asset) {
+                visit(AssetHandle(i, slot.generation), slot.name, *slot.asset);
+            }
+        }
+    }
+
+    void SetRetireFrames(uint64_t frames) { m_retireFrames = frames; }
+    size_t GetCount() const { return m_count; }
+    size_t GetRetiredCount() const { return m_retired.size(); }
+
+private:
+    struct Slot {
+        std::unique_ptr<T> asset;
+        std::string name;
+        uint32_t generation;
+        uint32_t refCount;
+
+        Slot() : generation(1), refCount(0) {}
+    };
+
+    struct RetiredAsset {
+        std::unique_ptr<T> asset;
+        uint64_t frame;
+        uint32_t slot;
+
+        RetiredAsset(std::unique_ptr<T> retiredAsset, uint64_t retiredFrame, uint32_t retiredSlot)
+            : asset(std::move(retiredAsset)), frame(retiredFrame), slot(retiredSlot) {}
+    };
+
+    void Retire(uint32_t index) {
+        Slot& slot = m_slots[index];
+        m_names.erase(slot.name);
+        slot.name.clear();
+        slot.generation = slot.generation == 0xFFFFFFFFu ? 1 : slot.generation + 1;
+        m_retired.push_back(RetiredAsset(std::move(slot.asset), m_frame, index));
+        --m_count;
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<RetiredAsset> m_retired;
+    std::unordered_map<std::string, AssetHandle> m_names;
+    uint64_t m_frame;
+    uint64_t m_retireFrames;
+    size_t m_count;
+};
@@ -0,0 +1,351 @@
+#include "AsyncFileReader.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PF_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#endif
+#endif
+
+#ifdef PF_IO_URING
+
+struct AsyncFileReader::Ring {
+    int fd;
+    unsigned int entries;
+    void* sqMemory;
+    size_t sqMemorySize;
+    void* cqMemory;
+    size_t cqMemorySize;
+    io_uring_sqe* sqes;
+    size_t sqesSize;
+    unsigned int* sqHead;
+    unsigned int* sqTail;
+    unsigned int* sqMask;
+    unsigned int* sqArray;
+    unsigned int* cqHead;
+    unsigned int* cqTail;
+    unsigned int* cqMask;
+    io_uring_cqe* cqes;
+};
+
+namespace {
+
+struct Operation {
+    int fd;
+    size_t request;
+    size_t done;
+    struct iovec vector;
+};
+
+int RingEnter(int fd, unsigned int toSubmit, unsigned int minComplete) {
+    for (;;) {
+        long result = syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (result >= 0 || errno != EINTR) {
+            return static_cast<int>(result);
+        }
+    }
+}
+
+}
+
+#else
+
+struct AsyncFileReader::Ring {
+};
+
+#endif
+
+AsyncFileReader::AsyncFileReader(unsigned int queueDepth)
+    : m_usingRing(false) {
+    if (!SetupRing(queueDepth)) {
+        std::cout << "AsyncFileReader: io_uring unavailable, using thread pool reads" << std::endl;
+    }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+    DestroyRing();
+}
+
+size_t AsyncFileReader::ReadBatch(std::vector<Request>& requests, ThreadPool* pool) {
+    if (requests.empty()) {
+        return 0;
+    }
+    if (m_usingRing) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_ring) {
+            return ReadWithRing(requests);
+        }
+    }
+    return ReadWithPool(requests, pool);
+}
+
+bool AsyncFileReader::ReadBlocking(Request& request) {
+    std::ifstream stream(request.path, std::ios::binary);
+    if (!stream) {
+        request.success = false;
+        return false;
+    }
+    request.data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    request.success = !stream.bad();
+    return request.success;
+}
+
+size_t AsyncFileReader::ReadWithPool(std::vector<Request>& requests, ThreadPool* pool) {
+    if (pool && requests.size() > 1) {
+        pool->ParallelFor(requests.size(), [&requests](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                ReadBlocking(requests[i]);
+            }
+        });
+    } else {
+        for (auto& request : requests) {
+            ReadBlocking(request);
+        }
+    }
+
+    size_t succeeded = 0;
+    for (const auto& request : requests) {
+        succeeded += request.success ? 1 : 0;
+    }
+    return succeeded;
+}
+
+bool AsyncFileReader::SetupRing(unsigned int entries) {
+#ifdef PF_IO_URING
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        return false;
+    }
+
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->fd = fd;
+    ring->entries = params.sq_entries;
+    ring->sqMemorySize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cqMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping) {
+        ring->sqMemorySize = ring->cqMemorySize = std::max(ring->sqMemorySize, ring->cqMemorySize);
+    }
+
+    ring->sqMemory = mmap(nullptr, ring->sqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sqMemory == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    ring->cqMemory = ring->sqMemory;
+    if (!singleMapping) {
+        ring->cqMemory = mmap(nullptr, ring->cqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->cqMemory == MAP_FAILED) {
+            munmap(ring->sqMemory, ring->sqMemorySize);
+            close(fd);
+            return false;
+        }
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (!singleMapping) {
+            munmap(ring->cqMemory, ring->cqMemorySize);
+        }
+        munmap(ring->sqMemory, ring->sqMemorySize);
+        close(fd);
+        return false;
+    }
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(ring->sqMemory);
+    char* cq = static_cast<char*>(ring->cqMemory);
+    ring->sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    ring->sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    ring->cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    m_ring = std::move(ring);
+    m_usingRing = true;
+    return true;
+#else
+    (void)entries;
+    return false;
+#endif
+}
+
+void AsyncFileReader::DestroyRing() {
+#ifdef PF_IO_URING
+    if (!m_ring) {
+        return;
+    }
+    munmap(m_ring->sqes, m_ring->sqesSize);
+    if (m_ring->cqMemory != m_ring->sqMemory) {
+        munmap(m_ring->cqMemory, m_ring->cqMemorySize);
+    }
+    munmap(m_ring->sqMemory, m_ring->sqMemorySize);
+    close(m_ring->fd);
+#endif
+    m_ring.reset();
+    m_usingRing = false;
+}
+
+size_t AsyncFileReader::ReadWithRing(std::vector<Request>& requests) {
+#ifdef PF_IO_URING
+    Ring& ring = *m_ring;
+    std::vector<Operation> operations;
+    operations.reserve(requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        Request& request = requests[i];
+        request.success = false;
+        request.data.clear();
+
+        int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            close(fd);
+            continue;
+        }
+        request.data.resize(static_cast<size_t>(st.st_size));
+        if (request.data.empty()) {
+            request.success = true;
+            close(fd);
+            continue;
+        }
+
+        Operation operation;
+        operation.fd = fd;
+        operation.request = i;
+        operation.done = 0;
+        operations.push_back(operation);
+    }
+
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        ready.push_back(i);
+    }
+
+    auto finish = [&](Operation& operation, bool success) {
+        Request& request = requests[operation.request];
+        request.success = success;
+        if (success) {
+            request.data.resize(operation.done);
+        } else {
+            request.data.clear();
+        }
+        close(operation.fd);
+        operation.fd = -1;
+    };
+
+    unsigned int inFlight = 0;
+    unsigned int unsubmitted = 0;
+
+    auto reap = [&]() {
+        unsigned int head = *ring.cqHead;
+        unsigned int completed = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != completed; ++head) {
+            const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+            size_t index = static_cast<size_t>(cqe.user_data);
+            Operation& operation = operations[index];
+            --inFlight;
+
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                ready.push_back(index);
+            } else if (cqe.res < 0) {
+                finish(operation, false);
+            } else if (cqe.res == 0) {
+                finish(operation, true);
+            } else {
+                operation.done += static_cast<size_t>(cqe.res);
+                if (operation.done < requests[operation.request].data.size()) {
+                    ready.push_back(index);
+                } else {
+                    finish(operation, true);
+                }
+            }
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    };
+
+    bool failed = false;
+    while (!ready.empty() || inFlight > 0) {
+        unsigned int tail = *ring.sqTail;
+        while (!ready.empty() && inFlight + unsubmitted < ring.entries) {
+            size_t index = ready.front();
+            ready.pop_front();
+            Operation& operation = operations[index];
+            Request& request = requests[operation.request];
+            size_t remaining = request.data.size() - operation.done;
+            operation.vector.iov_base = request.data.data() + operation.done;
+            operation.vector.iov_len = std::min(remaining, MAX_READ_SIZE);
+
+            unsigned int slot = tail & *ring.sqMask;
+            io_uring_sqe& sqe = ring.sqes[slot];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = operation.fd;
+            sqe.off = operation.done;
+            sqe.addr = reinterpret_cast<unsigned long long>(&operation.vector);
+            sqe.len = 1;
+            sqe.user_data = index;
+            ring.sqArray[slot] = slot;
+            ++tail;
+            ++unsubmitted;
+        }
+        __atomic_store_n(ring.sqTail, tail, __ATOMIC_RELEASE);
+
+        int submitted = RingEnter(ring.fd, unsubmitted, 1);
+        if (submitted < 0) {
+            std::cerr << "AsyncFileReader: io_uring_enter failed (" << std::strerror(errno) << ")" << std::endl;
+            failed = true;
+            break;
+        }
+        unsubmitted -= static_cast<unsigned int>(submitted);
+        inFlight += static_cast<unsigned int>(submitted);
+        reap();
+    }
+
+    if (failed) {
+        while (inFlight > 0 && RingEnter(ring.fd, 0, 1) >= 0) {
+            reap();
+        }
+        DestroyRing();
+    }
+
+    size_t succeeded = 0;
+    for (auto& operation : operations) {
+        if (operation.fd >= 0) {
+            close(operation.fd);
+            operation.fd = -1;
+            ReadBlocking(requests[operation.request]);
+        }
+    }
+    for (const auto& request : requests) {
+        succeeded += request.success ? 1 : 0;
+    }
+    return succeeded;
+#else
+    (void)requests;
+    return 0;
+#endif
+}
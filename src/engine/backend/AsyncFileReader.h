@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+class AsyncFileReader {
+public:
+    static const unsigned int DEFAULT_QUEUE_DEPTH = 64;
+    static const size_t MAX_READ_SIZE = 1u << 30;
+
+    struct Request {
+        std::string path;
+        std::vector<char> data;
+        bool success;
+
+        Request() : success(false) {}
+        explicit Request(const std::string& filePath) : path(filePath), success(false) {}
+    };
+
+    explicit AsyncFileReader(unsigned int queueDepth = DEFAULT_QUEUE_DEPTH);
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    size_t ReadBatch(std::vector<Request>& requests, ThreadPool* pool = nullptr);
+    bool IsUsingIoUring() const { return m_usingRing; }
+
+    static bool ReadBlocking(Request& request);
+
+private:
+    struct Ring;
+
+    bool SetupRing(unsigned int entries);
+    void DestroyRing();
+    size_t ReadWithRing(std::vector<Request>& requests);
+    static size_t ReadWithPool(std::vector<Request>& requests, ThreadPool* pool);
+
+    std::unique_ptr<Ring> m_ring;
+    std::atomic<bool> m_usingRing;
+    std::mutex m_mutex;
+};
@@ -1,6 +1,9 @@
 #include "CommandArgs.h"
 #include <iostream>
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 
 CommandArgs::CommandArgs() {
 }
@@ -68,3 +71,38 @@ bool CommandArgs::IsRendererValid() const {
     }
     return false;
 }
+
+bool CommandArgs::HasArg(const std::string& key) const {
+    return m_args.find(key) != m_args.end();
+}
+
+std::string CommandArgs::GetValue(const std::string& key, const std::string& defaultValue) const {
+    auto it = m_args.find(key);
+    if (it != m_args.end()) {
+        return it->second;
+    }
+    return defaultValue;
+}
+
+bool CommandArgs::GetUnsigned(const std::string& key, size_t defaultValue, size_t maxValue, size_t& value) const {
+    auto it = m_args.find(key);
+    if (it == m_args.end()) {
+        value = defaultValue;
+        return true;
+    }
+    
+    const std::string& text = it->second;
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        std::cerr << "Invalid value for -" << key << ": " << text << " (expected a non-negative integer)" << std::endl;
+        return false;
+    }
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0' || parsed > maxValue) {
+        std::cerr << "Invalid value for -" << key << ": " << text << " (expected an integer up to " << maxValue << ")" << std::endl;
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
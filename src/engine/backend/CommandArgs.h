@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <map>
 
@@ -11,6 +12,9 @@ public:
     bool ParseArgs(int argc, char* argv[]);    
     std::string GetRenderer() const;    
     bool IsRendererValid() const;
+    bool HasArg(const std::string& key) const;
+    std::string GetValue(const std::string& key, const std::string& defaultValue) const;
+    bool GetUnsigned(const std::string& key, size_t defaultValue, size_t maxValue, size_t& value) const;
 
 private:
     std::map<std::string, std::string> m_args;
@@ -0,0 +1,204 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+FileWatcher::FileWatcher()
+    : m_notifyFd(-1)
+    , m_pollInterval(0.5f)
+    , m_lastPoll(std::chrono::steady_clock::now()) {
+#ifdef __linux__
+    m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_notifyFd < 0) {
+        std::cerr << "FileWatcher: inotify unavailable, falling back to polling" << std::endl;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (m_notifyFd >= 0) {
+        close(m_notifyFd);
+        m_notifyFd = -1;
+    }
+#endif
+}
+
+bool FileWatcher::WatchFile(const std::string& path) {
+    std::string directory, name;
+    SplitPath(path, directory, name);
+    std::string key = directory + "/" + name;
+    auto existing = m_files.find(key);
+    if (existing != m_files.end()) {
+        ++existing->second.refCount;
+        return true;
+    }
+
+    WatchedFile file;
+    file.path = path;
+    file.refCount = 1;
+    if (!GetFileStamp(path, file.mtime, file.size)) {
+        return false;
+    }
+
+    if (m_notifyFd >= 0 && !WatchDirectory(directory)) {
+        std::cerr << "FileWatcher: failed to watch " << directory << std::endl;
+        return false;
+    }
+
+    m_files[key] = file;
+    return true;
+}
+
+void FileWatcher::UnwatchFile(const std::string& path) {
+    std::string directory, name;
+    SplitPath(path, directory, name);
+    auto file = m_files.find(directory + "/" + name);
+    if (file == m_files.end() || --file->second.refCount > 0) {
+        return;
+    }
+    m_files.erase(file);
+    UnwatchDirectory(directory);
+}
+
+size_t FileWatcher::Poll(std::vector<std::string>& changedPaths) {
+    size_t before = changedPaths.size();
+    if (m_notifyFd >= 0) {
+        PollNotify(changedPaths);
+    } else {
+        PollStamps(changedPaths);
+    }
+    return changedPaths.size() - before;
+}
+
+bool FileWatcher::GetFileStamp(const std::string& path, int64_t& mtime, uint64_t& size) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+#ifdef __linux__
+    mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+    mtime = static_cast<int64_t>(st.st_mtime);
+#endif
+    size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+void FileWatcher::SplitPath(const std::string& path, std::string& directory, std::string& name) {
+    size_t slash = path.find_last_of("/\\");
+    if (slash == std::string::npos) {
+        directory = ".";
+        name = path;
+        return;
+    }
+    directory = slash == 0 ? "/" : path.substr(0, slash);
+    name = path.substr(slash + 1);
+}
+
+bool FileWatcher::WatchDirectory(const std::string& directory) {
+#ifdef __linux__
+    for (const auto& entry : m_directories) {
+        if (entry.second == directory) {
+            return true;
+        }
+    }
+
+    int descriptor = inotify_add_watch(m_notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0) {
+        return false;
+    }
+    m_directories[descriptor] = directory;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::UnwatchDirectory(const std::string& directory) {
+#ifdef __linux__
+    std::string prefix = directory + "/";
+    for (const auto& file : m_files) {
+        if (file.first.compare(0, prefix.size(), prefix) == 0 && file.first.find('/', prefix.size()) == std::string::npos) {
+            return;
+        }
+    }
+
+    for (auto entry = m_directories.begin(); entry != m_directories.end(); ++entry) {
+        if (entry->second == directory) {
+            inotify_rm_watch(m_notifyFd, entry->first);
+            m_directories.erase(entry);
+            return;
+        }
+    }
+#else
+    (void)directory;
+#endif
+}
+
+void FileWatcher::PollNotify(std::vector<std::string>& changedPaths) {
+#ifdef __linux__
+    size_t first = changedPaths.size();
+    alignas(struct inotify_event) char buffer[4096];
+
+    for (;;) {
+        ssize_t length = read(m_notifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "FileWatcher: inotify read failed" << std::endl;
+            }
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            auto directory = m_directories.find(event->wd);
+            if (directory == m_directories.end() || event->len == 0 || !(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) {
+                continue;
+            }
+
+            auto file = m_files.find(directory->second + "/" + event->name);
+            if (file == m_files.end()) {
+                continue;
+            }
+            GetFileStamp(file->second.path, file->second.mtime, file->second.size);
+            if (std::find(changedPaths.begin() + first, changedPaths.end(), file->second.path) == changedPaths.end()) {
+                changedPaths.push_back(file->second.path);
+            }
+        }
+    }
+#else
+    (void)changedPaths;
+#endif
+}
+
+void FileWatcher::PollStamps(std::vector<std::string>& changedPaths) {
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<float>(now - m_lastPoll).count() < m_pollInterval) {
+        return;
+    }
+    m_lastPoll = now;
+
+    for (auto& entry : m_files) {
+        WatchedFile& file = entry.second;
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        if (!GetFileStamp(file.path, mtime, size)) {
+            continue;
+        }
+        if (mtime != file.mtime || size != file.size) {
+            file.mtime = mtime;
+            file.size = size;
+            changedPaths.push_back(file.path);
+        }
+    }
+}
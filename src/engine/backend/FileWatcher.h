@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool WatchFile(const std::string& path);
+    void UnwatchFile(const std::string& path);
+    size_t Poll(std::vector<std::string>& changedPaths);
+
+    void SetPollInterval(float seconds) { m_pollInterval = seconds; }
+    bool IsUsingNotify() const { return m_notifyFd >= 0; }
+    size_t GetWatchedFileCount() const { return m_files.size(); }
+
+private:
+    struct WatchedFile {
+        std::string path;
+        int64_t mtime;
+        uint64_t size;
+        uint32_t refCount;
+    };
+
+    static bool GetFileStamp(const std::string& path, int64_t& mtime, uint64_t& size);
+    static void SplitPath(const std::string& path, std::string& directory, std::string& name);
+    bool WatchDirectory(const std::string& directory);
+    void UnwatchDirectory(const std::string& directory);
+    void PollNotify(std::vector<std::string>& changedPaths);
+    void PollStamps(std::vector<std::string>& changedPaths);
+
+    int m_notifyFd;
+    float m_pollInterval;
+    std::chrono::steady_clock::time_point m_lastPoll;
+    std::unordered_map<std::string, WatchedFile> m_files;
+    std::unordered_map<int, std::string> m_directories;
+};
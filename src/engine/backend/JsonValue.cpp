@@ -0,0 +1,334 @@
+#include "JsonValue.h"
+#include <cstdlib>
+#include <cstring>
+
+class JsonValue::Parser {
+public:
+    explicit Parser(const std::string& text) : m_text(text.c_str()), m_end(text.c_str() + text.size()), m_cursor(text.c_str()) {}
+
+    bool ParseDocument(JsonValue& value, std::string& error) {
+        SkipWhitespace();
+        if (!ParseValue(value, 0)) {
+            error = FormatError();
+            return false;
+        }
+        SkipWhitespace();
+        if (m_cursor != m_end) {
+            m_error = "unexpected trailing characters";
+            error = FormatError();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool ParseValue(JsonValue& value, size_t depth) {
+        if (depth > MAX_DEPTH) {
+            return Fail("nesting too deep");
+        }
+        if (m_cursor >= m_end) {
+            return Fail("unexpected end of input");
+        }
+
+        switch (*m_cursor) {
+            case '{':
+                return ParseObject(value, depth);
+            case '[':
+                return ParseArray(value, depth);
+            case '"':
+                value.m_type = Type::String;
+                return ParseString(value.m_string);
+            case 't':
+                value.m_type = Type::Bool;
+                value.m_bool = true;
+                return ParseLiteral("true");
+            case 'f':
+                value.m_type = Type::Bool;
+                value.m_bool = false;
+                return ParseLiteral("false");
+            case 'n':
+                value.m_type = Type::Null;
+                return ParseLiteral("null");
+            default:
+                return ParseNumber(value);
+        }
+    }
+
+    bool ParseObject(JsonValue& value, size_t depth) {
+        value.m_type = Type::Object;
+        ++m_cursor;
+        SkipWhitespace();
+        if (Consume('}')) {
+            return true;
+        }
+
+        for (;;) {
+            SkipWhitespace();
+            std::string key;
+            if (m_cursor >= m_end || *m_cursor != '"' || !ParseString(key)) {
+                return Fail("expected object key");
+            }
+            SkipWhitespace();
+            if (!Consume(':')) {
+                return Fail("expected ':'");
+            }
+            SkipWhitespace();
+            value.m_members.emplace_back(std::move(key), JsonValue());
+            if (!ParseValue(value.m_members.back().second, depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Consume('}')) {
+                return true;
+            }
+            if (!Consume(',')) {
+                return Fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool ParseArray(JsonValue& value, size_t depth) {
+        value.m_type = Type::Array;
+        ++m_cursor;
+        SkipWhitespace();
+        if (Consume(']')) {
+            return true;
+        }
+
+        for (;;) {
+            SkipWhitespace();
+            value.m_elements.emplace_back();
+            if (!ParseValue(value.m_elements.back(), depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Consume(']')) {
+                return true;
+            }
+            if (!Consume(',')) {
+                return Fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool ParseString(std::string& out) {
+        ++m_cursor;
+        out.clear();
+        while (m_cursor < m_end) {
+            char c = *m_cursor++;
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return Fail("control character in string");
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_cursor >= m_end) {
+                break;
+            }
+
+            char escape = *m_cursor++;
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned int codePoint = 0;
+                    if (!ParseHex(codePoint)) {
+                        return false;
+                    }
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        unsigned int low = 0;
+                        if (m_end - m_cursor < 2 || m_cursor[0] != '\\' || m_cursor[1] != 'u') {
+                            return Fail("unpaired surrogate");
+                        }
+                        m_cursor += 2;
+                        if (!ParseHex(low) || low < 0xDC00 || low > 0xDFFF) {
+                            return Fail("invalid surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(codePoint, out);
+                    break;
+                }
+                default:
+                    return Fail("invalid escape sequence");
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseHex(unsigned int& value) {
+        if (m_end - m_cursor < 4) {
+            return Fail("truncated unicode escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *m_cursor++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<unsigned int>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned int>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<unsigned int>(c - 'A' + 10);
+            else return Fail("invalid unicode escape");
+        }
+        return true;
+    }
+
+    static void AppendUtf8(unsigned int codePoint, std::string& out) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool ParseNumber(JsonValue& value) {
+        const char* start = m_cursor;
+        if (m_cursor < m_end && *m_cursor == '-') ++m_cursor;
+        if (m_cursor >= m_end || *m_cursor < '0' || *m_cursor > '9') {
+            return Fail("unexpected character");
+        }
+        while (m_cursor < m_end && (std::strchr("0123456789+-.eE", *m_cursor) != nullptr)) {
+            ++m_cursor;
+        }
+
+        std::string literal(start, m_cursor);
+        char* parsedEnd = nullptr;
+        value.m_number = std::strtod(literal.c_str(), &parsedEnd);
+        if (parsedEnd != literal.c_str() + literal.size()) {
+            m_cursor = start;
+            return Fail("invalid number");
+        }
+        value.m_type = Type::Number;
+        return true;
+    }
+
+    bool ParseLiteral(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (static_cast<size_t>(m_end - m_cursor) < length || std::strncmp(m_cursor, literal, length) != 0) {
+            return Fail("invalid literal");
+        }
+        m_cursor += length;
+        return true;
+    }
+
+    void SkipWhitespace() {
+        while (m_cursor < m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r')) {
+            ++m_cursor;
+        }
+    }
+
+    bool Consume(char c) {
+        if (m_cursor < m_end && *m_cursor == c) {
+            ++m_cursor;
+            return true;
+        }
+        return false;
+    }
+
+    bool Fail(const char* message) {
+        if (m_error.empty()) {
+            m_error = message;
+        }
+        return false;
+    }
+
+    std::string FormatError() const {
+        size_t line = 1;
+        size_t column = 1;
+        for (const char* c = m_text; c < m_cursor && c < m_end; ++c) {
+            if (*c == '\n') {
+                ++line;
+                column = 1;
+            } else {
+                ++column;
+            }
+        }
+        return m_error + " at line " + std::to_string(line) + ", column " + std::to_string(column);
+    }
+
+    const char* m_text;
+    const char* m_end;
+    const char* m_cursor;
+    std::string m_error;
+};
+
+JsonValue::JsonValue() : m_type(Type::Null), m_bool(false), m_number(0.0) {
+}
+
+bool JsonValue::Parse(const std::string& text, JsonValue& value, std::string& error) {
+    JsonValue parsed;
+    Parser parser(text);
+    if (!parser.ParseDocument(parsed, error)) {
+        return false;
+    }
+    value = std::move(parsed);
+    return true;
+}
+
+const JsonValue& JsonValue::GetNull() {
+    static const JsonValue null;
+    return null;
+}
+
+bool JsonValue::AsBool(bool defaultValue) const {
+    return m_type == Type::Bool ? m_bool : defaultValue;
+}
+
+double JsonValue::AsNumber(double defaultValue) const {
+    return m_type == Type::Number ? m_number : defaultValue;
+}
+
+const std::string& JsonValue::AsString() const {
+    return m_type == Type::String ? m_string : GetNull().m_string;
+}
+
+std::string JsonValue::AsString(const std::string& defaultValue) const {
+    return m_type == Type::String ? m_string : defaultValue;
+}
+
+size_t JsonValue::GetSize() const {
+    if (m_type == Type::Array) {
+        return m_elements.size();
+    }
+    return m_type == Type::Object ? m_members.size() : 0;
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    return m_type == Type::Array && index < m_elements.size() ? m_elements[index] : GetNull();
+}
+
+const JsonValue& JsonValue::operator[](const std::string& key) const {
+    const JsonValue* value = Find(key);
+    return value ? *value : GetNull();
+}
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+    if (m_type != Type::Object) {
+        return nullptr;
+    }
+    for (const auto& member : m_members) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
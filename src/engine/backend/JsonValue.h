@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class JsonValue {
+public:
+    enum class Type {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    static const size_t MAX_DEPTH = 256;
+
+    JsonValue();
+
+    static bool Parse(const std::string& text, JsonValue& value, std::string& error);
+
+    Type GetType() const { return m_type; }
+    bool IsNull() const { return m_type == Type::Null; }
+    bool IsBool() const { return m_type == Type::Bool; }
+    bool IsNumber() const { return m_type == Type::Number; }
+    bool IsString() const { return m_type == Type::String; }
+    bool IsArray() const { return m_type == Type::Array; }
+    bool IsObject() const { return m_type == Type::Object; }
+
+    bool AsBool(bool defaultValue = false) const;
+    double AsNumber(double defaultValue = 0.0) const;
+    const std::string& AsString() const;
+    std::string AsString(const std::string& defaultValue) const;
+
+    size_t GetSize() const;
+    const JsonValue& operator[](size_t index) const;
+    const JsonValue& operator[](const std::string& key) const;
+    const JsonValue* Find(const std::string& key) const;
+    const std::vector<JsonValue>& GetElements() const { return m_elements; }
+    const std::vector<std::pair<std::string, JsonValue>>& GetMembers() const { return m_members; }
+
+private:
+    class Parser;
+
+    static const JsonValue& GetNull();
+
+    Type m_type;
+    bool m_bool;
+    double m_number;
+    std::string m_string;
+    std::vector<JsonValue> m_elements;
+    std::vector<std::pair<std::string, JsonValue>> m_members;
+};
@@ -0,0 +1,189 @@
+#include "LZ4.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+inline uint32_t Read32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ4::HASH_BITS);
+}
+
+}
+
+size_t LZ4::GetMaxCompressedSize(size_t size) {
+    return size + size / 255 + 16;
+}
+
+bool LZ4::WriteLength(size_t length, unsigned char*& output, const unsigned char* outputEnd) {
+    while (length >= 255) {
+        if (output >= outputEnd) {
+            return false;
+        }
+        *output++ = 255;
+        length -= 255;
+    }
+    if (output >= outputEnd) {
+        return false;
+    }
+    *output++ = static_cast<unsigned char>(length);
+    return true;
+}
+
+bool LZ4::WriteLiterals(const unsigned char* literals, size_t count, size_t matchToken,
+                        unsigned char*& output, const unsigned char* outputEnd) {
+    if (output >= outputEnd) {
+        return false;
+    }
+    unsigned char* token = output++;
+    *token = static_cast<unsigned char>(((count >= 15 ? 15 : count) << 4) | (matchToken >= 15 ? 15 : matchToken));
+    if (count >= 15 && !WriteLength(count - 15, output, outputEnd)) {
+        return false;
+    }
+    if (static_cast<size_t>(outputEnd - output) < count) {
+        return false;
+    }
+    std::memcpy(output, literals, count);
+    output += count;
+    return true;
+}
+
+size_t LZ4::Compress(const char* source, size_t sourceSize, char* destination, size_t capacity) {
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(source);
+    unsigned char* output = reinterpret_cast<unsigned char*>(destination);
+    const unsigned char* outputEnd = output + capacity;
+    size_t anchor = 0;
+
+    if (sourceSize > MATCH_FIND_LIMIT) {
+        std::vector<uint32_t> table(static_cast<size_t>(1) << HASH_BITS, 0);
+        size_t limit = sourceSize - MATCH_FIND_LIMIT;
+        size_t matchEnd = sourceSize - LAST_LITERALS;
+        size_t position = 0;
+
+        while (position < limit) {
+            uint32_t sequence = Read32(input + position);
+            uint32_t& slot = table[Hash(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || Read32(input + candidate - 1) != sequence) {
+                ++position;
+                continue;
+            }
+            size_t reference = candidate - 1;
+
+            while (position > anchor && reference > 0 && input[position - 1] == input[reference - 1]) {
+                --position;
+                --reference;
+            }
+
+            size_t length = MIN_MATCH;
+            while (position + length < matchEnd && input[reference + length] == input[position + length]) {
+                ++length;
+            }
+
+            size_t matchToken = length - MIN_MATCH;
+            if (!WriteLiterals(input + anchor, position - anchor, matchToken, output, outputEnd)) {
+                return 0;
+            }
+            if (outputEnd - output < 2) {
+                return 0;
+            }
+            size_t offset = position - reference;
+            *output++ = static_cast<unsigned char>(offset & 0xFF);
+            *output++ = static_cast<unsigned char>(offset >> 8);
+            if (matchToken >= 15 && !WriteLength(matchToken - 15, output, outputEnd)) {
+                return 0;
+            }
+
+            position += length;
+            anchor = position;
+            if (position - 2 < limit) {
+                table[Hash(Read32(input + position - 2))] = static_cast<uint32_t>(position - 1);
+            }
+        }
+    }
+
+    if (!WriteLiterals(input + anchor, sourceSize - anchor, 0, output, outputEnd)) {
+        return 0;
+    }
+    return static_cast<size_t>(output - reinterpret_cast<unsigned char*>(destination));
+}
+
+bool LZ4::Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize) {
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(source);
+    const unsigned char* inputEnd = input + sourceSize;
+    unsigned char* output = reinterpret_cast<unsigned char*>(destination);
+    unsigned char* outputStart = output;
+    unsigned char* outputEnd = output + destinationSize;
+
+    for (;;) {
+        if (input >= inputEnd) {
+            return false;
+        }
+        unsigned int token = *input++;
+
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            unsigned char extra;
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+                extra = *input++;
+                literals += extra;
+            } while (extra == 255);
+        }
+        if (static_cast<size_t>(inputEnd - input) < literals || static_cast<size_t>(outputEnd - output) < literals) {
+            return false;
+        }
+        std::memcpy(output, input, literals);
+        input += literals;
+        output += literals;
+
+        if (input == inputEnd) {
+            return output == outputEnd;
+        }
+
+        if (inputEnd - input < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(input[0]) | (static_cast<size_t>(input[1]) << 8);
+        input += 2;
+        if (offset == 0 || offset > static_cast<size_t>(output - outputStart)) {
+            return false;
+        }
+
+        size_t length = token & 15;
+        if (length == 15) {
+            unsigned char extra;
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+                extra = *input++;
+                length += extra;
+            } while (extra == 255);
+        }
+        length += MIN_MATCH;
+        if (static_cast<size_t>(outputEnd - output) < length) {
+            return false;
+        }
+
+        const unsigned char* match = output - offset;
+        if (offset >= length) {
+            std::memcpy(output, match, length);
+            output += length;
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                *output++ = match[i];
+            }
+        }
+    }
+}
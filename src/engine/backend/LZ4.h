@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+class LZ4 {
+public:
+    static const size_t MIN_MATCH = 4;
+    static const size_t LAST_LITERALS = 5;
+    static const size_t MATCH_FIND_LIMIT = 12;
+    static const size_t MAX_OFFSET = 65535;
+    static const unsigned int HASH_BITS = 12;
+
+    static size_t GetMaxCompressedSize(size_t size);
+    static size_t Compress(const char* source, size_t sourceSize, char* destination, size_t capacity);
+    static bool Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize);
+
+private:
+    static bool WriteLength(size_t length, unsigned char*& output, const unsigned char* outputEnd);
+    static bool WriteLiterals(const unsigned char* literals, size_t count, size_t matchToken,
+                              unsigned char*& output, const unsigned char* outputEnd);
+};
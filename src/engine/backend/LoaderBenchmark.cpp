@@ -0,0 +1,344 @@
+#include "LoaderBenchmark.h"
+#include "OBJLoader.h"
+#include "ModelArena.h"
+#include "MeshCache.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace {
+
+const float ATTRIBUTE_TOLERANCE = 1e-5f;
+const size_t ROWS_PER_GROUP = 256;
+
+bool NearlyEqual(float a, float b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    return std::fabs(a - b) <= ATTRIBUTE_TOLERANCE * std::max(1.0f, std::max(std::fabs(a), std::fabs(b)));
+}
+
+bool NearlyEqual(const glm::vec3& a, const glm::vec3& b) {
+    return NearlyEqual(a.x, b.x) && NearlyEqual(a.y, b.y) && NearlyEqual(a.z, b.z);
+}
+
+bool NearlyEqual(const glm::vec2& a, const glm::vec2& b) {
+    return NearlyEqual(a.x, b.x) && NearlyEqual(a.y, b.y);
+}
+
+bool IsPacked(const Model& model) {
+    if (!model.mappedData || model.meshes.capacity() != model.meshes.size()
+        || model.materials.capacity() != model.materials.size()) {
+        return false;
+    }
+    for (const auto& mesh : model.meshes) {
+        if (mesh.mappedData != model.mappedData
+            || mesh.vertices.capacity() != 0 || mesh.indices.capacity() != 0 || mesh.meshlets.capacity() != 0
+            || mesh.lods.capacity() != mesh.lods.size()) {
+            return false;
+        }
+        for (const auto& lod : mesh.lods) {
+            if (lod.indices.capacity() != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+bool LoaderBenchmark::GenerateTestFile(const std::string& filename, size_t targetMegabytes, bool force) {
+    std::string mtlPath = filename.substr(0, filename.find_last_of("/\\") + 1) + "benchmark.mtl";
+    if (filename.find_last_of("/\\") == std::string::npos) {
+        mtlPath = "benchmark.mtl";
+    }
+
+    struct stat st;
+    for (const std::string& path : { filename, mtlPath }) {
+        if (!force && stat(path.c_str(), &st) == 0) {
+            std::cerr << "Refusing to overwrite existing file " << path << " (pass -force=1 to replace it)" << std::endl;
+            return false;
+        }
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Could not create benchmark file: " << filename << std::endl;
+        return false;
+    }
+
+    const double bytesPerCell = 180.0;
+    size_t gridSize = static_cast<size_t>(std::sqrt(targetMegabytes * 1024.0 * 1024.0 / bytesPerCell)) + 2;
+    char line[256];
+    std::string buffer;
+    buffer.reserve(1 << 20);
+
+    auto flush = [&]() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    };
+
+    for (size_t z = 0; z < gridSize; ++z) {
+        for (size_t x = 0; x < gridSize; ++x) {
+            float fx = static_cast<float>(x) * 0.25f;
+            float fz = static_cast<float>(z) * 0.25f;
+            float height = std::sin(fx * 0.7f) * std::cos(fz * 0.3f) * 2.0f;
+            glm::vec3 normal = glm::normalize(glm::vec3(-std::cos(fx * 0.7f) * 1.4f, 1.0f, std::sin(fz * 0.3f) * 0.6f));
+
+            int length = std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+                                       fx, height, -fz,
+                                       static_cast<float>(x) / gridSize, static_cast<float>(z) / gridSize,
+                                       normal.x, normal.y, normal.z);
+            buffer.append(line, static_cast<size_t>(length));
+        }
+        if (buffer.size() > (1 << 20) - 4096) flush();
+    }
+
+    buffer += "mtllib benchmark.mtl\n";
+    for (size_t z = 0; z + 1 < gridSize; ++z) {
+        if (z % ROWS_PER_GROUP == 0) {
+            int length = std::snprintf(line, sizeof(line), "g strip_%zu\nusemtl %s\n", z / ROWS_PER_GROUP,
+                                       (z / ROWS_PER_GROUP) % 2 ? "rock" : "grass");
+            buffer.append(line, static_cast<size_t>(length));
+        }
+        for (size_t x = 0; x + 1 < gridSize; ++x) {
+            size_t a = z * gridSize + x + 1;
+            size_t b = a + 1;
+            size_t c = a + gridSize + 1;
+            size_t d = a + gridSize;
+            int length = (x % 2 == 0)
+                ? std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                                a, a, a, b, b, b, c, c, c, d, d, d)
+                : std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\nf %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                                a, a, a, b, b, b, c, c, c, a, a, a, c, c, c, d, d, d);
+            buffer.append(line, static_cast<size_t>(length));
+            if (buffer.size() > (1 << 20) - 4096) flush();
+        }
+    }
+    flush();
+
+    std::ofstream mtl(mtlPath, std::ios::trunc);
+    mtl << "newmtl grass\nKd 0.2 0.7 0.2\nNs 16\n\nnewmtl rock\nKd 0.5 0.5 0.5\nNs 64\n";
+
+    std::cout << "Generated " << filename << " (" << gridSize << "x" << gridSize << " grid)" << std::endl;
+    return static_cast<bool>(file);
+}
+
+bool LoaderBenchmark::Run(const std::string& filename, int iterations) {
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0) {
+        std::cerr << "Benchmark file not found: " << filename << std::endl;
+        return false;
+    }
+    double megabytes = static_cast<double>(st.st_size) / (1024.0 * 1024.0);
+    if (iterations < 1) iterations = 1;
+
+    std::cout << "OBJ loader benchmark: " << filename << " (" << megabytes << " MB, "
+              << iterations << " iteration(s))" << std::endl;
+
+    OBJLoader tinyLoader;
+    tinyLoader.SetUseCache(false);
+    tinyLoader.SetParserBackend(OBJLoader::ParserBackend::TinyObj);
+
+    OBJLoader fastLoader;
+    fastLoader.SetUseCache(false);
+    fastLoader.SetParserBackend(OBJLoader::ParserBackend::Fast);
+
+    Model tinyModel, fastModel;
+    double tinySeconds = 0.0, fastSeconds = 0.0;
+    if (!TimeLoad(tinyLoader, filename, iterations, tinyModel, tinySeconds)
+        || !TimeLoad(fastLoader, filename, iterations, fastModel, fastSeconds)) {
+        return false;
+    }
+
+    std::cout << "  tinyobj: " << tinySeconds * 1000.0 << " ms (" << megabytes / tinySeconds << " MB/s)" << std::endl;
+    std::cout << "  fast:    " << fastSeconds * 1000.0 << " ms (" << megabytes / fastSeconds << " MB/s)" << std::endl;
+    std::cout << "  speedup: " << tinySeconds / fastSeconds << "x" << std::endl;
+    std::cout << "  meshes: " << fastModel.meshes.size()
+              << ", vertices: " << fastModel.GetTotalVertexCount()
+              << ", indices: " << fastModel.GetTotalIndexCount() << std::endl;
+
+    std::string difference;
+    if (!CompareModels(tinyModel, fastModel, difference)) {
+        std::cerr << "  Models differ: " << difference << std::endl;
+        return false;
+    }
+    std::cout << "  Models match" << std::endl;
+    return true;
+}
+
+bool LoaderBenchmark::TimeLoad(OBJLoader& loader, const std::string& filename, int iterations, Model& model, double& seconds) {
+    double best = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        model = Model();
+        auto start = std::chrono::steady_clock::now();
+        if (!loader.LoadModel(filename, model)) {
+            std::cerr << "Benchmark load failed: " << loader.GetLastError() << std::endl;
+            return false;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    seconds = best;
+    return true;
+}
+
+bool LoaderBenchmark::RunArena(const std::string& filename, int copies) {
+    if (copies < 1) copies = 1;
+    std::cout << "Model arena benchmark: " << filename << " (" << copies << " resident copies)" << std::endl;
+    return MeasureResidency(filename, copies, false) && MeasureResidency(filename, copies, true)
+        && VerifyCachedArena(filename);
+}
+
+bool LoaderBenchmark::MeasureResidency(const std::string& filename, int copies, bool useArena) {
+    OBJLoader loader;
+    loader.SetUseCache(false);
+    loader.SetWeldMode(OBJLoader::WeldMode::Indices);
+    loader.SetBuildMeshlets(true);
+    loader.SetUseArena(useArena);
+
+    size_t baseline = GetResidentBytes();
+    std::vector<Model> models(static_cast<size_t>(copies));
+    auto start = std::chrono::steady_clock::now();
+    for (auto& model : models) {
+        if (!loader.LoadModel(filename, model)) {
+            std::cerr << "Benchmark load failed: " << loader.GetLastError() << std::endl;
+            return false;
+        }
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t loaded = GetResidentBytes();
+
+    size_t blocks = 0;
+    size_t payload = 0;
+    for (const auto& model : models) {
+        blocks += ModelArena::CountHeapBlocks(model);
+        payload += ModelArena::GetRequiredSize(model);
+    }
+
+    start = std::chrono::steady_clock::now();
+    models.clear();
+    models.shrink_to_fit();
+    double freeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t released = GetResidentBytes();
+
+    std::cout << (useArena ? "  arena:   " : "  vectors: ") << loadSeconds * 1000.0 << " ms load, "
+              << freeSeconds * 1000.0 << " ms free, " << blocks << " heap blocks, "
+              << payload / 1024 << " KB payload, RSS +" << (loaded > baseline ? loaded - baseline : 0) / 1024
+              << " KB loaded / +" << (released > baseline ? released - baseline : 0) / 1024 << " KB after free" << std::endl;
+    return true;
+}
+
+bool LoaderBenchmark::VerifyCachedArena(const std::string& filename) {
+    OBJLoader loader;
+    loader.SetWeldMode(OBJLoader::WeldMode::Indices);
+    loader.SetBuildMeshlets(true);
+    loader.SetUseArena(true);
+
+    MeshCache::Invalidate(filename);
+    Model parsed, cached;
+    if (!loader.LoadModel(filename, parsed)) {
+        std::cerr << "Benchmark load failed: " << loader.GetLastError() << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (stat(MeshCache::GetCachePath(filename).c_str(), &st) != 0) {
+        std::cerr << "  cached: no mesh cache written for " << filename << std::endl;
+        return false;
+    }
+    if (!loader.LoadModel(filename, cached)) {
+        std::cerr << "Benchmark load failed: " << loader.GetLastError() << std::endl;
+        return false;
+    }
+
+    if (!IsPacked(parsed) || !IsPacked(cached)) {
+        std::cerr << "  cached: arena was not applied to the " << (IsPacked(parsed) ? "cached" : "parsed") << " model" << std::endl;
+        return false;
+    }
+    std::string difference;
+    if (!CompareModels(parsed, cached, difference)) {
+        std::cerr << "  cached: models differ: " << difference << std::endl;
+        return false;
+    }
+    std::cout << "  cached:  " << ModelArena::CountHeapBlocks(cached) << " heap blocks, models match" << std::endl;
+    return true;
+}
+
+size_t LoaderBenchmark::GetResidentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+bool LoaderBenchmark::CompareModels(const Model& expected, const Model& actual, std::string& difference) {
+    if (expected.materials.size() != actual.materials.size()) {
+        difference = "material count";
+        return false;
+    }
+    for (size_t i = 0; i < expected.materials.size(); ++i) {
+        if (expected.materials[i].name != actual.materials[i].name
+            || !NearlyEqual(expected.materials[i].diffuse, actual.materials[i].diffuse)) {
+            difference = "material " + std::to_string(i);
+            return false;
+        }
+    }
+
+    if (expected.meshes.size() != actual.meshes.size()) {
+        difference = "mesh count " + std::to_string(expected.meshes.size()) + " vs " + std::to_string(actual.meshes.size());
+        return false;
+    }
+
+    for (size_t m = 0; m < expected.meshes.size(); ++m) {
+        const Mesh& a = expected.meshes[m];
+        const Mesh& b = actual.meshes[m];
+        std::string prefix = "mesh " + std::to_string(m) + " (" + a.name + "): ";
+
+        if (a.name != b.name || a.materialIndex != b.materialIndex) {
+            difference = prefix + "name or material";
+            return false;
+        }
+        if (a.GetVertexCount() != b.GetVertexCount() || a.GetIndexCount() != b.GetIndexCount()) {
+            difference = prefix + "vertex or index count";
+            return false;
+        }
+
+        const unsigned int* indicesA = a.GetIndexData();
+        const unsigned int* indicesB = b.GetIndexData();
+        for (size_t i = 0; i < a.GetIndexCount(); ++i) {
+            if (indicesA[i] != indicesB[i]) {
+                difference = prefix + "index " + std::to_string(i);
+                return false;
+            }
+        }
+
+        const Vertex* verticesA = a.GetVertexData();
+        const Vertex* verticesB = b.GetVertexData();
+        for (size_t i = 0; i < a.GetVertexCount(); ++i) {
+            if (!NearlyEqual(verticesA[i].position, verticesB[i].position)
+                || !NearlyEqual(verticesA[i].normal, verticesB[i].normal)
+                || !NearlyEqual(verticesA[i].texCoord, verticesB[i].texCoord)
+                || !NearlyEqual(verticesA[i].tangent, verticesB[i].tangent)) {
+                difference = prefix + "vertex " + std::to_string(i);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
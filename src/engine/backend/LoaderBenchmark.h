@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+struct Model;
+class OBJLoader;
+
+class LoaderBenchmark {
+public:
+    static bool GenerateTestFile(const std::string& filename, size_t targetMegabytes, bool force = false);
+    static bool Run(const std::string& filename, int iterations);
+    static bool RunArena(const std::string& filename, int copies);
+
+private:
+    static bool TimeLoad(OBJLoader& loader, const std::string& filename, int iterations, Model& model, double& seconds);
+    static bool MeasureResidency(const std::string& filename, int copies, bool useArena);
+    static bool VerifyCachedArena(const std::string& filename);
+    static size_t GetResidentBytes();
+    static bool CompareModels(const Model& expected, const Model& actual, std::string& difference);
+};
@@ -0,0 +1,98 @@
+#include "MeshBuilder.h"
+#include <cstring>
+
+size_t MeshBuilder::IndexKeyHash::operator()(const IndexKey& key) const {
+    size_t hash = static_cast<size_t>(static_cast<uint32_t>(key.positionIndex)) * 73856093u;
+    hash ^= static_cast<size_t>(static_cast<uint32_t>(key.normalIndex)) * 19349663u;
+    hash ^= static_cast<size_t>(static_cast<uint32_t>(key.texCoordIndex)) * 83492791u;
+    return hash;
+}
+
+MeshBuilder::AttributeKey::AttributeKey(const Vertex& vertex) {
+    std::memcpy(values + 0, &vertex.position.x, sizeof(float) * 3);
+    std::memcpy(values + 3, &vertex.normal.x, sizeof(float) * 3);
+    std::memcpy(values + 6, &vertex.texCoord.x, sizeof(float) * 2);
+}
+
+bool MeshBuilder::AttributeKey::operator==(const AttributeKey& other) const {
+    return std::memcmp(values, other.values, sizeof(values)) == 0;
+}
+
+size_t MeshBuilder::AttributeKeyHash::operator()(const AttributeKey& key) const {
+    uint32_t bits[8];
+    std::memcpy(bits, key.values, sizeof(bits));
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t word : bits) {
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+MeshBuilder::MeshBuilder(Mesh& mesh, const MeshAttributes& attributes, OBJLoader::WeldMode weldMode)
+    : m_mesh(mesh)
+    , m_attributes(attributes)
+    , m_weldMode(weldMode) {
+}
+
+void MeshBuilder::Reserve(size_t cornerCount) {
+    if (m_weldMode == OBJLoader::WeldMode::Indices) {
+        m_indexLookup.reserve(cornerCount);
+    } else if (m_weldMode == OBJLoader::WeldMode::Exact) {
+        m_attributeLookup.reserve(cornerCount);
+    } else {
+        m_mesh.vertices.reserve(m_mesh.vertices.size() + cornerCount);
+    }
+    m_mesh.indices.reserve(m_mesh.indices.size() + cornerCount);
+}
+
+void MeshBuilder::AddCorner(int positionIndex, int normalIndex, int texCoordIndex) {
+    if (m_weldMode == OBJLoader::WeldMode::Indices) {
+        IndexKey key = { positionIndex, normalIndex, texCoordIndex };
+        auto result = m_indexLookup.emplace(key, static_cast<unsigned int>(m_mesh.vertices.size()));
+        if (!result.second) {
+            m_mesh.indices.push_back(result.first->second);
+            return;
+        }
+    }
+
+    Vertex vertex = MakeVertex(m_attributes, positionIndex, normalIndex, texCoordIndex);
+
+    if (m_weldMode == OBJLoader::WeldMode::Exact) {
+        auto result = m_attributeLookup.emplace(AttributeKey(vertex), static_cast<unsigned int>(m_mesh.vertices.size()));
+        if (!result.second) {
+            m_mesh.indices.push_back(result.first->second);
+            return;
+        }
+    }
+
+    m_mesh.indices.push_back(static_cast<unsigned int>(m_mesh.vertices.size()));
+    m_mesh.vertices.push_back(vertex);
+}
+
+void MeshBuilder::Finish() {
+    m_mesh.vertices.shrink_to_fit();
+    m_indexLookup.clear();
+    m_attributeLookup.clear();
+}
+
+Vertex MeshBuilder::MakeVertex(const MeshAttributes& attributes, int positionIndex, int normalIndex, int texCoordIndex) {
+    Vertex vertex;
+
+    if (positionIndex >= 0 && static_cast<size_t>(positionIndex) < attributes.positionCount) {
+        const float* p = attributes.positions + 3 * static_cast<size_t>(positionIndex);
+        vertex.position = glm::vec3(p[0], p[1], p[2]);
+    }
+
+    if (normalIndex >= 0 && static_cast<size_t>(normalIndex) < attributes.normalCount) {
+        const float* n = attributes.normals + 3 * static_cast<size_t>(normalIndex);
+        vertex.normal = glm::vec3(n[0], n[1], n[2]);
+    }
+
+    if (texCoordIndex >= 0 && static_cast<size_t>(texCoordIndex) < attributes.texCoordCount) {
+        const float* t = attributes.texCoords + 2 * static_cast<size_t>(texCoordIndex);
+        vertex.texCoord = glm::vec2(t[0], attributes.flipUVs ? 1.0f - t[1] : t[1]);
+    }
+
+    return vertex;
+}
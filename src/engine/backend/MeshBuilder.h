@@ -0,0 +1,62 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <unordered_map>
+
+struct MeshAttributes {
+    const float* positions;
+    size_t positionCount;
+    const float* normals;
+    size_t normalCount;
+    const float* texCoords;
+    size_t texCoordCount;
+    bool flipUVs;
+
+    MeshAttributes() : positions(nullptr), positionCount(0), normals(nullptr), normalCount(0),
+                       texCoords(nullptr), texCoordCount(0), flipUVs(false) {}
+};
+
+class MeshBuilder {
+public:
+    MeshBuilder(Mesh& mesh, const MeshAttributes& attributes, OBJLoader::WeldMode weldMode);
+
+    void Reserve(size_t cornerCount);
+    void AddCorner(int positionIndex, int normalIndex, int texCoordIndex);
+    void Finish();
+
+    static Vertex MakeVertex(const MeshAttributes& attributes, int positionIndex, int normalIndex, int texCoordIndex);
+
+private:
+    struct IndexKey {
+        int positionIndex;
+        int normalIndex;
+        int texCoordIndex;
+
+        bool operator==(const IndexKey& other) const {
+            return positionIndex == other.positionIndex
+                && normalIndex == other.normalIndex
+                && texCoordIndex == other.texCoordIndex;
+        }
+    };
+
+    struct IndexKeyHash {
+        size_t operator()(const IndexKey& key) const;
+    };
+
+    struct AttributeKey {
+        float values[8];
+
+        explicit AttributeKey(const Vertex& vertex);
+        bool operator==(const AttributeKey& other) const;
+    };
+
+    struct AttributeKeyHash {
+        size_t operator()(const AttributeKey& key) const;
+    };
+
+    Mesh& m_mesh;
+    const MeshAttributes& m_attributes;
+    OBJLoader::WeldMode m_weldMode;
+    std::unordered_map<IndexKey, unsigned int, IndexKeyHash> m_indexLookup;
+    std::unordered_map<AttributeKey, unsigned int, AttributeKeyHash> m_attributeLookup;
+};
@@ -0,0 +1,341 @@
+#include "MeshCache.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <functional>
+#include <sys/stat.h>
+
+const uint32_t MeshCache::CACHE_VERSION = 3;
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'P', 'F', 'M', 'C' };
+const size_t DATA_ALIGNMENT = 16;
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t loaderFlags;
+    uint32_t vertexSize;
+    int64_t sourceMtime;
+    uint64_t sourceSize;
+    uint32_t materialCount;
+    uint32_t meshCount;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+class CacheWriter {
+public:
+    explicit CacheWriter(std::ofstream& stream) : m_stream(stream), m_offset(0) {}
+
+    void Write(const void* data, size_t size) {
+        m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        m_offset += size;
+    }
+
+    template<typename T>
+    void WriteValue(const T& value) {
+        Write(&value, sizeof(T));
+    }
+
+    void WriteString(const std::string& value) {
+        WriteValue(static_cast<uint32_t>(value.size()));
+        Write(value.data(), value.size());
+    }
+
+    void WriteVec3(const glm::vec3& value) {
+        Write(&value.x, sizeof(float) * 3);
+    }
+
+    void Align(size_t alignment) {
+        static const char zeros[DATA_ALIGNMENT] = {};
+        size_t padding = (alignment - (m_offset % alignment)) % alignment;
+        Write(zeros, padding);
+    }
+
+private:
+    std::ofstream& m_stream;
+    size_t m_offset;
+};
+
+class CacheReader {
+public:
+    CacheReader(const unsigned char* data, size_t size) : m_data(data), m_size(size), m_offset(0) {}
+
+    bool Read(void* out, size_t size) {
+        if (m_offset + size > m_size) {
+            return false;
+        }
+        std::memcpy(out, m_data + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    template<typename T>
+    bool ReadValue(T& value) {
+        return Read(&value, sizeof(T));
+    }
+
+    bool ReadString(std::string& value) {
+        uint32_t length = 0;
+        if (!ReadValue(length) || m_offset + length > m_size) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    bool ReadVec3(glm::vec3& value) {
+        return Read(&value.x, sizeof(float) * 3);
+    }
+
+    const unsigned char* Span(size_t size) {
+        if (m_offset + size > m_size) {
+            return nullptr;
+        }
+        const unsigned char* span = m_data + m_offset;
+        m_offset += size;
+        return span;
+    }
+
+    bool Align(size_t alignment) {
+        m_offset += (alignment - (m_offset % alignment)) % alignment;
+        return m_offset <= m_size;
+    }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_offset;
+};
+
+void WriteMaterial(CacheWriter& writer, const Material& material) {
+    writer.WriteString(material.name);
+    writer.WriteVec3(material.ambient);
+    writer.WriteVec3(material.diffuse);
+    writer.WriteVec3(material.specular);
+    writer.WriteValue(material.shininess);
+    writer.WriteValue(material.transparency);
+    writer.WriteValue(material.refractiveIndex);
+    writer.WriteString(material.diffuseTex);
+    writer.WriteString(material.normalTex);
+    writer.WriteString(material.specularTex);
+}
+
+bool ReadMaterial(CacheReader& reader, Material& material) {
+    return reader.ReadString(material.name)
+        && reader.ReadVec3(material.ambient)
+        && reader.ReadVec3(material.diffuse)
+        && reader.ReadVec3(material.specular)
+        && reader.ReadValue(material.shininess)
+        && reader.ReadValue(material.transparency)
+        && reader.ReadValue(material.refractiveIndex)
+        && reader.ReadString(material.diffuseTex)
+        && reader.ReadString(material.normalTex)
+        && reader.ReadString(material.specularTex);
+}
+
+}
+
+std::string MeshCache::GetCachePath(const std::string& sourcePath) {
+    return sourcePath + ".pfmesh";
+}
+
+void MeshCache::Invalidate(const std::string& sourcePath) {
+    std::remove(GetCachePath(sourcePath).c_str());
+}
+
+bool MeshCache::GetSourceStamp(const std::string& sourcePath, int64_t& mtime, uint64_t& size) {
+    struct stat st;
+    if (stat(sourcePath.c_str(), &st) != 0) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(st.st_mtime);
+    size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+bool MeshCache::Load(const std::string& sourcePath, uint32_t loaderFlags, Model& model) {
+    int64_t sourceMtime = 0;
+    uint64_t sourceSize = 0;
+    if (!GetSourceStamp(sourcePath, sourceMtime, sourceSize)) {
+        return false;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(GetCachePath(sourcePath))) {
+        return false;
+    }
+
+    CacheReader reader(file->GetData(), file->GetSize());
+
+    CacheHeader header;
+    if (!reader.ReadValue(header)
+        || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != CACHE_VERSION
+        || header.loaderFlags != loaderFlags
+        || header.vertexSize != sizeof(Vertex)
+        || header.sourceMtime != sourceMtime
+        || header.sourceSize != sourceSize) {
+        return false;
+    }
+
+    std::string cachedPath;
+    if (!reader.ReadString(cachedPath) || cachedPath != sourcePath) {
+        return false;
+    }
+
+    Model cached;
+    cached.name = sourcePath;
+    cached.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    cached.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+
+    cached.materials.resize(header.materialCount);
+    for (auto& material : cached.materials) {
+        if (!ReadMaterial(reader, material)) {
+            return false;
+        }
+    }
+
+    cached.meshes.resize(header.meshCount);
+    for (auto& mesh : cached.meshes) {
+        int32_t materialIndex = 0;
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        if (!reader.ReadString(mesh.name)
+            || !reader.ReadValue(materialIndex)
+            || !reader.ReadValue(vertexCount)
+            || !reader.ReadValue(indexCount)) {
+            return false;
+        }
+
+        if (!reader.Align(DATA_ALIGNMENT)) {
+            return false;
+        }
+        const unsigned char* vertexSpan = reader.Span(static_cast<size_t>(vertexCount) * sizeof(Vertex));
+        if (!reader.Align(DATA_ALIGNMENT)) {
+            return false;
+        }
+        const unsigned char* indexSpan = reader.Span(static_cast<size_t>(indexCount) * sizeof(unsigned int));
+        if (!vertexSpan || !indexSpan) {
+            return false;
+        }
+
+        mesh.materialIndex = materialIndex;
+        mesh.mappedVertices = reinterpret_cast<const Vertex*>(vertexSpan);
+        mesh.mappedVertexCount = static_cast<size_t>(vertexCount);
+        mesh.mappedIndices = reinterpret_cast<const unsigned int*>(indexSpan);
+        mesh.mappedIndexCount = static_cast<size_t>(indexCount);
+        mesh.mappedData = file;
+
+        uint32_t lodCount = 0;
+        if (!reader.ReadValue(lodCount)) {
+            return false;
+        }
+        mesh.lods.resize(lodCount);
+        for (auto& lod : mesh.lods) {
+            uint64_t lodIndexCount = 0;
+            if (!reader.ReadValue(lod.error) || !reader.ReadValue(lodIndexCount) || !reader.Align(DATA_ALIGNMENT)) {
+                return false;
+            }
+            const unsigned char* lodSpan = reader.Span(static_cast<size_t>(lodIndexCount) * sizeof(unsigned int));
+            if (!lodSpan) {
+                return false;
+            }
+            lod.mappedIndices = reinterpret_cast<const unsigned int*>(lodSpan);
+            lod.mappedIndexCount = static_cast<size_t>(lodIndexCount);
+        }
+
+        uint64_t meshletCount = 0;
+        if (!reader.ReadValue(meshletCount) || !reader.Align(DATA_ALIGNMENT)) {
+            return false;
+        }
+        const unsigned char* meshletSpan = reader.Span(static_cast<size_t>(meshletCount) * sizeof(Meshlet));
+        if (!meshletSpan) {
+            return false;
+        }
+        if (meshletCount > 0) {
+            mesh.mappedMeshlets = reinterpret_cast<const Meshlet*>(meshletSpan);
+            mesh.mappedMeshletCount = static_cast<size_t>(meshletCount);
+        }
+    }
+
+    cached.mappedData = file;
+    model = std::move(cached);
+    return true;
+}
+
+bool MeshCache::Save(const std::string& sourcePath, uint32_t loaderFlags, const Model& model) {
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.loaderFlags = loaderFlags;
+    header.vertexSize = sizeof(Vertex);
+    header.materialCount = static_cast<uint32_t>(model.materials.size());
+    header.meshCount = static_cast<uint32_t>(model.meshes.size());
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = model.boundsMin[i];
+        header.boundsMax[i] = model.boundsMax[i];
+    }
+    if (!GetSourceStamp(sourcePath, header.sourceMtime, header.sourceSize)) {
+        return false;
+    }
+
+    std::string cachePath = GetCachePath(sourcePath);
+    std::string tempPath = cachePath + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        std::cerr << "Warning: Could not write mesh cache " << cachePath << std::endl;
+        return false;
+    }
+
+    CacheWriter writer(stream);
+    writer.WriteValue(header);
+    writer.WriteString(sourcePath);
+
+    for (const auto& material : model.materials) {
+        WriteMaterial(writer, material);
+    }
+
+    for (const auto& mesh : model.meshes) {
+        writer.WriteString(mesh.name);
+        writer.WriteValue(static_cast<int32_t>(mesh.materialIndex));
+        writer.WriteValue(static_cast<uint64_t>(mesh.GetVertexCount()));
+        writer.WriteValue(static_cast<uint64_t>(mesh.GetIndexCount()));
+        writer.Align(DATA_ALIGNMENT);
+        writer.Write(mesh.GetVertexData(), mesh.GetVertexCount() * sizeof(Vertex));
+        writer.Align(DATA_ALIGNMENT);
+        writer.Write(mesh.GetIndexData(), mesh.GetIndexCount() * sizeof(unsigned int));
+
+        writer.WriteValue(static_cast<uint32_t>(mesh.lods.size()));
+        for (const auto& lod : mesh.lods) {
+            writer.WriteValue(lod.error);
+            writer.WriteValue(static_cast<uint64_t>(lod.GetIndexCount()));
+            writer.Align(DATA_ALIGNMENT);
+            writer.Write(lod.GetIndexData(), lod.GetIndexCount() * sizeof(unsigned int));
+        }
+
+        writer.WriteValue(static_cast<uint64_t>(mesh.GetMeshletCount()));
+        writer.Align(DATA_ALIGNMENT);
+        writer.Write(mesh.GetMeshletData(), mesh.GetMeshletCount() * sizeof(Meshlet));
+    }
+
+    stream.close();
+    if (!stream) {
+        std::remove(tempPath.c_str());
+        std::cerr << "Warning: Failed while writing mesh cache " << cachePath << std::endl;
+        return false;
+    }
+
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <string>
+#include <cstdint>
+
+class MeshCache {
+public:
+    static const uint32_t CACHE_VERSION;
+
+    static std::string GetCachePath(const std::string& sourcePath);
+    static bool Load(const std::string& sourcePath, uint32_t loaderFlags, Model& model);
+    static bool Save(const std::string& sourcePath, uint32_t loaderFlags, const Model& model);
+    static void Invalidate(const std::string& sourcePath);
+
+private:
+    static bool GetSourceStamp(const std::string& sourcePath, int64_t& mtime, uint64_t& size);
+};
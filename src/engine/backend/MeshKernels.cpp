@@ -0,0 +1,634 @@
+#include "MeshKernels.h"
+#include "MeshSoA.h"
+#include <atomic>
+#include <cmath>
+#include <climits>
+#include <vector>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PF_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PF_X86_SIMD) && defined(__GNUC__)
+#define PF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PF_TARGET_AVX2
+#endif
+
+namespace {
+
+typedef MeshKernels::SimdLevel SimdLevel;
+
+std::atomic<int> g_simdOverride(-1);
+
+SimdLevel DetectSimdLevel() {
+#if defined(PF_X86_SIMD)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) {
+            return SimdLevel::AVX2;
+        }
+    }
+    return sse2 ? SimdLevel::SSE2 : SimdLevel::Scalar;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    return __builtin_cpu_supports("sse2") ? SimdLevel::SSE2 : SimdLevel::Scalar;
+#endif
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const size_t FACE_BLOCK_SIZE = 512;
+const size_t VERTEX_STRIDE = sizeof(Vertex) / sizeof(float);
+
+struct InputStreams {
+    const float* px;
+    const float* py;
+    const float* pz;
+    const float* u;
+    const float* v;
+    size_t stride;
+    size_t count;
+};
+
+struct OutputStream {
+    float* x;
+    float* y;
+    float* z;
+    size_t stride;
+};
+
+struct FaceArrays {
+    float x[FACE_BLOCK_SIZE];
+    float y[FACE_BLOCK_SIZE];
+    float z[FACE_BLOCK_SIZE];
+};
+
+InputStreams GetStreams(const MeshSoA& soa) {
+    InputStreams in;
+    in.px = soa.positionX.data();
+    in.py = soa.positionY.data();
+    in.pz = soa.positionZ.data();
+    in.u = soa.texCoordU.data();
+    in.v = soa.texCoordV.data();
+    in.stride = 1;
+    in.count = soa.GetCount();
+    return in;
+}
+
+InputStreams GetStreams(const Vertex* vertices, size_t count) {
+    InputStreams in;
+    in.px = &vertices[0].position.x;
+    in.py = &vertices[0].position.y;
+    in.pz = &vertices[0].position.z;
+    in.u = &vertices[0].texCoord.x;
+    in.v = &vertices[0].texCoord.y;
+    in.stride = VERTEX_STRIDE;
+    in.count = count;
+    return in;
+}
+
+inline void FaceNormal(const InputStreams& in, size_t i0, size_t i1, size_t i2, float& x, float& y, float& z) {
+    float e1x = in.px[i1] - in.px[i0], e1y = in.py[i1] - in.py[i0], e1z = in.pz[i1] - in.pz[i0];
+    float e2x = in.px[i2] - in.px[i0], e2y = in.py[i2] - in.py[i0], e2z = in.pz[i2] - in.pz[i0];
+    float cx = e1y * e2z - e1z * e2y;
+    float cy = e1z * e2x - e1x * e2z;
+    float cz = e1x * e2y - e1y * e2x;
+    float length2 = cx * cx + cy * cy + cz * cz;
+    float inverse = length2 > 0.0f ? 1.0f / std::sqrt(length2) : 0.0f;
+    x = cx * inverse;
+    y = cy * inverse;
+    z = cz * inverse;
+}
+
+inline void FaceTangent(const InputStreams& in, size_t i0, size_t i1, size_t i2, float& x, float& y, float& z) {
+    float e1x = in.px[i1] - in.px[i0], e1y = in.py[i1] - in.py[i0], e1z = in.pz[i1] - in.pz[i0];
+    float e2x = in.px[i2] - in.px[i0], e2y = in.py[i2] - in.py[i0], e2z = in.pz[i2] - in.pz[i0];
+    float du1 = in.u[i1] - in.u[i0], dv1 = in.v[i1] - in.v[i0];
+    float du2 = in.u[i2] - in.u[i0], dv2 = in.v[i2] - in.v[i0];
+    float determinant = du1 * dv2 - du2 * dv1;
+
+    float tx = dv2 * e1x - dv1 * e2x;
+    float ty = dv2 * e1y - dv1 * e2y;
+    float tz = dv2 * e1z - dv1 * e2z;
+    float length2 = tx * tx + ty * ty + tz * tz;
+    float inverse = (length2 > 0.0f && determinant != 0.0f) ? 1.0f / std::sqrt(length2) : 0.0f;
+    if (determinant < 0.0f) {
+        inverse = -inverse;
+    }
+    x = tx * inverse;
+    y = ty * inverse;
+    z = tz * inverse;
+}
+
+void FaceNormalsScalar(const InputStreams& in, const unsigned int* tris, size_t begin, size_t end, FaceArrays& faces) {
+    for (size_t t = begin; t < end; ++t) {
+        size_t i0 = tris[t * 3], i1 = tris[t * 3 + 1], i2 = tris[t * 3 + 2];
+        if (i0 >= in.count || i1 >= in.count || i2 >= in.count) {
+            faces.x[t] = faces.y[t] = faces.z[t] = 0.0f;
+            continue;
+        }
+        FaceNormal(in, i0 * in.stride, i1 * in.stride, i2 * in.stride, faces.x[t], faces.y[t], faces.z[t]);
+    }
+}
+
+void FaceTangentsScalar(const InputStreams& in, const unsigned int* tris, size_t begin, size_t end, FaceArrays& faces) {
+    for (size_t t = begin; t < end; ++t) {
+        size_t i0 = tris[t * 3], i1 = tris[t * 3 + 1], i2 = tris[t * 3 + 2];
+        if (i0 >= in.count || i1 >= in.count || i2 >= in.count) {
+            faces.x[t] = faces.y[t] = faces.z[t] = 0.0f;
+            continue;
+        }
+        FaceTangent(in, i0 * in.stride, i1 * in.stride, i2 * in.stride, faces.x[t], faces.y[t], faces.z[t]);
+    }
+}
+
+void NormalizeScalar(const float* accumulated, float* x, float* y, float* z, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const float* value = accumulated + i * 4;
+        float length2 = value[0] * value[0] + value[1] * value[1] + value[2] * value[2];
+        float inverse = length2 > 0.0f ? 1.0f / std::sqrt(length2) : 1.0f;
+        x[i] = value[0] * inverse;
+        y[i] = value[1] * inverse;
+        z[i] = value[2] * inverse;
+    }
+}
+
+#if defined(PF_X86_SIMD)
+
+#define PF_LOAD4(stream, c) _mm_setr_ps(stream[tri[c] * stride], stream[tri[c + 3] * stride], \
+                                        stream[tri[c + 6] * stride], stream[tri[c + 9] * stride])
+
+void FaceNormalsSSE2(const InputStreams& in, const unsigned int* tris, size_t triangleCount, FaceArrays& faces) {
+    const float* px = in.px;
+    const float* py = in.py;
+    const float* pz = in.pz;
+    const size_t stride = in.stride;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const unsigned int* tri = tris + t * 3;
+        __m128 p0x = PF_LOAD4(px, 0), p0y = PF_LOAD4(py, 0), p0z = PF_LOAD4(pz, 0);
+        __m128 e1x = _mm_sub_ps(PF_LOAD4(px, 1), p0x);
+        __m128 e1y = _mm_sub_ps(PF_LOAD4(py, 1), p0y);
+        __m128 e1z = _mm_sub_ps(PF_LOAD4(pz, 1), p0z);
+        __m128 e2x = _mm_sub_ps(PF_LOAD4(px, 2), p0x);
+        __m128 e2y = _mm_sub_ps(PF_LOAD4(py, 2), p0y);
+        __m128 e2z = _mm_sub_ps(PF_LOAD4(pz, 2), p0z);
+
+        __m128 cx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+        __m128 cy = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+        __m128 cz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+        __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz));
+        __m128 mask = _mm_cmpgt_ps(length2, zero);
+        __m128 inverse = _mm_and_ps(mask, _mm_div_ps(one, _mm_sqrt_ps(length2)));
+
+        _mm_storeu_ps(faces.x + t, _mm_mul_ps(cx, inverse));
+        _mm_storeu_ps(faces.y + t, _mm_mul_ps(cy, inverse));
+        _mm_storeu_ps(faces.z + t, _mm_mul_ps(cz, inverse));
+    }
+
+    FaceNormalsScalar(in, tris, t, triangleCount, faces);
+}
+
+void FaceTangentsSSE2(const InputStreams& in, const unsigned int* tris, size_t triangleCount, FaceArrays& faces) {
+    const float* px = in.px;
+    const float* py = in.py;
+    const float* pz = in.pz;
+    const float* u = in.u;
+    const float* v = in.v;
+    const size_t stride = in.stride;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const unsigned int* tri = tris + t * 3;
+        __m128 p0x = PF_LOAD4(px, 0), p0y = PF_LOAD4(py, 0), p0z = PF_LOAD4(pz, 0);
+        __m128 e1x = _mm_sub_ps(PF_LOAD4(px, 1), p0x);
+        __m128 e1y = _mm_sub_ps(PF_LOAD4(py, 1), p0y);
+        __m128 e1z = _mm_sub_ps(PF_LOAD4(pz, 1), p0z);
+        __m128 e2x = _mm_sub_ps(PF_LOAD4(px, 2), p0x);
+        __m128 e2y = _mm_sub_ps(PF_LOAD4(py, 2), p0y);
+        __m128 e2z = _mm_sub_ps(PF_LOAD4(pz, 2), p0z);
+
+        __m128 u0 = PF_LOAD4(u, 0), v0 = PF_LOAD4(v, 0);
+        __m128 du1 = _mm_sub_ps(PF_LOAD4(u, 1), u0);
+        __m128 dv1 = _mm_sub_ps(PF_LOAD4(v, 1), v0);
+        __m128 du2 = _mm_sub_ps(PF_LOAD4(u, 2), u0);
+        __m128 dv2 = _mm_sub_ps(PF_LOAD4(v, 2), v0);
+        __m128 determinant = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(du2, dv1));
+
+        __m128 tx = _mm_sub_ps(_mm_mul_ps(dv2, e1x), _mm_mul_ps(dv1, e2x));
+        __m128 ty = _mm_sub_ps(_mm_mul_ps(dv2, e1y), _mm_mul_ps(dv1, e2y));
+        __m128 tz = _mm_sub_ps(_mm_mul_ps(dv2, e1z), _mm_mul_ps(dv1, e2z));
+        __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+        __m128 mask = _mm_and_ps(_mm_cmpgt_ps(length2, zero), _mm_cmpneq_ps(determinant, zero));
+        __m128 inverse = _mm_and_ps(mask, _mm_div_ps(one, _mm_sqrt_ps(length2)));
+        inverse = _mm_xor_ps(inverse, _mm_and_ps(determinant, signMask));
+
+        _mm_storeu_ps(faces.x + t, _mm_mul_ps(tx, inverse));
+        _mm_storeu_ps(faces.y + t, _mm_mul_ps(ty, inverse));
+        _mm_storeu_ps(faces.z + t, _mm_mul_ps(tz, inverse));
+    }
+
+    FaceTangentsScalar(in, tris, t, triangleCount, faces);
+}
+
+#undef PF_LOAD4
+
+void NormalizeSSE2(const float* accumulated, float* x, float* y, float* z, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(accumulated + i * 4);
+        __m128 vy = _mm_loadu_ps(accumulated + i * 4 + 4);
+        __m128 vz = _mm_loadu_ps(accumulated + i * 4 + 8);
+        __m128 vw = _mm_loadu_ps(accumulated + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+
+        __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+        __m128 mask = _mm_cmpgt_ps(length2, zero);
+        __m128 inverse = _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(one, _mm_sqrt_ps(length2))), _mm_andnot_ps(mask, one));
+        _mm_storeu_ps(x + i, _mm_mul_ps(vx, inverse));
+        _mm_storeu_ps(y + i, _mm_mul_ps(vy, inverse));
+        _mm_storeu_ps(z + i, _mm_mul_ps(vz, inverse));
+    }
+
+    NormalizeScalar(accumulated, x, y, z, i, count);
+}
+
+void BoundsSSE2(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max) {
+    __m128 minimum = _mm_loadu_ps(&vertices[0].position.x);
+    __m128 maximum = minimum;
+
+    for (size_t i = 1; i < count; ++i) {
+        __m128 position = _mm_loadu_ps(&vertices[i].position.x);
+        minimum = _mm_min_ps(minimum, position);
+        maximum = _mm_max_ps(maximum, position);
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, minimum);
+    min = glm::vec3(lanes[0], lanes[1], lanes[2]);
+    _mm_storeu_ps(lanes, maximum);
+    max = glm::vec3(lanes[0], lanes[1], lanes[2]);
+}
+
+PF_TARGET_AVX2 void GatherCorners(const unsigned int* tri, size_t stride, __m256i& i0, __m256i& i1, __m256i& i2) {
+    const __m256i offsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const int* base = reinterpret_cast<const int*>(tri);
+    i0 = _mm256_i32gather_epi32(base, offsets, 4);
+    i1 = _mm256_i32gather_epi32(base + 1, offsets, 4);
+    i2 = _mm256_i32gather_epi32(base + 2, offsets, 4);
+    if (stride != 1) {
+        const __m256i scale = _mm256_set1_epi32(static_cast<int>(stride));
+        i0 = _mm256_mullo_epi32(i0, scale);
+        i1 = _mm256_mullo_epi32(i1, scale);
+        i2 = _mm256_mullo_epi32(i2, scale);
+    }
+}
+
+PF_TARGET_AVX2 void FaceNormalsAVX2(const InputStreams& in, const unsigned int* tris, size_t triangleCount, FaceArrays& faces) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        __m256i i0, i1, i2;
+        GatherCorners(tris + t * 3, in.stride, i0, i1, i2);
+
+        __m256 p0x = _mm256_i32gather_ps(in.px, i0, 4);
+        __m256 p0y = _mm256_i32gather_ps(in.py, i0, 4);
+        __m256 p0z = _mm256_i32gather_ps(in.pz, i0, 4);
+        __m256 e1x = _mm256_sub_ps(_mm256_i32gather_ps(in.px, i1, 4), p0x);
+        __m256 e1y = _mm256_sub_ps(_mm256_i32gather_ps(in.py, i1, 4), p0y);
+        __m256 e1z = _mm256_sub_ps(_mm256_i32gather_ps(in.pz, i1, 4), p0z);
+        __m256 e2x = _mm256_sub_ps(_mm256_i32gather_ps(in.px, i2, 4), p0x);
+        __m256 e2y = _mm256_sub_ps(_mm256_i32gather_ps(in.py, i2, 4), p0y);
+        __m256 e2z = _mm256_sub_ps(_mm256_i32gather_ps(in.pz, i2, 4), p0z);
+
+        __m256 cx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+        __m256 cy = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+        __m256 cz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+        __m256 length2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, cx), _mm256_mul_ps(cy, cy)), _mm256_mul_ps(cz, cz));
+        __m256 mask = _mm256_cmp_ps(length2, zero, _CMP_GT_OQ);
+        __m256 inverse = _mm256_and_ps(mask, _mm256_div_ps(one, _mm256_sqrt_ps(length2)));
+
+        _mm256_storeu_ps(faces.x + t, _mm256_mul_ps(cx, inverse));
+        _mm256_storeu_ps(faces.y + t, _mm256_mul_ps(cy, inverse));
+        _mm256_storeu_ps(faces.z + t, _mm256_mul_ps(cz, inverse));
+    }
+
+    FaceNormalsScalar(in, tris, t, triangleCount, faces);
+}
+
+PF_TARGET_AVX2 void FaceTangentsAVX2(const InputStreams& in, const unsigned int* tris, size_t triangleCount, FaceArrays& faces) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        __m256i i0, i1, i2;
+        GatherCorners(tris + t * 3, in.stride, i0, i1, i2);
+
+        __m256 p0x = _mm256_i32gather_ps(in.px, i0, 4);
+        __m256 p0y = _mm256_i32gather_ps(in.py, i0, 4);
+        __m256 p0z = _mm256_i32gather_ps(in.pz, i0, 4);
+        __m256 e1x = _mm256_sub_ps(_mm256_i32gather_ps(in.px, i1, 4), p0x);
+        __m256 e1y = _mm256_sub_ps(_mm256_i32gather_ps(in.py, i1, 4), p0y);
+        __m256 e1z = _mm256_sub_ps(_mm256_i32gather_ps(in.pz, i1, 4), p0z);
+        __m256 e2x = _mm256_sub_ps(_mm256_i32gather_ps(in.px, i2, 4), p0x);
+        __m256 e2y = _mm256_sub_ps(_mm256_i32gather_ps(in.py, i2, 4), p0y);
+        __m256 e2z = _mm256_sub_ps(_mm256_i32gather_ps(in.pz, i2, 4), p0z);
+
+        __m256 u0 = _mm256_i32gather_ps(in.u, i0, 4);
+        __m256 v0 = _mm256_i32gather_ps(in.v, i0, 4);
+        __m256 du1 = _mm256_sub_ps(_mm256_i32gather_ps(in.u, i1, 4), u0);
+        __m256 dv1 = _mm256_sub_ps(_mm256_i32gather_ps(in.v, i1, 4), v0);
+        __m256 du2 = _mm256_sub_ps(_mm256_i32gather_ps(in.u, i2, 4), u0);
+        __m256 dv2 = _mm256_sub_ps(_mm256_i32gather_ps(in.v, i2, 4), v0);
+        __m256 determinant = _mm256_sub_ps(_mm256_mul_ps(du1, dv2), _mm256_mul_ps(du2, dv1));
+
+        __m256 tx = _mm256_sub_ps(_mm256_mul_ps(dv2, e1x), _mm256_mul_ps(dv1, e2x));
+        __m256 ty = _mm256_sub_ps(_mm256_mul_ps(dv2, e1y), _mm256_mul_ps(dv1, e2y));
+        __m256 tz = _mm256_sub_ps(_mm256_mul_ps(dv2, e1z), _mm256_mul_ps(dv1, e2z));
+        __m256 length2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, tx), _mm256_mul_ps(ty, ty)), _mm256_mul_ps(tz, tz));
+        __m256 mask = _mm256_and_ps(_mm256_cmp_ps(length2, zero, _CMP_GT_OQ), _mm256_cmp_ps(determinant, zero, _CMP_NEQ_OQ));
+        __m256 inverse = _mm256_and_ps(mask, _mm256_div_ps(one, _mm256_sqrt_ps(length2)));
+        inverse = _mm256_xor_ps(inverse, _mm256_and_ps(determinant, signMask));
+
+        _mm256_storeu_ps(faces.x + t, _mm256_mul_ps(tx, inverse));
+        _mm256_storeu_ps(faces.y + t, _mm256_mul_ps(ty, inverse));
+        _mm256_storeu_ps(faces.z + t, _mm256_mul_ps(tz, inverse));
+    }
+
+    FaceTangentsScalar(in, tris, t, triangleCount, faces);
+}
+
+PF_TARGET_AVX2 void NormalizeAVX2(const float* accumulated, float* x, float* y, float* z, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float* base = accumulated + i * 4;
+        __m256 a0 = _mm256_loadu_ps(base);
+        __m256 a1 = _mm256_loadu_ps(base + 8);
+        __m256 a2 = _mm256_loadu_ps(base + 16);
+        __m256 a3 = _mm256_loadu_ps(base + 24);
+        __m256 t0 = _mm256_unpacklo_ps(a0, a1);
+        __m256 t1 = _mm256_unpackhi_ps(a0, a1);
+        __m256 t2 = _mm256_unpacklo_ps(a2, a3);
+        __m256 t3 = _mm256_unpackhi_ps(a2, a3);
+        __m256 vx = _mm256_permutevar8x32_ps(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), order);
+        __m256 vy = _mm256_permutevar8x32_ps(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)), order);
+        __m256 vz = _mm256_permutevar8x32_ps(_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), order);
+
+        __m256 length2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+        __m256 mask = _mm256_cmp_ps(length2, zero, _CMP_GT_OQ);
+        __m256 inverse = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(length2)), mask);
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(vx, inverse));
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(vy, inverse));
+        _mm256_storeu_ps(z + i, _mm256_mul_ps(vz, inverse));
+    }
+
+    NormalizeScalar(accumulated, x, y, z, i, count);
+}
+
+PF_TARGET_AVX2 void BoundsAVX2(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max) {
+    __m256 minimum = _mm256_castps128_ps256(_mm_loadu_ps(&vertices[0].position.x));
+    minimum = _mm256_insertf128_ps(minimum, _mm_loadu_ps(&vertices[0].position.x), 1);
+    __m256 maximum = minimum;
+
+    size_t i = 1;
+    for (; i + 2 <= count; i += 2) {
+        __m256 positions = _mm256_castps128_ps256(_mm_loadu_ps(&vertices[i].position.x));
+        positions = _mm256_insertf128_ps(positions, _mm_loadu_ps(&vertices[i + 1].position.x), 1);
+        minimum = _mm256_min_ps(minimum, positions);
+        maximum = _mm256_max_ps(maximum, positions);
+    }
+
+    __m128 minimum128 = _mm_min_ps(_mm256_castps256_ps128(minimum), _mm256_extractf128_ps(minimum, 1));
+    __m128 maximum128 = _mm_max_ps(_mm256_castps256_ps128(maximum), _mm256_extractf128_ps(maximum, 1));
+    if (i < count) {
+        __m128 position = _mm_loadu_ps(&vertices[i].position.x);
+        minimum128 = _mm_min_ps(minimum128, position);
+        maximum128 = _mm_max_ps(maximum128, position);
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, minimum128);
+    min = glm::vec3(lanes[0], lanes[1], lanes[2]);
+    _mm_storeu_ps(lanes, maximum128);
+    max = glm::vec3(lanes[0], lanes[1], lanes[2]);
+}
+
+#endif
+
+void ComputeFaces(const InputStreams& in, const unsigned int* tris, size_t triangleCount, bool valid,
+                  FaceArrays& faces, bool tangents) {
+    SimdLevel level = valid ? MeshKernels::GetSimdLevel() : SimdLevel::Scalar;
+    if (level == SimdLevel::AVX2 && in.count * in.stride > static_cast<size_t>(INT_MAX)) {
+        level = SimdLevel::SSE2;
+    }
+
+#if defined(PF_X86_SIMD)
+    if (level == SimdLevel::AVX2) {
+        tangents ? FaceTangentsAVX2(in, tris, triangleCount, faces) : FaceNormalsAVX2(in, tris, triangleCount, faces);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        tangents ? FaceTangentsSSE2(in, tris, triangleCount, faces) : FaceNormalsSSE2(in, tris, triangleCount, faces);
+        return;
+    }
+#endif
+
+    tangents ? FaceTangentsScalar(in, tris, 0, triangleCount, faces) : FaceNormalsScalar(in, tris, 0, triangleCount, faces);
+}
+
+void AccumulateFaces(const InputStreams& in, const unsigned int* indices, size_t indexCount, bool tangents,
+                     const OutputStream& out) {
+    FaceArrays faces;
+    size_t triangleCount = indexCount / 3;
+
+    for (size_t block = 0; block < triangleCount; block += FACE_BLOCK_SIZE) {
+        size_t count = std::min(FACE_BLOCK_SIZE, triangleCount - block);
+        const unsigned int* tris = indices + block * 3;
+
+        unsigned int maxIndex = 0;
+        for (size_t i = 0; i < count * 3; ++i) {
+            maxIndex = std::max(maxIndex, tris[i]);
+        }
+        bool valid = maxIndex < in.count;
+        ComputeFaces(in, tris, count, valid, faces, tangents);
+
+        for (size_t t = 0; t < count; ++t) {
+            if (!valid && (tris[t * 3] >= in.count || tris[t * 3 + 1] >= in.count || tris[t * 3 + 2] >= in.count)) {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                size_t offset = static_cast<size_t>(tris[t * 3 + k]) * out.stride;
+                out.x[offset] += faces.x[t];
+                out.y[offset] += faces.y[t];
+                out.z[offset] += faces.z[t];
+            }
+        }
+    }
+}
+
+void ComputeFaceVectors(const InputStreams& in, const unsigned int* indices, size_t faceCount, bool tangents,
+                        glm::vec3* out) {
+    FaceArrays faces;
+
+    for (size_t block = 0; block < faceCount; block += FACE_BLOCK_SIZE) {
+        size_t count = std::min(FACE_BLOCK_SIZE, faceCount - block);
+        const unsigned int* tris = indices + block * 3;
+
+        unsigned int maxIndex = 0;
+        for (size_t i = 0; i < count * 3; ++i) {
+            maxIndex = std::max(maxIndex, tris[i]);
+        }
+        ComputeFaces(in, tris, count, maxIndex < in.count, faces, tangents);
+
+        for (size_t t = 0; t < count; ++t) {
+            out[block + t] = glm::vec3(faces.x[t], faces.y[t], faces.z[t]);
+        }
+    }
+}
+
+void Normalize(const float* accumulated, float* x, float* y, float* z, size_t count) {
+#if defined(PF_X86_SIMD)
+    SimdLevel level = MeshKernels::GetSimdLevel();
+    if (level == SimdLevel::AVX2) {
+        NormalizeAVX2(accumulated, x, y, z, count);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        NormalizeSSE2(accumulated, x, y, z, count);
+        return;
+    }
+#endif
+    NormalizeScalar(accumulated, x, y, z, 0, count);
+}
+
+void ComputeSoA(MeshSoA& soa, const unsigned int* indices, size_t indexCount, bool tangents,
+                std::vector<float>& x, std::vector<float>& y, std::vector<float>& z) {
+    size_t count = soa.GetCount();
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+
+    std::vector<float> accumulated(count * 4, 0.0f);
+    OutputStream out = { accumulated.data(), accumulated.data() + 1, accumulated.data() + 2, 4 };
+    AccumulateFaces(GetStreams(soa), indices, indexCount, tangents, out);
+    Normalize(accumulated.data(), x.data(), y.data(), z.data(), count);
+}
+
+}
+
+MeshKernels::SimdLevel MeshKernels::GetSupportedSimdLevel() {
+    static const SimdLevel supported = DetectSimdLevel();
+    return supported;
+}
+
+MeshKernels::SimdLevel MeshKernels::GetSimdLevel() {
+    int level = g_simdOverride.load(std::memory_order_relaxed);
+    return level < 0 ? GetSupportedSimdLevel() : static_cast<SimdLevel>(level);
+}
+
+void MeshKernels::SetSimdLevel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(GetSupportedSimdLevel())) {
+        level = GetSupportedSimdLevel();
+    }
+    g_simdOverride.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* MeshKernels::GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+void MeshKernels::ComputeBounds(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max) {
+    if (count == 0) {
+        min = max = glm::vec3(0.0f);
+        return;
+    }
+
+#if defined(PF_X86_SIMD)
+    SimdLevel level = GetSimdLevel();
+    if (level == SimdLevel::AVX2) {
+        BoundsAVX2(vertices, count, min, max);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        BoundsSSE2(vertices, count, min, max);
+        return;
+    }
+#endif
+
+    min = max = vertices[0].position;
+    for (size_t i = 1; i < count; ++i) {
+        min = glm::min(min, vertices[i].position);
+        max = glm::max(max, vertices[i].position);
+    }
+}
+
+void MeshKernels::ComputeNormals(MeshSoA& soa, const unsigned int* indices, size_t indexCount) {
+    ComputeSoA(soa, indices, indexCount, false, soa.normalX, soa.normalY, soa.normalZ);
+}
+
+void MeshKernels::ComputeTangents(MeshSoA& soa, const unsigned int* indices, size_t indexCount) {
+    if (soa.texCoordU.size() != soa.GetCount() || soa.texCoordV.size() != soa.GetCount()) {
+        soa.tangentX.assign(soa.GetCount(), 0.0f);
+        soa.tangentY.assign(soa.GetCount(), 0.0f);
+        soa.tangentZ.assign(soa.GetCount(), 0.0f);
+        return;
+    }
+    ComputeSoA(soa, indices, indexCount, true, soa.tangentX, soa.tangentY, soa.tangentZ);
+}
+
+void MeshKernels::ComputeFaceNormals(const Vertex* vertices, size_t count, const unsigned int* indices,
+                                     size_t firstFace, size_t faceCount, glm::vec3* faceNormals) {
+    if (count == 0) {
+        std::fill(faceNormals, faceNormals + faceCount, glm::vec3(0.0f));
+        return;
+    }
+    ComputeFaceVectors(GetStreams(vertices, count), indices + firstFace * 3, faceCount, false, faceNormals);
+}
+
+void MeshKernels::ComputeFaceTangents(const Vertex* vertices, size_t count, const unsigned int* indices,
+                                      size_t firstFace, size_t faceCount, glm::vec3* faceTangents) {
+    if (count == 0) {
+        std::fill(faceTangents, faceTangents + faceCount, glm::vec3(0.0f));
+        return;
+    }
+    ComputeFaceVectors(GetStreams(vertices, count), indices + firstFace * 3, faceCount, true, faceTangents);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "OBJLoader.h"
+
+struct MeshSoA;
+
+class MeshKernels {
+public:
+    enum class SimdLevel {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    static SimdLevel GetSimdLevel();
+    static SimdLevel GetSupportedSimdLevel();
+    static void SetSimdLevel(SimdLevel level);
+    static const char* GetSimdLevelName(SimdLevel level);
+
+    static void ComputeBounds(const Vertex* vertices, size_t count, glm::vec3& min, glm::vec3& max);
+    static void ComputeNormals(MeshSoA& soa, const unsigned int* indices, size_t indexCount);
+    static void ComputeTangents(MeshSoA& soa, const unsigned int* indices, size_t indexCount);
+    static void ComputeFaceNormals(const Vertex* vertices, size_t count, const unsigned int* indices,
+                                   size_t firstFace, size_t faceCount, glm::vec3* faceNormals);
+    static void ComputeFaceTangents(const Vertex* vertices, size_t count, const unsigned int* indices,
+                                    size_t firstFace, size_t faceCount, glm::vec3* faceTangents);
+};
@@ -0,0 +1,294 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <numeric>
+
+void MeshOptimizer::Optimize(Mesh& mesh, size_t cacheSize, float overdrawThreshold) {
+    if (mesh.IsMapped() || mesh.indices.size() < 3 || mesh.vertices.empty()) {
+        return;
+    }
+
+    for (unsigned int index : mesh.indices) {
+        if (index >= mesh.vertices.size()) {
+            return;
+        }
+    }
+    mesh.indices.resize(mesh.indices.size() - mesh.indices.size() % 3);
+
+    std::vector<size_t> clusters;
+    OptimizeVertexCache(mesh.indices, mesh.vertices.size(), cacheSize, clusters);
+    OptimizeOverdraw(mesh.vertices.data(), mesh.indices, mesh.vertices.size(), clusters, cacheSize, overdrawThreshold);
+    OptimizeVertexFetch(mesh.vertices, mesh.indices);
+}
+
+MeshOptimizer::Stats MeshOptimizer::Analyze(const Mesh& mesh, size_t cacheSize) {
+    return Analyze(mesh.GetIndexData(), mesh.GetIndexCount(), mesh.GetVertexCount(), cacheSize);
+}
+
+MeshOptimizer::Stats MeshOptimizer::Analyze(const unsigned int* indices, size_t indexCount, size_t vertexCount, size_t cacheSize) {
+    Stats stats;
+    stats.triangleCount = indexCount / 3;
+    if (stats.triangleCount == 0 || vertexCount == 0) {
+        return stats;
+    }
+
+    std::vector<size_t> timestamps(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t time = cacheSize + 1;
+    size_t referencedCount = 0;
+
+    for (size_t i = 0; i < stats.triangleCount * 3; ++i) {
+        unsigned int index = indices[i];
+        if (index >= vertexCount) {
+            continue;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++referencedCount;
+        }
+        if (time - timestamps[index] > cacheSize) {
+            timestamps[index] = time++;
+            ++stats.cacheMisses;
+        }
+    }
+
+    stats.acmr = static_cast<float>(stats.cacheMisses) / static_cast<float>(stats.triangleCount);
+    stats.atvr = referencedCount ? static_cast<float>(stats.cacheMisses) / static_cast<float>(referencedCount) : 0.0f;
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize,
+                                        std::vector<size_t>& clusters) {
+    size_t triangleCount = indices.size() / 3;
+    clusters.clear();
+    if (triangleCount == 0) {
+        return;
+    }
+
+    std::vector<unsigned int> liveCount(vertexCount, 0);
+    for (unsigned int index : indices) {
+        ++liveCount[index];
+    }
+
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveCount[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<size_t> timestamps(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+    long long fanning = static_cast<long long>(indices[0]);
+    bool hardBoundary = true;
+
+    while (fanning >= 0) {
+        unsigned int vertex = static_cast<unsigned int>(fanning);
+        candidates.clear();
+
+        for (size_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a) {
+            unsigned int triangle = adjacency[a];
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            if (hardBoundary) {
+                clusters.push_back(result.size() / 3);
+                hardBoundary = false;
+            }
+
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[triangle * 3 + k];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --liveCount[v];
+                if (time - timestamps[v] > cacheSize) {
+                    timestamps[v] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        long long best = -1;
+        size_t bestPriority = 0;
+        for (unsigned int v : candidates) {
+            if (liveCount[v] == 0) {
+                continue;
+            }
+            size_t age = time - timestamps[v];
+            size_t priority = 0;
+            if (age + 2 * liveCount[v] <= cacheSize) {
+                priority = age;
+            }
+            if (best < 0 || priority > bestPriority) {
+                best = v;
+                bestPriority = priority;
+            }
+        }
+
+        if (best < 0) {
+            while (!deadEnd.empty()) {
+                unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveCount[v] > 0) {
+                    best = v;
+                    break;
+                }
+            }
+        }
+
+        if (best < 0) {
+            hardBoundary = true;
+            while (cursor < vertexCount && liveCount[cursor] == 0) {
+                ++cursor;
+            }
+            if (cursor < vertexCount) {
+                best = static_cast<long long>(cursor);
+            }
+        }
+
+        fanning = best;
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::SplitClusters(const std::vector<unsigned int>& indices, size_t vertexCount, const std::vector<size_t>& clusters,
+                                  size_t cacheSize, float threshold, std::vector<size_t>& result) {
+    size_t triangleCount = indices.size() / 3;
+    result.clear();
+
+    std::vector<size_t> timestamps(vertexCount, 0);
+    size_t time = cacheSize + 1;
+
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        size_t begin = clusters[c];
+        size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        if (end <= begin) {
+            continue;
+        }
+
+        Stats clusterStats = Analyze(indices.data() + begin * 3, (end - begin) * 3, vertexCount, cacheSize);
+        float limit = clusterStats.acmr * threshold;
+
+        result.push_back(begin);
+        size_t start = begin;
+        size_t misses = 0;
+        time += cacheSize + 1;
+
+        for (size_t t = begin; t < end; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[t * 3 + k];
+                if (time - timestamps[v] > cacheSize) {
+                    timestamps[v] = time++;
+                    ++misses;
+                }
+            }
+
+            size_t count = t - start + 1;
+            if (t + 1 < end && static_cast<float>(misses) / static_cast<float>(count) <= limit) {
+                result.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                time += cacheSize + 1;
+            }
+        }
+    }
+}
+
+void MeshOptimizer::OptimizeOverdraw(const Vertex* vertices, std::vector<unsigned int>& indices, size_t vertexCount,
+                                     const std::vector<size_t>& clusters, size_t cacheSize, float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || clusters.size() == 0) {
+        return;
+    }
+
+    std::vector<size_t> splits;
+    SplitClusters(indices, vertexCount, clusters, cacheSize, threshold, splits);
+    if (splits.size() < 2) {
+        return;
+    }
+
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> centroids(splits.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(splits.size(), glm::vec3(0.0f));
+
+    for (size_t c = 0; c < splits.size(); ++c) {
+        size_t begin = splits[c];
+        size_t end = c + 1 < splits.size() ? splits[c + 1] : triangleCount;
+        float clusterArea = 0.0f;
+
+        for (size_t t = begin; t < end; ++t) {
+            const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+            glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(cross);
+            glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+
+            centroids[c] += center * area;
+            normals[c] += cross;
+            clusterArea += area;
+        }
+
+        meshCentroid += centroids[c];
+        meshArea += clusterArea;
+        centroids[c] = clusterArea > 0.0f ? centroids[c] / clusterArea : glm::vec3(0.0f);
+    }
+
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    std::vector<float> sortKeys(splits.size());
+    for (size_t c = 0; c < splits.size(); ++c) {
+        float length = glm::length(normals[c]);
+        glm::vec3 normal = length > 0.0f ? normals[c] / length : glm::vec3(0.0f);
+        sortKeys[c] = glm::dot(centroids[c] - meshCentroid, normal);
+    }
+
+    std::vector<size_t> order(splits.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (size_t c : order) {
+        size_t begin = splits[c];
+        size_t end = c + 1 < splits.size() ? splits[c + 1] : triangleCount;
+        result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+    }
+    indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), unused);
+    std::vector<Vertex> result;
+    result.reserve(vertices.size());
+
+    for (auto& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<unsigned int>(result.size());
+            result.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(result);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <vector>
+
+class MeshOptimizer {
+public:
+    struct Stats {
+        float acmr;
+        float atvr;
+        size_t cacheMisses;
+        size_t triangleCount;
+
+        Stats() : acmr(0.0f), atvr(0.0f), cacheMisses(0), triangleCount(0) {}
+    };
+
+    static const size_t DEFAULT_CACHE_SIZE = 16;
+
+    static void Optimize(Mesh& mesh, size_t cacheSize = DEFAULT_CACHE_SIZE, float overdrawThreshold = 1.05f);
+    static Stats Analyze(const Mesh& mesh, size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize,
+                                    std::vector<size_t>& clusters);
+    static void OptimizeOverdraw(const Vertex* vertices, std::vector<unsigned int>& indices, size_t vertexCount,
+                                 const std::vector<size_t>& clusters, size_t cacheSize, float threshold);
+    static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+private:
+    static Stats Analyze(const unsigned int* indices, size_t indexCount, size_t vertexCount, size_t cacheSize);
+    static void SplitClusters(const std::vector<unsigned int>& indices, size_t vertexCount, const std::vector<size_t>& clusters,
+                              size_t cacheSize, float threshold, std::vector<size_t>& result);
+};
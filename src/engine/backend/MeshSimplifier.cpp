@@ -0,0 +1,389 @@
+#include "MeshSimplifier.h"
+#include "MeshTopology.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double BORDER_WEIGHT = 10.0;
+const size_t MAX_PASSES = 64;
+
+uint32_t HashPosition(const glm::vec3& position) {
+    uint32_t bits[3];
+    std::memcpy(bits, &position.x, sizeof(bits));
+    uint32_t hash = 2166136261u;
+    for (uint32_t word : bits) {
+        hash ^= word;
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+bool FlipsFaces(const Vertex* vertices, const MeshTopology& topology, const std::vector<unsigned int>& indices,
+                const std::vector<unsigned int>& collapseTarget, unsigned int from, unsigned int to) {
+    const unsigned int* faces = topology.GetVertexFaces(from);
+    size_t faceCount = topology.GetVertexFaceCount(from);
+    for (size_t i = 0; i < faceCount; ++i) {
+        const unsigned int* corners = indices.data() + faces[i] * 3;
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            continue;
+        }
+
+        glm::vec3 before[3];
+        glm::vec3 after[3];
+        for (int k = 0; k < 3; ++k) {
+            before[k] = vertices[corners[k]].position;
+            after[k] = corners[k] == from ? vertices[to].position : vertices[collapseTarget[corners[k]]].position;
+        }
+
+        glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+        glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+        if (glm::dot(normalBefore, normalAfter) <= 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+MeshSimplifier::Quadric::Quadric()
+    : a00(0.0), a11(0.0), a22(0.0), a01(0.0), a02(0.0), a12(0.0)
+    , b0(0.0), b1(0.0), b2(0.0), c(0.0), weight(0.0) {
+}
+
+MeshSimplifier::Quadric::Quadric(const glm::dvec3& normal, double distance, double weight)
+    : a00(normal.x * normal.x * weight)
+    , a11(normal.y * normal.y * weight)
+    , a22(normal.z * normal.z * weight)
+    , a01(normal.x * normal.y * weight)
+    , a02(normal.x * normal.z * weight)
+    , a12(normal.y * normal.z * weight)
+    , b0(normal.x * distance * weight)
+    , b1(normal.y * distance * weight)
+    , b2(normal.z * distance * weight)
+    , c(distance * distance * weight)
+    , weight(weight) {
+}
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(const Quadric& other) {
+    a00 += other.a00;
+    a11 += other.a11;
+    a22 += other.a22;
+    a01 += other.a01;
+    a02 += other.a02;
+    a12 += other.a12;
+    b0 += other.b0;
+    b1 += other.b1;
+    b2 += other.b2;
+    c += other.c;
+    weight += other.weight;
+    return *this;
+}
+
+double MeshSimplifier::Quadric::Evaluate(const glm::vec3& position) const {
+    double x = position.x, y = position.y, z = position.z;
+    double error = a00 * x * x + a11 * y * y + a22 * z * z
+                 + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                 + 2.0 * (b0 * x + b1 * y + b2 * z)
+                 + c;
+    return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+}
+
+float MeshSimplifier::Simplify(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                               size_t targetIndexCount, float targetError, std::vector<unsigned int>& result) {
+    result.clear();
+    if (vertexCount == 0) {
+        return 0.0f;
+    }
+
+    std::vector<unsigned int> remap;
+    std::vector<unsigned int> wedges;
+    BuildPositionRemap(vertices, vertexCount, remap, wedges);
+
+    std::vector<unsigned int> corners;
+    std::vector<unsigned int> canonical;
+    corners.reserve(indexCount);
+    canonical.reserve(indexCount);
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        unsigned int i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+            continue;
+        }
+        unsigned int c0 = remap[i0], c1 = remap[i1], c2 = remap[i2];
+        if (c0 == c1 || c1 == c2 || c0 == c2) {
+            continue;
+        }
+        corners.insert(corners.end(), { i0, i1, i2 });
+        canonical.insert(canonical.end(), { c0, c1, c2 });
+    }
+
+    if (corners.size() <= targetIndexCount) {
+        result.swap(corners);
+        return 0.0f;
+    }
+
+    MeshTopology topology;
+    topology.Build(canonical.data(), canonical.size(), vertexCount);
+    topology.BuildHalfEdges();
+    const std::vector<MeshTopology::HalfEdge>& halfEdges = topology.GetHalfEdges();
+
+    std::vector<unsigned char> borderEdges(canonical.size(), 0);
+    std::vector<VertexKind> kinds(vertexCount, VertexKind::Manifold);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] != v && vertices[v].texCoord != vertices[remap[v]].texCoord) {
+            kinds[remap[v]] = VertexKind::Locked;
+        }
+    }
+    for (size_t h = 0; h < halfEdges.size(); ++h) {
+        if (halfEdges[h].twin != MeshTopology::INVALID_INDEX) {
+            continue;
+        }
+        unsigned int a = canonical[h];
+        unsigned int b = canonical[MeshTopology::GetNext(static_cast<unsigned int>(h))];
+        borderEdges[h] = 1;
+        if (kinds[a] != VertexKind::Locked) {
+            kinds[a] = VertexKind::Border;
+        }
+        if (kinds[b] != VertexKind::Locked) {
+            kinds[b] = VertexKind::Border;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < canonical.size() / 3; ++t) {
+        glm::dvec3 p[3];
+        for (int k = 0; k < 3; ++k) {
+            p[k] = glm::dvec3(vertices[canonical[t * 3 + k]].position);
+        }
+        glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        double length = glm::length(normal);
+        if (length <= 0.0) {
+            continue;
+        }
+        normal /= length;
+
+        Quadric plane(normal, -glm::dot(normal, p[0]), length * 0.5);
+        for (int k = 0; k < 3; ++k) {
+            quadrics[canonical[t * 3 + k]] += plane;
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            if (halfEdges[t * 3 + k].twin != MeshTopology::INVALID_INDEX) {
+                continue;
+            }
+            glm::dvec3 edge = p[(k + 1) % 3] - p[k];
+            double edgeLength = glm::length(edge);
+            if (edgeLength <= 0.0) {
+                continue;
+            }
+            glm::dvec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+            Quadric border(borderNormal, -glm::dot(borderNormal, p[k]), edgeLength * edgeLength * BORDER_WEIGHT);
+            quadrics[canonical[t * 3 + k]] += border;
+            quadrics[canonical[t * 3 + (k + 1) % 3]] += border;
+        }
+    }
+
+    double errorLimit = static_cast<double>(targetError) * static_cast<double>(targetError);
+    double resultError = 0.0;
+    size_t targetTriangles = targetIndexCount / 3;
+
+    std::vector<unsigned int> collapseTarget(vertexCount);
+    std::vector<unsigned char> touched(vertexCount);
+    std::vector<Collapse> best(vertexCount);
+    std::vector<Collapse> candidates;
+
+    for (size_t pass = 0; pass < MAX_PASSES && canonical.size() / 3 > targetTriangles; ++pass) {
+        if (pass > 0) {
+            topology.Build(canonical.data(), canonical.size(), vertexCount);
+        }
+
+        for (auto& collapse : best) {
+            collapse.cost = errorLimit;
+            collapse.to = MeshTopology::INVALID_INDEX;
+        }
+
+        for (size_t i = 0; i < canonical.size(); ++i) {
+            unsigned int a = canonical[i];
+            unsigned int b = canonical[i % 3 == 2 ? i - 2 : i + 1];
+            bool borderEdge = borderEdges[i] != 0;
+            if (a > b && !borderEdge) {
+                continue;
+            }
+
+            unsigned int ends[2] = { a, b };
+            for (int direction = 0; direction < 2; ++direction) {
+                unsigned int from = ends[direction];
+                unsigned int to = ends[1 - direction];
+                if (kinds[from] == VertexKind::Locked) {
+                    continue;
+                }
+                if (kinds[from] == VertexKind::Border && !borderEdge) {
+                    continue;
+                }
+
+                Quadric merged = quadrics[from];
+                merged += quadrics[to];
+                double cost = merged.Evaluate(vertices[to].position);
+                if (cost <= best[from].cost) {
+                    best[from].cost = cost;
+                    best[from].from = from;
+                    best[from].to = to;
+                }
+            }
+        }
+
+        candidates.clear();
+        for (const auto& collapse : best) {
+            if (collapse.to != MeshTopology::INVALID_INDEX) {
+                candidates.push_back(collapse);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (size_t v = 0; v < vertexCount; ++v) {
+            collapseTarget[v] = static_cast<unsigned int>(v);
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t needed = canonical.size() / 3 - targetTriangles;
+        size_t removed = 0;
+        size_t collapses = 0;
+        for (const auto& collapse : candidates) {
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+            if (FlipsFaces(vertices, topology, canonical, collapseTarget, collapse.from, collapse.to)) {
+                continue;
+            }
+
+            collapseTarget[collapse.from] = collapse.to;
+            touched[collapse.from] = 1;
+            touched[collapse.to] = 1;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            resultError = std::max(resultError, collapse.cost);
+            removed += kinds[collapse.from] == VertexKind::Border ? 1 : 2;
+            ++collapses;
+
+            if (removed >= needed) {
+                break;
+            }
+        }
+
+        if (collapses == 0) {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t t = 0; t < canonical.size() / 3; ++t) {
+            unsigned int collapsed[3];
+            unsigned int wedgeIndices[3];
+            for (int k = 0; k < 3; ++k) {
+                unsigned int current = canonical[t * 3 + k];
+                collapsed[k] = collapseTarget[current];
+                wedgeIndices[k] = collapsed[k] == current
+                    ? corners[t * 3 + k]
+                    : PickWedge(vertices, wedges, collapsed[k], corners[t * 3 + k]);
+            }
+            if (collapsed[0] == collapsed[1] || collapsed[1] == collapsed[2] || collapsed[0] == collapsed[2]) {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                canonical[write + k] = collapsed[k];
+                corners[write + k] = wedgeIndices[k];
+                borderEdges[write + k] = borderEdges[t * 3 + k];
+            }
+            write += 3;
+        }
+        canonical.resize(write);
+        corners.resize(write);
+        borderEdges.resize(write);
+    }
+
+    result.swap(corners);
+    std::vector<size_t> clusters;
+    MeshOptimizer::OptimizeVertexCache(result, vertexCount, MeshOptimizer::DEFAULT_CACHE_SIZE, clusters);
+    return static_cast<float>(std::sqrt(resultError));
+}
+
+size_t MeshSimplifier::GenerateLods(Mesh& mesh, size_t levelCount, float reduction, float maxRelativeError) {
+    mesh.lods.clear();
+    if (mesh.IsMapped() || mesh.indices.size() < 3 || mesh.vertices.empty()) {
+        return 0;
+    }
+
+    glm::vec3 boundsMin, boundsMax;
+    mesh.CalculateBounds(boundsMin, boundsMax);
+    float targetError = glm::length(boundsMax - boundsMin) * maxRelativeError;
+
+    float target = static_cast<float>(mesh.indices.size());
+    for (size_t level = 0; level < levelCount; ++level) {
+        target *= reduction;
+        size_t targetIndexCount = static_cast<size_t>(target) / 3 * 3;
+        if (targetIndexCount < MIN_LOD_TRIANGLES * 3) {
+            break;
+        }
+
+        const std::vector<unsigned int>& source = mesh.lods.empty() ? mesh.indices : mesh.lods.back().indices;
+        float sourceError = mesh.lods.empty() ? 0.0f : mesh.lods.back().error;
+
+        MeshLod lod;
+        lod.error = sourceError + Simplify(mesh.vertices.data(), mesh.vertices.size(), source.data(), source.size(),
+                                           targetIndexCount, targetError - sourceError, lod.indices);
+        if (lod.indices.empty() || lod.indices.size() * 10 > source.size() * 9) {
+            break;
+        }
+        mesh.lods.push_back(std::move(lod));
+    }
+    return mesh.lods.size();
+}
+
+void MeshSimplifier::BuildPositionRemap(const Vertex* vertices, size_t vertexCount, std::vector<unsigned int>& remap,
+                                        std::vector<unsigned int>& wedges) {
+    remap.resize(vertexCount);
+    wedges.resize(vertexCount);
+
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2) {
+        tableSize <<= 1;
+    }
+    std::vector<unsigned int> table(tableSize, MeshTopology::INVALID_INDEX);
+
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const glm::vec3& position = vertices[v].position;
+        size_t slot = HashPosition(position) & (tableSize - 1);
+        while (table[slot] != MeshTopology::INVALID_INDEX
+               && std::memcmp(&vertices[table[slot]].position, &position, sizeof(glm::vec3)) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == MeshTopology::INVALID_INDEX) {
+            table[slot] = static_cast<unsigned int>(v);
+        }
+
+        unsigned int canonical = table[slot];
+        remap[v] = canonical;
+        wedges[v] = static_cast<unsigned int>(v);
+        if (canonical != v) {
+            wedges[v] = wedges[canonical];
+            wedges[canonical] = static_cast<unsigned int>(v);
+        }
+    }
+}
+
+unsigned int MeshSimplifier::PickWedge(const Vertex* vertices, const std::vector<unsigned int>& wedges,
+                                       unsigned int target, unsigned int original) {
+    unsigned int best = target;
+    float bestScore = -2.0f;
+    unsigned int wedge = target;
+    do {
+        float score = glm::dot(vertices[wedge].normal, vertices[original].normal);
+        if (score > bestScore) {
+            bestScore = score;
+            best = wedge;
+        }
+        wedge = wedges[wedge];
+    } while (wedge != target);
+    return best;
+}
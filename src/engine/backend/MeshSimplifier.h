@@ -0,0 +1,47 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <vector>
+
+class MeshSimplifier {
+public:
+    static const size_t DEFAULT_LOD_LEVELS = 3;
+    static const size_t MIN_LOD_TRIANGLES = 64;
+
+    static float Simplify(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                          size_t targetIndexCount, float targetError, std::vector<unsigned int>& result);
+    static size_t GenerateLods(Mesh& mesh, size_t levelCount, float reduction = 0.5f, float maxRelativeError = 0.05f);
+
+private:
+    struct Quadric {
+        double a00, a11, a22, a01, a02, a12;
+        double b0, b1, b2;
+        double c;
+        double weight;
+
+        Quadric();
+        Quadric(const glm::dvec3& normal, double distance, double weight);
+
+        Quadric& operator+=(const Quadric& other);
+        double Evaluate(const glm::vec3& position) const;
+    };
+
+    struct Collapse {
+        double cost;
+        unsigned int from;
+        unsigned int to;
+
+        bool operator<(const Collapse& other) const { return cost < other.cost; }
+    };
+
+    enum class VertexKind : unsigned char {
+        Manifold,
+        Border,
+        Locked
+    };
+
+    static void BuildPositionRemap(const Vertex* vertices, size_t vertexCount, std::vector<unsigned int>& remap,
+                                   std::vector<unsigned int>& wedges);
+    static unsigned int PickWedge(const Vertex* vertices, const std::vector<unsigned int>& wedges,
+                                  unsigned int target, unsigned int original);
+};
@@ -0,0 +1,40 @@
+#include "MeshSoA.h"
+#include <algorithm>
+
+void MeshSoA::LoadPositions(const Mesh& mesh) {
+    const Vertex* vertices = mesh.GetVertexData();
+    size_t count = mesh.GetVertexCount();
+    positionX.resize(count);
+    positionY.resize(count);
+    positionZ.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        positionX[i] = vertices[i].position.x;
+        positionY[i] = vertices[i].position.y;
+        positionZ[i] = vertices[i].position.z;
+    }
+}
+
+void MeshSoA::LoadTexCoords(const Mesh& mesh) {
+    const Vertex* vertices = mesh.GetVertexData();
+    size_t count = mesh.GetVertexCount();
+    texCoordU.resize(count);
+    texCoordV.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        texCoordU[i] = vertices[i].texCoord.x;
+        texCoordV[i] = vertices[i].texCoord.y;
+    }
+}
+
+void MeshSoA::StoreNormals(Mesh& mesh) const {
+    size_t count = std::min(mesh.vertices.size(), normalX.size());
+    for (size_t i = 0; i < count; ++i) {
+        mesh.vertices[i].normal = glm::vec3(normalX[i], normalY[i], normalZ[i]);
+    }
+}
+
+void MeshSoA::StoreTangents(Mesh& mesh) const {
+    size_t count = std::min(mesh.vertices.size(), tangentX.size());
+    for (size_t i = 0; i < count; ++i) {
+        mesh.vertices[i].tangent = glm::vec3(tangentX[i], tangentY[i], tangentZ[i]);
+    }
+}
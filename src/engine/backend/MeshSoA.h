@@ -0,0 +1,25 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <vector>
+
+struct MeshSoA {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+    std::vector<float> normalX;
+    std::vector<float> normalY;
+    std::vector<float> normalZ;
+    std::vector<float> texCoordU;
+    std::vector<float> texCoordV;
+    std::vector<float> tangentX;
+    std::vector<float> tangentY;
+    std::vector<float> tangentZ;
+
+    size_t GetCount() const { return positionX.size(); }
+
+    void LoadPositions(const Mesh& mesh);
+    void LoadTexCoords(const Mesh& mesh);
+    void StoreNormals(Mesh& mesh) const;
+    void StoreTangents(Mesh& mesh) const;
+};
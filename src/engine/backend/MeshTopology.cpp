@@ -0,0 +1,185 @@
+#include "MeshTopology.h"
+#include "MeshKernels.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+const unsigned int MeshTopology::INVALID_INDEX;
+
+namespace {
+
+const size_t FACE_BATCH_SIZE = 4096;
+const size_t VERTEX_BATCH_SIZE = 8192;
+
+void RunRange(ThreadPool* pool, size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& body) {
+    if (pool) {
+        pool->ParallelFor(count, body, batchSize);
+    } else if (count > 0) {
+        body(0, count);
+    }
+}
+
+}
+
+MeshTopology::MeshTopology()
+    : m_vertexCount(0)
+    , m_faceCount(0)
+    , m_invalidFaceCount(0)
+    , m_boundaryEdgeCount(0)
+    , m_nonManifoldHalfEdgeCount(0) {
+}
+
+void MeshTopology::Build(const Mesh& mesh) {
+    Build(mesh.GetIndexData(), mesh.GetIndexCount(), mesh.GetVertexCount());
+}
+
+void MeshTopology::Build(const unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    Clear();
+
+    m_vertexCount = vertexCount;
+    m_faceCount = indexCount / 3;
+    m_indices.assign(indices, indices + m_faceCount * 3);
+    m_faceOffsets.assign(vertexCount + 1, 0);
+
+    for (size_t face = 0; face < m_faceCount; ++face) {
+        if (!IsFaceValid(face)) {
+            ++m_invalidFaceCount;
+            continue;
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            ++m_faceOffsets[m_indices[face * 3 + k] + 1];
+        }
+    }
+
+    for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+        m_faceOffsets[vertex + 1] += m_faceOffsets[vertex];
+    }
+
+    m_vertexFaces.resize(m_faceOffsets[vertexCount]);
+    std::vector<unsigned int> cursor(m_faceOffsets.begin(), m_faceOffsets.end() - 1);
+    for (size_t face = 0; face < m_faceCount; ++face) {
+        if (!IsFaceValid(face)) {
+            continue;
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            m_vertexFaces[cursor[m_indices[face * 3 + k]]++] = static_cast<unsigned int>(face);
+        }
+    }
+}
+
+void MeshTopology::BuildHalfEdges(ThreadPool* pool) {
+    m_halfEdges.resize(m_faceCount * 3);
+    std::vector<unsigned char> nonManifold(m_halfEdges.size(), 0);
+
+    RunRange(pool, m_faceCount, FACE_BATCH_SIZE, [this, &nonManifold](size_t begin, size_t end) {
+        for (size_t face = begin; face < end; ++face) {
+            bool valid = IsFaceValid(face);
+            for (size_t k = 0; k < 3; ++k) {
+                unsigned int halfEdge = static_cast<unsigned int>(face * 3 + k);
+                bool shared = false;
+                m_halfEdges[halfEdge].vertex = m_indices[halfEdge];
+                m_halfEdges[halfEdge].twin = valid ? FindTwin(halfEdge, shared) : INVALID_INDEX;
+                nonManifold[halfEdge] = shared ? 1 : 0;
+            }
+        }
+    });
+
+    m_boundaryEdgeCount = 0;
+    m_nonManifoldHalfEdgeCount = 0;
+    for (size_t halfEdge = 0; halfEdge < m_halfEdges.size(); ++halfEdge) {
+        if (nonManifold[halfEdge]) {
+            ++m_nonManifoldHalfEdgeCount;
+        } else if (m_halfEdges[halfEdge].twin == INVALID_INDEX && IsFaceValid(halfEdge / 3)) {
+            ++m_boundaryEdgeCount;
+        }
+    }
+}
+
+void MeshTopology::Clear() {
+    m_vertexCount = 0;
+    m_faceCount = 0;
+    m_invalidFaceCount = 0;
+    m_boundaryEdgeCount = 0;
+    m_nonManifoldHalfEdgeCount = 0;
+    m_indices.clear();
+    m_faceOffsets.clear();
+    m_vertexFaces.clear();
+    m_halfEdges.clear();
+}
+
+bool MeshTopology::IsFaceValid(size_t face) const {
+    const unsigned int* corners = m_indices.data() + face * 3;
+    return corners[0] < m_vertexCount && corners[1] < m_vertexCount && corners[2] < m_vertexCount;
+}
+
+unsigned int MeshTopology::FindTwin(unsigned int halfEdge, bool& nonManifold) const {
+    unsigned int from = m_indices[halfEdge];
+    unsigned int to = m_indices[GetNext(halfEdge)];
+    unsigned int twin = INVALID_INDEX;
+    size_t matches = 0;
+    size_t duplicates = 0;
+
+    const unsigned int* faces = GetVertexFaces(to);
+    size_t faceCount = GetVertexFaceCount(to);
+    for (size_t i = 0; i < faceCount; ++i) {
+        if (i > 0 && faces[i] == faces[i - 1]) {
+            continue;
+        }
+        for (unsigned int k = 0; k < 3; ++k) {
+            unsigned int candidate = faces[i] * 3 + k;
+            if (candidate == halfEdge) {
+                continue;
+            }
+            if (m_indices[candidate] == to && m_indices[GetNext(candidate)] == from) {
+                twin = candidate;
+                ++matches;
+            } else if (m_indices[candidate] == from && m_indices[GetNext(candidate)] == to) {
+                ++duplicates;
+            }
+        }
+    }
+
+    nonManifold = matches > 1 || duplicates > 0;
+    return nonManifold || matches == 0 ? INVALID_INDEX : twin;
+}
+
+void MeshTopology::ComputeNormals(Vertex* vertices, ThreadPool& pool) const {
+    GatherFaceVectors(vertices, false, pool);
+}
+
+void MeshTopology::ComputeTangents(Vertex* vertices, ThreadPool& pool) const {
+    GatherFaceVectors(vertices, true, pool);
+}
+
+void MeshTopology::GatherFaceVectors(Vertex* vertices, bool tangents, ThreadPool& pool) const {
+    std::vector<glm::vec3> faceVectors(m_faceCount);
+
+    pool.ParallelFor(m_faceCount, [this, vertices, tangents, &faceVectors](size_t begin, size_t end) {
+        if (tangents) {
+            MeshKernels::ComputeFaceTangents(vertices, m_vertexCount, m_indices.data(), begin, end - begin, faceVectors.data() + begin);
+        } else {
+            MeshKernels::ComputeFaceNormals(vertices, m_vertexCount, m_indices.data(), begin, end - begin, faceVectors.data() + begin);
+        }
+    }, FACE_BATCH_SIZE);
+
+    pool.ParallelFor(m_vertexCount, [this, vertices, tangents, &faceVectors](size_t begin, size_t end) {
+        for (size_t vertex = begin; vertex < end; ++vertex) {
+            glm::vec3 sum(0.0f);
+            const unsigned int* faces = GetVertexFaces(vertex);
+            size_t faceCount = GetVertexFaceCount(vertex);
+            for (size_t i = 0; i < faceCount; ++i) {
+                sum += faceVectors[faces[i]];
+            }
+
+            float length2 = glm::dot(sum, sum);
+            if (length2 > 0.0f) {
+                sum /= std::sqrt(length2);
+            }
+
+            if (tangents) {
+                vertices[vertex].tangent = sum;
+            } else {
+                vertices[vertex].normal = sum;
+            }
+        }
+    }, VERTEX_BATCH_SIZE);
+}
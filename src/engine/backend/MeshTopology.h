@@ -0,0 +1,59 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <vector>
+
+class ThreadPool;
+
+class MeshTopology {
+public:
+    static const unsigned int INVALID_INDEX = 0xFFFFFFFFu;
+
+    struct HalfEdge {
+        unsigned int vertex;
+        unsigned int twin;
+    };
+
+    MeshTopology();
+
+    void Build(const unsigned int* indices, size_t indexCount, size_t vertexCount);
+    void Build(const Mesh& mesh);
+    void BuildHalfEdges(ThreadPool* pool = nullptr);
+    void Clear();
+
+    size_t GetVertexCount() const { return m_vertexCount; }
+    size_t GetFaceCount() const { return m_faceCount; }
+    size_t GetInvalidFaceCount() const { return m_invalidFaceCount; }
+    const unsigned int* GetIndices() const { return m_indices.data(); }
+
+    size_t GetVertexFaceCount(size_t vertex) const { return m_faceOffsets[vertex + 1] - m_faceOffsets[vertex]; }
+    const unsigned int* GetVertexFaces(size_t vertex) const { return m_vertexFaces.data() + m_faceOffsets[vertex]; }
+    bool IsFaceValid(size_t face) const;
+
+    bool HasHalfEdges() const { return !m_halfEdges.empty(); }
+    const std::vector<HalfEdge>& GetHalfEdges() const { return m_halfEdges; }
+    size_t GetBoundaryEdgeCount() const { return m_boundaryEdgeCount; }
+    size_t GetNonManifoldHalfEdgeCount() const { return m_nonManifoldHalfEdgeCount; }
+
+    static unsigned int GetFace(unsigned int halfEdge) { return halfEdge / 3; }
+    static unsigned int GetNext(unsigned int halfEdge) { return halfEdge % 3 == 2 ? halfEdge - 2 : halfEdge + 1; }
+    static unsigned int GetPrev(unsigned int halfEdge) { return halfEdge % 3 == 0 ? halfEdge + 2 : halfEdge - 1; }
+
+    void ComputeNormals(Vertex* vertices, ThreadPool& pool) const;
+    void ComputeTangents(Vertex* vertices, ThreadPool& pool) const;
+
+private:
+    void GatherFaceVectors(Vertex* vertices, bool tangents, ThreadPool& pool) const;
+    unsigned int FindTwin(unsigned int halfEdge, bool& nonManifold) const;
+
+    size_t m_vertexCount;
+    size_t m_faceCount;
+    size_t m_invalidFaceCount;
+    size_t m_boundaryEdgeCount;
+    size_t m_nonManifoldHalfEdgeCount;
+
+    std::vector<unsigned int> m_indices;
+    std::vector<unsigned int> m_faceOffsets;
+    std::vector<unsigned int> m_vertexFaces;
+    std::vector<HalfEdge> m_halfEdges;
+};
@@ -0,0 +1,114 @@
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+size_t MeshletBuilder::Build(Mesh& mesh) {
+    mesh.meshlets.clear();
+    if (mesh.IsMapped()) {
+        return 0;
+    }
+
+    Build(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size(), mesh.meshlets);
+    return mesh.meshlets.size();
+}
+
+void MeshletBuilder::Build(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                           std::vector<Meshlet>& meshlets) {
+    meshlets.clear();
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        if (indices[i] >= vertexCount) {
+            return;
+        }
+    }
+
+    std::vector<unsigned int> owner(vertexCount, 0xFFFFFFFFu);
+    Meshlet current;
+    unsigned int meshletId = 0;
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* corners = indices + t * 3;
+        unsigned int added = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (owner[corners[k]] != meshletId) {
+                ++added;
+            }
+        }
+
+        if (current.triangleCount == MAX_TRIANGLES || current.vertexCount + added > MAX_VERTICES) {
+            ComputeBounds(vertices, indices, current);
+            meshlets.push_back(current);
+
+            current = Meshlet();
+            current.indexOffset = static_cast<unsigned int>(t * 3);
+            ++meshletId;
+            added = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (owner[corners[k]] != meshletId) {
+                    ++added;
+                }
+            }
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            owner[corners[k]] = meshletId;
+        }
+        current.vertexCount += added;
+        ++current.triangleCount;
+    }
+
+    ComputeBounds(vertices, indices, current);
+    meshlets.push_back(current);
+}
+
+void MeshletBuilder::ComputeBounds(const Vertex* vertices, const unsigned int* indices, Meshlet& meshlet) {
+    const unsigned int* corners = indices + meshlet.indexOffset;
+    size_t cornerCount = static_cast<size_t>(meshlet.triangleCount) * 3;
+
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    for (size_t i = 0; i < cornerCount; ++i) {
+        const glm::vec3& position = vertices[corners[i]].position;
+        boundsMin = i == 0 ? position : glm::min(boundsMin, position);
+        boundsMax = i == 0 ? position : glm::max(boundsMax, position);
+    }
+
+    meshlet.center = (boundsMin + boundsMax) * 0.5f;
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < cornerCount; ++i) {
+        glm::vec3 offset = vertices[corners[i]].position - meshlet.center;
+        radius2 = std::max(radius2, glm::dot(offset, offset));
+    }
+    meshlet.radius = std::sqrt(radius2);
+
+    glm::vec3 normals[MAX_TRIANGLES];
+    size_t normalCount = 0;
+    glm::vec3 axis(0.0f);
+    for (size_t t = 0; t < meshlet.triangleCount; ++t) {
+        const glm::vec3& p0 = vertices[corners[t * 3]].position;
+        glm::vec3 normal = glm::cross(vertices[corners[t * 3 + 1]].position - p0, vertices[corners[t * 3 + 2]].position - p0);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normals[normalCount] = normal / length;
+            axis += normals[normalCount];
+            ++normalCount;
+        }
+    }
+
+    float axisLength = glm::length(axis);
+    meshlet.coneAxis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 1.0f;
+    if (normalCount == 0 || axisLength <= 0.0f) {
+        return;
+    }
+
+    float minDot = 1.0f;
+    for (size_t i = 0; i < normalCount; ++i) {
+        minDot = std::min(minDot, glm::dot(meshlet.coneAxis, normals[i]));
+    }
+    if (minDot > 0.0f) {
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <vector>
+
+class MeshletBuilder {
+public:
+    static const size_t MAX_VERTICES = 64;
+    static const size_t MAX_TRIANGLES = 124;
+
+    static size_t Build(Mesh& mesh);
+    static void Build(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                      std::vector<Meshlet>& meshlets);
+    static void ComputeBounds(const Vertex* vertices, const unsigned int* indices, Meshlet& meshlet);
+};
@@ -0,0 +1,95 @@
+#include "ModelArena.h"
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace {
+
+size_t AlignSize(size_t size) {
+    return (size + ModelArena::ALIGNMENT - 1) & ~(ModelArena::ALIGNMENT - 1);
+}
+
+template<typename T>
+const T* Place(unsigned char*& cursor, std::vector<T>& values, size_t& count) {
+    T* placed = reinterpret_cast<T*>(cursor);
+    count = values.size();
+    if (!values.empty()) {
+        std::memcpy(placed, values.data(), values.size() * sizeof(T));
+    }
+    cursor += AlignSize(values.size() * sizeof(T));
+    std::vector<T>().swap(values);
+    return placed;
+}
+
+size_t CountString(const std::string& value) {
+    return value.capacity() > std::string().capacity() ? 1 : 0;
+}
+
+template<typename T>
+size_t CountVector(const std::vector<T>& values) {
+    return values.capacity() > 0 ? 1 : 0;
+}
+
+}
+
+bool ModelArena::Pack(Model& model) {
+    if (!model.mappedData) {
+        size_t size = GetRequiredSize(model);
+        void* block = ::operator new(size > 0 ? size : ALIGNMENT, std::nothrow);
+        if (!block) {
+            std::cerr << "ModelArena: failed to allocate " << size << " bytes for " << model.name << std::endl;
+            return false;
+        }
+        std::shared_ptr<const void> storage(block, [](const void* data) { ::operator delete(const_cast<void*>(data)); });
+
+        unsigned char* cursor = static_cast<unsigned char*>(block);
+        for (auto& mesh : model.meshes) {
+            mesh.mappedVertices = Place(cursor, mesh.vertices, mesh.mappedVertexCount);
+            mesh.mappedIndices = Place(cursor, mesh.indices, mesh.mappedIndexCount);
+            mesh.mappedMeshlets = Place(cursor, mesh.meshlets, mesh.mappedMeshletCount);
+            mesh.mappedData = storage;
+            for (auto& lod : mesh.lods) {
+                lod.mappedIndices = Place(cursor, lod.indices, lod.mappedIndexCount);
+            }
+        }
+        model.mappedData = storage;
+    }
+
+    for (auto& mesh : model.meshes) {
+        mesh.lods.shrink_to_fit();
+        mesh.name.shrink_to_fit();
+    }
+    model.meshes.shrink_to_fit();
+    model.materials.shrink_to_fit();
+    return true;
+}
+
+size_t ModelArena::GetRequiredSize(const Model& model) {
+    size_t size = 0;
+    for (const auto& mesh : model.meshes) {
+        size += AlignSize(mesh.GetVertexCount() * sizeof(Vertex));
+        size += AlignSize(mesh.GetIndexCount() * sizeof(unsigned int));
+        size += AlignSize(mesh.GetMeshletCount() * sizeof(Meshlet));
+        for (const auto& lod : mesh.lods) {
+            size += AlignSize(lod.GetIndexCount() * sizeof(unsigned int));
+        }
+    }
+    return size;
+}
+
+size_t ModelArena::CountHeapBlocks(const Model& model) {
+    size_t blocks = CountString(model.name) + CountVector(model.meshes) + CountVector(model.materials)
+                  + (model.mappedData ? 1 : 0);
+    for (const auto& material : model.materials) {
+        blocks += CountString(material.name) + CountString(material.diffuseTex)
+                + CountString(material.normalTex) + CountString(material.specularTex);
+    }
+    for (const auto& mesh : model.meshes) {
+        blocks += CountString(mesh.name) + CountVector(mesh.vertices) + CountVector(mesh.indices)
+                + CountVector(mesh.meshlets) + CountVector(mesh.lods);
+        for (const auto& lod : mesh.lods) {
+            blocks += CountVector(lod.indices);
+        }
+    }
+    return blocks;
+}
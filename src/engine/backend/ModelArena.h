@@ -0,0 +1,12 @@
+#pragma once
+
+#include "OBJLoader.h"
+
+class ModelArena {
+public:
+    static const size_t ALIGNMENT = 16;
+
+    static bool Pack(Model& model);
+    static size_t GetRequiredSize(const Model& model);
+    static size_t CountHeapBlocks(const Model& model);
+};
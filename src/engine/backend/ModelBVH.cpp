@@ -0,0 +1,721 @@
+#include "ModelBVH.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PF_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+const unsigned int ModelBVH::INVALID_INDEX;
+
+namespace {
+
+const size_t PRIMITIVE_BATCH_SIZE = 16384;
+const size_t PARALLEL_BUILD_THRESHOLD = 32768;
+const size_t MEDIAN_SPLIT_DEPTH = 48;
+const size_t RAY_BATCH_SIZE = 64;
+const size_t RAY_PACKET_SIZE = 4;
+const float INTERSECT_EPSILON = 1e-8f;
+
+struct Bin {
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    size_t count;
+
+    Bin() : boundsMin(FLT_MAX), boundsMax(-FLT_MAX), count(0) {}
+};
+
+float SurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+    return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+bool IntersectBounds(const ModelBVH::Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection,
+                     float maxDistance, float& entry) {
+    glm::vec3 t0 = (node.boundsMin - origin) * inverseDirection;
+    glm::vec3 t1 = (node.boundsMax - origin) * inverseDirection;
+    glm::vec3 nearT = glm::min(t0, t1);
+    glm::vec3 farT = glm::max(t0, t1);
+    entry = std::max(std::max(nearT.x, nearT.y), std::max(nearT.z, 0.0f));
+    float exit = std::min(std::min(farT.x, farT.y), std::min(farT.z, maxDistance));
+    return entry <= exit;
+}
+
+bool BoundsOverlap(const ModelBVH::Node& node, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    return node.boundsMin.x <= boundsMax.x && node.boundsMax.x >= boundsMin.x &&
+           node.boundsMin.y <= boundsMax.y && node.boundsMax.y >= boundsMin.y &&
+           node.boundsMin.z <= boundsMax.z && node.boundsMax.z >= boundsMin.z;
+}
+
+#if defined(PF_X86_SIMD)
+
+struct RayPacket {
+    __m128 originX, originY, originZ;
+    __m128 inverseX, inverseY, inverseZ;
+};
+
+int IntersectBounds(const ModelBVH::Node& node, const RayPacket& rays, __m128 maxDistance, __m128& entry) {
+    __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.x), rays.originX), rays.inverseX);
+    __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.y), rays.originY), rays.inverseY);
+    __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.z), rays.originZ), rays.inverseZ);
+    __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.x), rays.originX), rays.inverseX);
+    __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.y), rays.originY), rays.inverseY);
+    __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.z), rays.originZ), rays.inverseZ);
+    __m128 nearT = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+                              _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+    __m128 farT = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+                             _mm_min_ps(_mm_max_ps(t0z, t1z), maxDistance));
+    entry = nearT;
+    return _mm_movemask_ps(_mm_cmple_ps(nearT, farT));
+}
+
+int CountLanes(int mask) {
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+#endif
+
+}
+
+ModelBVH::ModelBVH()
+    : m_triangleCount(0) {
+}
+
+void ModelBVH::Clear() {
+    m_nodes.clear();
+    m_packets.clear();
+    m_triangleRefs.clear();
+    m_triangleCount = 0;
+}
+
+size_t ModelBVH::GetMemoryUsage() const {
+    return m_nodes.capacity() * sizeof(Node) + m_packets.capacity() * sizeof(TrianglePacket) +
+           m_triangleRefs.capacity() * sizeof(TriangleRef);
+}
+
+bool ModelBVH::Build(const Model& model, ThreadPool* pool) {
+    Clear();
+
+    BuildContext context;
+    context.pool = pool;
+    context.nodeCount = 1;
+    context.packetCount = 0;
+
+    size_t totalTriangles = 0;
+    for (const auto& mesh : model.meshes) {
+        totalTriangles += mesh.GetIndexCount() / 3;
+    }
+    if (totalTriangles == 0 || totalTriangles >= INVALID_INDEX / 2) {
+        return false;
+    }
+
+    context.sources.resize(totalTriangles);
+    context.corners.resize(totalTriangles * 3);
+    std::vector<unsigned char> valid(totalTriangles, 0);
+
+    size_t meshBase = 0;
+    for (size_t meshIndex = 0; meshIndex < model.meshes.size(); ++meshIndex) {
+        const Mesh& mesh = model.meshes[meshIndex];
+        const Vertex* vertices = mesh.GetVertexData();
+        const unsigned int* indices = mesh.GetIndexData();
+        size_t vertexCount = mesh.GetVertexCount();
+        size_t triangleCount = mesh.GetIndexCount() / 3;
+
+        auto gather = [&, meshIndex, meshBase](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                size_t slot = meshBase + t;
+                const unsigned int* tri = indices + t * 3;
+                context.sources[slot].mesh = static_cast<unsigned int>(meshIndex);
+                context.sources[slot].triangle = static_cast<unsigned int>(t);
+                if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount) {
+                    continue;
+                }
+                for (size_t k = 0; k < 3; ++k) {
+                    context.corners[slot * 3 + k] = vertices[tri[k]].position;
+                }
+                valid[slot] = 1;
+            }
+        };
+
+        if (pool) {
+            pool->ParallelFor(triangleCount, gather, PRIMITIVE_BATCH_SIZE);
+        } else {
+            gather(0, triangleCount);
+        }
+        meshBase += triangleCount;
+    }
+
+    for (size_t i = 0; i < totalTriangles; ++i) {
+        if (valid[i]) {
+            context.order.push_back(static_cast<unsigned int>(i));
+        }
+    }
+    m_triangleCount = context.order.size();
+    if (m_triangleCount == 0) {
+        return false;
+    }
+
+    context.primitives.resize(totalTriangles);
+    auto bound = [&context](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            unsigned int source = context.order[i];
+            const glm::vec3* corners = &context.corners[source * 3];
+            BuildPrimitive& primitive = context.primitives[source];
+            primitive.boundsMin = glm::min(corners[0], glm::min(corners[1], corners[2]));
+            primitive.boundsMax = glm::max(corners[0], glm::max(corners[1], corners[2]));
+            primitive.centroid = (primitive.boundsMin + primitive.boundsMax) * 0.5f;
+        }
+    };
+    if (pool) {
+        pool->ParallelFor(m_triangleCount, bound, PRIMITIVE_BATCH_SIZE);
+    } else {
+        bound(0, m_triangleCount);
+    }
+
+    m_nodes.resize(m_triangleCount * 2);
+    m_packets.resize(m_triangleCount);
+    m_triangleRefs.resize(m_triangleCount * MAX_LEAF_TRIANGLES);
+
+    BuildNode(context, 0, 0, m_triangleCount, 0);
+
+    m_nodes.resize(context.nodeCount.load());
+    m_packets.resize(context.packetCount.load());
+    m_triangleRefs.resize(m_packets.size() * MAX_LEAF_TRIANGLES);
+    m_nodes.shrink_to_fit();
+    m_packets.shrink_to_fit();
+    m_triangleRefs.shrink_to_fit();
+    return true;
+}
+
+void ModelBVH::BuildNode(BuildContext& context, unsigned int nodeIndex, size_t begin, size_t end, size_t depth) {
+    Node& node = m_nodes[nodeIndex];
+    glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    node.boundsMin = glm::vec3(FLT_MAX);
+    node.boundsMax = glm::vec3(-FLT_MAX);
+    for (size_t i = begin; i < end; ++i) {
+        const BuildPrimitive& primitive = context.primitives[context.order[i]];
+        node.boundsMin = glm::min(node.boundsMin, primitive.boundsMin);
+        node.boundsMax = glm::max(node.boundsMax, primitive.boundsMax);
+        centroidMin = glm::min(centroidMin, primitive.centroid);
+        centroidMax = glm::max(centroidMax, primitive.centroid);
+    }
+
+    size_t count = end - begin;
+    if (count <= MAX_LEAF_TRIANGLES) {
+        BuildLeaf(context, node, begin, end);
+        return;
+    }
+
+    glm::vec3 extent = centroidMax - centroidMin;
+    int bestAxis = -1;
+    size_t bestSplit = 0;
+    float bestCost = FLT_MAX;
+
+    if (depth < MEDIAN_SPLIT_DEPTH) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+
+            Bin bins[BIN_COUNT];
+            float scale = BIN_COUNT / extent[axis];
+            for (size_t i = begin; i < end; ++i) {
+                const BuildPrimitive& primitive = context.primitives[context.order[i]];
+                size_t bin = std::min(BIN_COUNT - 1, static_cast<size_t>((primitive.centroid[axis] - centroidMin[axis]) * scale));
+                bins[bin].boundsMin = glm::min(bins[bin].boundsMin, primitive.boundsMin);
+                bins[bin].boundsMax = glm::max(bins[bin].boundsMax, primitive.boundsMax);
+                ++bins[bin].count;
+            }
+
+            float leftArea[BIN_COUNT];
+            size_t leftCount[BIN_COUNT];
+            Bin accumulated;
+            for (size_t i = 0; i + 1 < BIN_COUNT; ++i) {
+                accumulated.boundsMin = glm::min(accumulated.boundsMin, bins[i].boundsMin);
+                accumulated.boundsMax = glm::max(accumulated.boundsMax, bins[i].boundsMax);
+                accumulated.count += bins[i].count;
+                leftArea[i] = SurfaceArea(accumulated.boundsMin, accumulated.boundsMax);
+                leftCount[i] = accumulated.count;
+            }
+
+            accumulated = Bin();
+            for (size_t i = BIN_COUNT - 1; i > 0; --i) {
+                accumulated.boundsMin = glm::min(accumulated.boundsMin, bins[i].boundsMin);
+                accumulated.boundsMax = glm::max(accumulated.boundsMax, bins[i].boundsMax);
+                accumulated.count += bins[i].count;
+                if (leftCount[i - 1] == 0 || accumulated.count == 0) {
+                    continue;
+                }
+                float cost = leftArea[i - 1] * leftCount[i - 1] +
+                             SurfaceArea(accumulated.boundsMin, accumulated.boundsMax) * accumulated.count;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+    }
+
+    size_t middle = begin;
+    if (bestAxis >= 0) {
+        float scale = BIN_COUNT / extent[bestAxis];
+        float origin = centroidMin[bestAxis];
+        auto first = context.order.begin();
+        middle = std::partition(first + begin, first + end, [&](unsigned int source) {
+            float centroid = context.primitives[source].centroid[bestAxis];
+            return std::min(BIN_COUNT - 1, static_cast<size_t>((centroid - origin) * scale)) < bestSplit;
+        }) - first;
+    }
+
+    if (middle == begin || middle == end) {
+        int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        middle = begin + count / 2;
+        auto first = context.order.begin();
+        std::nth_element(first + begin, first + middle, first + end, [&](unsigned int a, unsigned int b) {
+            return context.primitives[a].centroid[axis] < context.primitives[b].centroid[axis];
+        });
+    }
+
+    unsigned int children = context.nodeCount.fetch_add(2);
+    node.offset = children;
+    node.count = 0;
+
+    if (context.pool && count >= PARALLEL_BUILD_THRESHOLD) {
+        context.pool->ParallelFor(2, [&](size_t first, size_t last) {
+            for (size_t child = first; child < last; ++child) {
+                BuildNode(context, children + static_cast<unsigned int>(child),
+                          child == 0 ? begin : middle, child == 0 ? middle : end, depth + 1);
+            }
+        }, 1);
+    } else {
+        BuildNode(context, children, begin, middle, depth + 1);
+        BuildNode(context, children + 1, middle, end, depth + 1);
+    }
+}
+
+void ModelBVH::BuildLeaf(BuildContext& context, Node& node, size_t begin, size_t end) {
+    unsigned int packetIndex = context.packetCount.fetch_add(1);
+    TrianglePacket& packet = m_packets[packetIndex];
+    node.offset = packetIndex;
+    node.count = static_cast<unsigned int>(end - begin);
+
+    for (size_t lane = 0; lane < MAX_LEAF_TRIANGLES; ++lane) {
+        TriangleRef& ref = m_triangleRefs[packetIndex * MAX_LEAF_TRIANGLES + lane];
+        glm::vec3 v0(0.0f), e1(0.0f), e2(0.0f);
+        if (begin + lane < end) {
+            unsigned int source = context.order[begin + lane];
+            const glm::vec3* corners = &context.corners[source * 3];
+            v0 = corners[0];
+            e1 = corners[1] - corners[0];
+            e2 = corners[2] - corners[0];
+            ref = context.sources[source];
+        } else {
+            ref.mesh = INVALID_INDEX;
+            ref.triangle = INVALID_INDEX;
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            packet.v0[axis][lane] = v0[axis];
+            packet.e1[axis][lane] = e1[axis];
+            packet.e2[axis][lane] = e2[axis];
+        }
+    }
+}
+
+bool ModelBVH::Raycast(const Ray& ray, Hit& hit) const {
+    hit = Hit();
+    return Traverse(ray, &hit);
+}
+
+bool ModelBVH::RaycastAny(const Ray& ray) const {
+    return Traverse(ray, nullptr);
+}
+
+size_t ModelBVH::RaycastBatch(const Ray* rays, size_t count, Hit* hits, ThreadPool* pool) const {
+    std::atomic<size_t> hitCount(0);
+    auto body = [this, rays, hits, &hitCount](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t i = begin; i < end; i += RAY_PACKET_SIZE) {
+            local += TracePacket(rays + i, std::min(RAY_PACKET_SIZE, end - i), hits + i);
+        }
+        hitCount += local;
+    };
+
+    if (pool) {
+        pool->ParallelFor(count, body, RAY_BATCH_SIZE);
+    } else if (count > 0) {
+        body(0, count);
+    }
+    return hitCount.load();
+}
+
+bool ModelBVH::Traverse(const Ray& ray, Hit* hit) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    glm::vec3 inverseDirection = 1.0f / ray.direction;
+    float closest = ray.maxDistance;
+    unsigned int closestPacket = INVALID_INDEX;
+    unsigned int closestLane = 0;
+    float closestU = 0.0f, closestV = 0.0f;
+
+    unsigned int stack[MAX_DEPTH];
+    size_t stackSize = 0;
+    float entry = 0.0f;
+    if (!IntersectBounds(m_nodes[0], ray.origin, inverseDirection, closest, entry)) {
+        return false;
+    }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        if (node.IsLeaf()) {
+            float distance = closest;
+            unsigned int lane = 0;
+            float u = 0.0f, v = 0.0f;
+            if (IntersectPacket(m_packets[node.offset], node.count, ray, distance, lane, u, v)) {
+                if (!hit) {
+                    return true;
+                }
+                closest = distance;
+                closestPacket = node.offset;
+                closestLane = lane;
+                closestU = u;
+                closestV = v;
+            }
+            continue;
+        }
+
+        float leftEntry = 0.0f, rightEntry = 0.0f;
+        bool left = IntersectBounds(m_nodes[node.offset], ray.origin, inverseDirection, closest, leftEntry);
+        bool right = IntersectBounds(m_nodes[node.offset + 1], ray.origin, inverseDirection, closest, rightEntry);
+        if (left && right) {
+            bool leftFirst = leftEntry <= rightEntry;
+            stack[stackSize++] = leftFirst ? node.offset + 1 : node.offset;
+            stack[stackSize++] = leftFirst ? node.offset : node.offset + 1;
+        } else if (left) {
+            stack[stackSize++] = node.offset;
+        } else if (right) {
+            stack[stackSize++] = node.offset + 1;
+        }
+    }
+
+    if (!hit || closestPacket == INVALID_INDEX) {
+        return false;
+    }
+
+    FillHit(ray, closest, closestPacket, closestLane, closestU, closestV, *hit);
+    return true;
+}
+
+size_t ModelBVH::TracePacket(const Ray* rays, size_t count, Hit* hits) const {
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = Hit();
+    }
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+#if defined(PF_X86_SIMD)
+    float closest[RAY_PACKET_SIZE];
+    unsigned int closestPacket[RAY_PACKET_SIZE];
+    unsigned int closestLane[RAY_PACKET_SIZE];
+    float closestU[RAY_PACKET_SIZE], closestV[RAY_PACKET_SIZE];
+    float origins[3][RAY_PACKET_SIZE], inverses[3][RAY_PACKET_SIZE];
+    for (size_t i = 0; i < RAY_PACKET_SIZE; ++i) {
+        bool active = i < count;
+        glm::vec3 origin = active ? rays[i].origin : glm::vec3(0.0f);
+        glm::vec3 inverse = active ? 1.0f / rays[i].direction : glm::vec3(1.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            origins[axis][i] = origin[axis];
+            inverses[axis][i] = inverse[axis];
+        }
+        closest[i] = active ? rays[i].maxDistance : -1.0f;
+        closestPacket[i] = INVALID_INDEX;
+        closestLane[i] = 0;
+        closestU[i] = closestV[i] = 0.0f;
+    }
+
+    RayPacket packet;
+    packet.originX = _mm_loadu_ps(origins[0]);
+    packet.originY = _mm_loadu_ps(origins[1]);
+    packet.originZ = _mm_loadu_ps(origins[2]);
+    packet.inverseX = _mm_loadu_ps(inverses[0]);
+    packet.inverseY = _mm_loadu_ps(inverses[1]);
+    packet.inverseZ = _mm_loadu_ps(inverses[2]);
+
+    unsigned int stack[MAX_DEPTH];
+    int stackMasks[MAX_DEPTH];
+    size_t stackSize = 0;
+    __m128 leftEntry, rightEntry;
+    int rootMask = IntersectBounds(m_nodes[0], packet, _mm_loadu_ps(closest), leftEntry);
+    if (rootMask != 0) {
+        stack[stackSize] = 0;
+        stackMasks[stackSize++] = rootMask;
+    }
+
+    while (stackSize > 0) {
+        --stackSize;
+        const Node& node = m_nodes[stack[stackSize]];
+        int active = stackMasks[stackSize];
+
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < count; ++i) {
+                float distance = closest[i];
+                unsigned int lane = 0;
+                float u = 0.0f, v = 0.0f;
+                if ((active & (1 << i)) && IntersectPacket(m_packets[node.offset], node.count, rays[i], distance, lane, u, v)) {
+                    closest[i] = distance;
+                    closestPacket[i] = node.offset;
+                    closestLane[i] = lane;
+                    closestU[i] = u;
+                    closestV[i] = v;
+                }
+            }
+            continue;
+        }
+
+        __m128 maxDistance = _mm_loadu_ps(closest);
+        int left = IntersectBounds(m_nodes[node.offset], packet, maxDistance, leftEntry) & active;
+        int right = IntersectBounds(m_nodes[node.offset + 1], packet, maxDistance, rightEntry) & active;
+        if (left && right) {
+            int leftCloser = _mm_movemask_ps(_mm_cmple_ps(leftEntry, rightEntry)) & left & right;
+            int rightCloser = ~leftCloser & left & right;
+            bool leftFirst = CountLanes(leftCloser) >= CountLanes(rightCloser);
+            stack[stackSize] = leftFirst ? node.offset + 1 : node.offset;
+            stackMasks[stackSize++] = leftFirst ? right : left;
+            stack[stackSize] = leftFirst ? node.offset : node.offset + 1;
+            stackMasks[stackSize++] = leftFirst ? left : right;
+        } else if (left) {
+            stack[stackSize] = node.offset;
+            stackMasks[stackSize++] = left;
+        } else if (right) {
+            stack[stackSize] = node.offset + 1;
+            stackMasks[stackSize++] = right;
+        }
+    }
+
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (closestPacket[i] != INVALID_INDEX) {
+            FillHit(rays[i], closest[i], closestPacket[i], closestLane[i], closestU[i], closestV[i], hits[i]);
+            ++hitCount;
+        }
+    }
+    return hitCount;
+#else
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (Traverse(rays[i], &hits[i])) {
+            ++hitCount;
+        }
+    }
+    return hitCount;
+#endif
+}
+
+void ModelBVH::FillHit(const Ray& ray, float distance, unsigned int packetIndex, unsigned int lane, float u, float v, Hit& hit) const {
+    const TrianglePacket& packet = m_packets[packetIndex];
+    const TriangleRef& ref = m_triangleRefs[packetIndex * MAX_LEAF_TRIANGLES + lane];
+    glm::vec3 e1(packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane]);
+    glm::vec3 e2(packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane]);
+    hit.distance = distance;
+    hit.u = u;
+    hit.v = v;
+    hit.position = ray.origin + ray.direction * distance;
+    hit.normal = glm::normalize(glm::cross(e1, e2));
+    hit.mesh = ref.mesh;
+    hit.triangle = ref.triangle;
+}
+
+bool ModelBVH::IntersectPacket(const TrianglePacket& packet, unsigned int count, const Ray& ray, float& distance,
+                               unsigned int& lane, float& u, float& v) const {
+#if defined(PF_X86_SIMD)
+    __m128 dx = _mm_set1_ps(ray.direction.x), dy = _mm_set1_ps(ray.direction.y), dz = _mm_set1_ps(ray.direction.z);
+    __m128 e1x = _mm_loadu_ps(packet.e1[0]), e1y = _mm_loadu_ps(packet.e1[1]), e1z = _mm_loadu_ps(packet.e1[2]);
+    __m128 e2x = _mm_loadu_ps(packet.e2[0]), e2y = _mm_loadu_ps(packet.e2[1]), e2z = _mm_loadu_ps(packet.e2[2]);
+
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    __m128 inverseDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    __m128 tx = _mm_sub_ps(_mm_set1_ps(ray.origin.x), _mm_loadu_ps(packet.v0[0]));
+    __m128 ty = _mm_sub_ps(_mm_set1_ps(ray.origin.y), _mm_loadu_ps(packet.v0[1]));
+    __m128 tz = _mm_sub_ps(_mm_set1_ps(ray.origin.z), _mm_loadu_ps(packet.v0[2]));
+    __m128 uu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverseDet);
+
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    __m128 vv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDet);
+    __m128 tt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverseDet);
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 mask = _mm_cmpgt_ps(absDet, _mm_set1_ps(INTERSECT_EPSILON));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(uu, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(vv, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(uu, vv), _mm_set1_ps(1.0f)));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(tt, zero));
+    mask = _mm_and_ps(mask, _mm_cmplt_ps(tt, _mm_set1_ps(distance)));
+
+    int bits = _mm_movemask_ps(mask) & ((1 << count) - 1);
+    if (bits == 0) {
+        return false;
+    }
+
+    float t[MAX_LEAF_TRIANGLES], us[MAX_LEAF_TRIANGLES], vs[MAX_LEAF_TRIANGLES];
+    _mm_storeu_ps(t, tt);
+    _mm_storeu_ps(us, uu);
+    _mm_storeu_ps(vs, vv);
+    bool found = false;
+    for (unsigned int i = 0; i < count; ++i) {
+        if ((bits & (1 << i)) && t[i] < distance) {
+            distance = t[i];
+            lane = i;
+            u = us[i];
+            v = vs[i];
+            found = true;
+        }
+    }
+    return found;
+#else
+    bool found = false;
+    for (unsigned int i = 0; i < count; ++i) {
+        glm::vec3 e1(packet.e1[0][i], packet.e1[1][i], packet.e1[2][i]);
+        glm::vec3 e2(packet.e2[0][i], packet.e2[1][i], packet.e2[2][i]);
+        glm::vec3 p = glm::cross(ray.direction, e2);
+        float det = glm::dot(e1, p);
+        if (std::fabs(det) <= INTERSECT_EPSILON) {
+            continue;
+        }
+        float inverseDet = 1.0f / det;
+        glm::vec3 s = ray.origin - glm::vec3(packet.v0[0][i], packet.v0[1][i], packet.v0[2][i]);
+        float uu = glm::dot(s, p) * inverseDet;
+        glm::vec3 q = glm::cross(s, e1);
+        float vv = glm::dot(ray.direction, q) * inverseDet;
+        float t = glm::dot(e2, q) * inverseDet;
+        if (uu >= 0.0f && vv >= 0.0f && uu + vv <= 1.0f && t >= 0.0f && t < distance) {
+            distance = t;
+            lane = i;
+            u = uu;
+            v = vv;
+            found = true;
+        }
+    }
+    return found;
+#endif
+}
+
+size_t ModelBVH::QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<TriangleRef>& results) const {
+    size_t before = results.size();
+    VisitBox(boundsMin, boundsMax, [&results](const TriangleRef& ref) {
+        results.push_back(ref);
+        return false;
+    });
+    return results.size() - before;
+}
+
+bool ModelBVH::OverlapsBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+    return VisitBox(boundsMin, boundsMax, [](const TriangleRef&) {
+        return true;
+    });
+}
+
+template<typename Visitor>
+bool ModelBVH::VisitBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, Visitor&& visitor) const {
+    if (m_nodes.empty() || !BoundsOverlap(m_nodes[0], boundsMin, boundsMax)) {
+        return false;
+    }
+
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    glm::vec3 halfExtents = (boundsMax - boundsMin) * 0.5f;
+    unsigned int stack[MAX_DEPTH];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        if (!node.IsLeaf()) {
+            for (unsigned int child = node.offset; child < node.offset + 2; ++child) {
+                if (BoundsOverlap(m_nodes[child], boundsMin, boundsMax)) {
+                    stack[stackSize++] = child;
+                }
+            }
+            continue;
+        }
+
+        const TrianglePacket& packet = m_packets[node.offset];
+        int candidates = (1 << node.count) - 1;
+#if defined(PF_X86_SIMD)
+        __m128 overlap = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int axis = 0; axis < 3; ++axis) {
+            __m128 v0 = _mm_loadu_ps(packet.v0[axis]);
+            __m128 v1 = _mm_add_ps(v0, _mm_loadu_ps(packet.e1[axis]));
+            __m128 v2 = _mm_add_ps(v0, _mm_loadu_ps(packet.e2[axis]));
+            __m128 low = _mm_min_ps(v0, _mm_min_ps(v1, v2));
+            __m128 high = _mm_max_ps(v0, _mm_max_ps(v1, v2));
+            overlap = _mm_and_ps(overlap, _mm_cmple_ps(low, _mm_set1_ps(boundsMax[axis])));
+            overlap = _mm_and_ps(overlap, _mm_cmpge_ps(high, _mm_set1_ps(boundsMin[axis])));
+        }
+        candidates &= _mm_movemask_ps(overlap);
+#endif
+
+        for (unsigned int lane = 0; lane < node.count; ++lane) {
+            if (!(candidates & (1 << lane))) {
+                continue;
+            }
+            glm::vec3 a(packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane]);
+            glm::vec3 b = a + glm::vec3(packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane]);
+            glm::vec3 c = a + glm::vec3(packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane]);
+            if (TriangleOverlapsBox(center, halfExtents, a, b, c) &&
+                visitor(m_triangleRefs[node.offset * MAX_LEAF_TRIANGLES + lane])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ModelBVH::TriangleOverlapsBox(const glm::vec3& center, const glm::vec3& halfExtents,
+                                   const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 v[3] = { a - center, b - center, c - center };
+    glm::vec3 edges[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+
+    for (int axis = 0; axis < 3; ++axis) {
+        float low = std::min(v[0][axis], std::min(v[1][axis], v[2][axis]));
+        float high = std::max(v[0][axis], std::max(v[1][axis], v[2][axis]));
+        if (low > halfExtents[axis] || high < -halfExtents[axis]) {
+            return false;
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        glm::vec3 unit(0.0f);
+        unit[axis] = 1.0f;
+        for (const auto& edge : edges) {
+            glm::vec3 separating = glm::cross(unit, edge);
+            float p0 = glm::dot(v[0], separating);
+            float p1 = glm::dot(v[1], separating);
+            float p2 = glm::dot(v[2], separating);
+            float radius = glm::dot(halfExtents, glm::abs(separating));
+            if (std::min(p0, std::min(p1, p2)) > radius || std::max(p0, std::max(p1, p2)) < -radius) {
+                return false;
+            }
+        }
+    }
+
+    glm::vec3 normal = glm::cross(edges[0], edges[1]);
+    return std::fabs(glm::dot(normal, v[0])) <= glm::dot(halfExtents, glm::abs(normal));
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <atomic>
+#include <cfloat>
+#include <vector>
+
+class ThreadPool;
+
+class ModelBVH {
+public:
+    static const unsigned int INVALID_INDEX = 0xFFFFFFFFu;
+    static const size_t MAX_LEAF_TRIANGLES = 4;
+    static const size_t BIN_COUNT = 16;
+    static const size_t MAX_DEPTH = 96;
+
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        float maxDistance;
+
+        Ray() : origin(0.0f), direction(0.0f, 0.0f, -1.0f), maxDistance(FLT_MAX) {}
+        Ray(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float rayMaxDistance = FLT_MAX)
+            : origin(rayOrigin), direction(glm::normalize(rayDirection)), maxDistance(rayMaxDistance) {}
+    };
+
+    struct TriangleRef {
+        unsigned int mesh;
+        unsigned int triangle;
+    };
+
+    struct Hit {
+        float distance;
+        float u;
+        float v;
+        glm::vec3 position;
+        glm::vec3 normal;
+        unsigned int mesh;
+        unsigned int triangle;
+
+        Hit() : distance(FLT_MAX), u(0.0f), v(0.0f), position(0.0f), normal(0.0f), mesh(INVALID_INDEX), triangle(INVALID_INDEX) {}
+        bool IsValid() const { return triangle != INVALID_INDEX; }
+    };
+
+    struct Node {
+        glm::vec3 boundsMin;
+        unsigned int offset;
+        glm::vec3 boundsMax;
+        unsigned int count;
+
+        bool IsLeaf() const { return count > 0; }
+    };
+
+    ModelBVH();
+
+    bool Build(const Model& model, ThreadPool* pool = nullptr);
+    void Clear();
+
+    bool Raycast(const Ray& ray, Hit& hit) const;
+    bool RaycastAny(const Ray& ray) const;
+    size_t RaycastBatch(const Ray* rays, size_t count, Hit* hits, ThreadPool* pool = nullptr) const;
+    size_t QueryBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<TriangleRef>& results) const;
+    bool OverlapsBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+    bool IsEmpty() const { return m_nodes.empty(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    size_t GetTriangleCount() const { return m_triangleCount; }
+    size_t GetMemoryUsage() const;
+    const std::vector<Node>& GetNodes() const { return m_nodes; }
+
+private:
+    struct TrianglePacket {
+        float v0[3][MAX_LEAF_TRIANGLES];
+        float e1[3][MAX_LEAF_TRIANGLES];
+        float e2[3][MAX_LEAF_TRIANGLES];
+    };
+
+    struct BuildPrimitive {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        glm::vec3 centroid;
+    };
+
+    struct BuildContext {
+        std::vector<BuildPrimitive> primitives;
+        std::vector<unsigned int> order;
+        std::vector<TriangleRef> sources;
+        std::vector<glm::vec3> corners;
+        std::atomic<unsigned int> nodeCount;
+        std::atomic<unsigned int> packetCount;
+        ThreadPool* pool;
+    };
+
+    void BuildNode(BuildContext& context, unsigned int nodeIndex, size_t begin, size_t end, size_t depth);
+    void BuildLeaf(BuildContext& context, Node& node, size_t begin, size_t end);
+    bool Traverse(const Ray& ray, Hit* hit) const;
+    size_t TracePacket(const Ray* rays, size_t count, Hit* hits) const;
+    void FillHit(const Ray& ray, float distance, unsigned int packetIndex, unsigned int lane, float u, float v, Hit& hit) const;
+    bool IntersectPacket(const TrianglePacket& packet, unsigned int count, const Ray& ray, float& distance,
+                         unsigned int& lane, float& u, float& v) const;
+    template<typename Visitor>
+    bool VisitBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, Visitor&& visitor) const;
+
+    static bool TriangleOverlapsBox(const glm::vec3& center, const glm::vec3& halfExtents,
+                                    const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+    std::vector<Node> m_nodes;
+    std::vector<TrianglePacket> m_packets;
+    std::vector<TriangleRef> m_triangleRefs;
+    size_t m_triangleCount;
+};
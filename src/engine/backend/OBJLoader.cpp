@@ -1,106 +1,111 @@
 #include "OBJLoader.h"
+#include "MeshCache.h"
+#include "ThreadPool.h"
+#include "OBJParser.h"
+#include "MeshBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshKernels.h"
+#include "MeshSoA.h"
+#include "MeshTopology.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ModelArena.h"
+#include "VirtualFileSystem.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "../../../external/tiny_obj_loader.h"
 #include <iostream>
 #include <algorithm>
+#include <thread>
+#include <sstream>
 #include <glm/gtc/constants.hpp>
 
-void Mesh::CalculateBounds(glm::vec3& min, glm::vec3& max) const {
-    if (vertices.empty()) {
-        min = max = glm::vec3(0.0f);
-        return;
+const size_t OBJLoader::MAX_LOD_LEVELS;
+
+namespace {
+
+const uint64_t FAST_PARSER_THRESHOLD = 4ull * 1024 * 1024;
+const size_t PARALLEL_FINALIZE_THRESHOLD = 65536;
+
+class VirtualMaterialReader : public tinyobj::MaterialReader {
+public:
+    explicit VirtualMaterialReader(const std::string& baseDir) : m_baseDir(baseDir) {}
+
+    bool operator()(const std::string& matId, std::vector<tinyobj::material_t>* materials,
+                    std::map<std::string, int>* matMap, std::string* warn, std::string* err) override {
+        std::string contents;
+        if (!VirtualFileSystem::GetDefault().ReadText(m_baseDir + matId, contents)) {
+            if (warn) {
+                *warn += "Material file [ " + m_baseDir + matId + " ] not found.\n";
+            }
+            return false;
+        }
+        std::istringstream stream(contents);
+        std::string mtlWarn, mtlErr;
+        tinyobj::LoadMtl(matMap, materials, &stream, &mtlWarn, &mtlErr);
+        if (warn) {
+            *warn += mtlWarn;
+        }
+        if (err) {
+            *err += mtlErr;
+        }
+        return true;
     }
-    
-    min = max = vertices[0].position;
-    for (const auto& vertex : vertices) {
-        min = glm::min(min, vertex.position);
-        max = glm::max(max, vertex.position);
+
+private:
+    std::string m_baseDir;
+};
+
+}
+
+void Mesh::CalculateBounds(glm::vec3& min, glm::vec3& max) const {
+    MeshKernels::ComputeBounds(GetVertexData(), GetVertexCount(), min, max);
+}
+
+void Mesh::Materialize() {
+    if (mappedVertices) {
+        vertices.assign(mappedVertices, mappedVertices + mappedVertexCount);
+        mappedVertices = nullptr;
+        mappedVertexCount = 0;
+    }
+    if (mappedIndices) {
+        indices.assign(mappedIndices, mappedIndices + mappedIndexCount);
+        mappedIndices = nullptr;
+        mappedIndexCount = 0;
+    }
+    if (mappedMeshlets) {
+        meshlets.assign(mappedMeshlets, mappedMeshlets + mappedMeshletCount);
+        mappedMeshlets = nullptr;
+        mappedMeshletCount = 0;
+    }
+    for (auto& lod : lods) {
+        if (lod.mappedIndices) {
+            lod.indices.assign(lod.mappedIndices, lod.mappedIndices + lod.mappedIndexCount);
+            lod.mappedIndices = nullptr;
+            lod.mappedIndexCount = 0;
+        }
     }
+    mappedData.reset();
 }
 
 void Mesh::CalculateNormals() {
+    Materialize();
     if (vertices.empty()) return;
     
-    for (auto& vertex : vertices) {
-        vertex.normal = glm::vec3(0.0f);
-    }
-    
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        if (i + 2 >= indices.size()) break;
-        
-        unsigned int i0 = indices[i];
-        unsigned int i1 = indices[i + 1];
-        unsigned int i2 = indices[i + 2];
-        
-        if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) continue;
-        
-        glm::vec3 v0 = vertices[i0].position;
-        glm::vec3 v1 = vertices[i1].position;
-        glm::vec3 v2 = vertices[i2].position;
-        
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
-        glm::vec3 normal = glm::normalize(glm::cross(edge1, edge2));
-        
-        vertices[i0].normal += normal;
-        vertices[i1].normal += normal;
-        vertices[i2].normal += normal;
-    }
-    
-    for (auto& vertex : vertices) {
-        if (glm::length(vertex.normal) > 0.0f) {
-            vertex.normal = glm::normalize(vertex.normal);
-        }
-    }
+    MeshSoA soa;
+    soa.LoadPositions(*this);
+    MeshKernels::ComputeNormals(soa, indices.data(), indices.size());
+    soa.StoreNormals(*this);
 }
 
 void Mesh::CalculateTangents() {
+    Materialize();
     if (vertices.empty()) return;
     
-    for (auto& vertex : vertices) {
-        vertex.tangent = glm::vec3(0.0f);
-    }
-    
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        if (i + 2 >= indices.size()) break;
-        
-        unsigned int i0 = indices[i];
-        unsigned int i1 = indices[i + 1];
-        unsigned int i2 = indices[i + 2];
-        
-        if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) continue;
-        
-        glm::vec3 v0 = vertices[i0].position;
-        glm::vec3 v1 = vertices[i1].position;
-        glm::vec3 v2 = vertices[i2].position;
-        
-        glm::vec2 t0 = vertices[i0].texCoord;
-        glm::vec2 t1 = vertices[i1].texCoord;
-        glm::vec2 t2 = vertices[i2].texCoord;
-        
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
-        glm::vec2 deltaUV1 = t1 - t0;
-        glm::vec2 deltaUV2 = t2 - t0;
-        
-        float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-        
-        glm::vec3 tangent;
-        tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-        tangent = glm::normalize(tangent);
-        
-        vertices[i0].tangent += tangent;
-        vertices[i1].tangent += tangent;
-        vertices[i2].tangent += tangent;
-    }
-    
-    for (auto& vertex : vertices) {
-        if (glm::length(vertex.tangent) > 0.0f) {
-            vertex.tangent = glm::normalize(vertex.tangent);
-        }
-    }
+    MeshSoA soa;
+    soa.LoadPositions(*this);
+    soa.LoadTexCoords(*this);
+    MeshKernels::ComputeTangents(soa, indices.data(), indices.size());
+    soa.StoreTangents(*this);
 }
 
 void Model::CalculateBounds() {
@@ -123,7 +128,7 @@ void Model::CalculateBounds() {
 size_t Model::GetTotalVertexCount() const {
     size_t count = 0;
     for (const auto& mesh : meshes) {
-        count += mesh.vertices.size();
+        count += mesh.GetVertexCount();
     }
     return count;
 }
@@ -131,15 +136,12 @@ size_t Model::GetTotalVertexCount() const {
 size_t Model::GetTotalIndexCount() const {
     size_t count = 0;
     for (const auto& mesh : meshes) {
-        count += mesh.indices.size();
+        count += mesh.GetIndexCount();
     }
     return count;
 }
 
-OBJLoader::OBJLoader() 
-    : m_generateNormals(true)
-    , m_generateTangents(false)
-    , m_flipUVs(false) {
+OBJLoader::OBJLoader() {
 }
 
 OBJLoader::~OBJLoader() {
@@ -148,30 +150,53 @@ OBJLoader::~OBJLoader() {
 bool OBJLoader::LoadModel(const std::string& filename, Model& model) {
     ClearError();
     
-    std::string mtl_basedir;
-    size_t lastSlash = filename.find_last_of("/\\");
-    if (lastSlash != std::string::npos) {
-        mtl_basedir = filename.substr(0, lastSlash + 1);
+    std::string error;
+    if (!LoadModelInternal(filename, model, GetOptions(), GetThreadPool(), error)) {
+        SetError(error);
+        return false;
+    }
+    return true;
+}
+
+bool OBJLoader::LoadModelInternal(const std::string& filename, Model& model, const LoadOptions& options,
+                                  ThreadPool& pool, std::string& error) const {
+    std::string realPath;
+    bool useCache = options.useCache && VirtualFileSystem::GetDefault().ResolveLoosePath(filename, realPath);
+    if (useCache && MeshCache::Load(realPath, GetCacheFlags(options), model)) {
+        std::cout << "Loaded cached mesh data for " << filename << std::endl;
+        if (options.useArena) {
+            ModelArena::Pack(model);
+        }
+        return true;
     }
     
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-    
-    bool success = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str(), mtl_basedir.c_str());
-    
-    if (!success) {
-        SetError("Failed to load OBJ file: " + err);
-        return false;
+    std::vector<Mesh> meshes;
+    bool parsed = false;
+    
+    if (UseFastParser(filename, options)) {
+        OBJParser parser(pool);
+        std::string parseError;
+        OBJParser::Result result = parser.Parse(filename, options.weldMode, options.flipUVs, materials, meshes, parseError);
+        if (result == OBJParser::Result::Failed) {
+            error = "Failed to load OBJ file: " + parseError;
+            return false;
+        }
+        if (result == OBJParser::Result::Unsupported) {
+            std::cout << "Falling back to tinyobj for " << filename << " (polygon faces)" << std::endl;
+            materials.clear();
+            meshes.clear();
+        }
+        parsed = result == OBJParser::Result::Success;
     }
     
-    if (!warn.empty()) {
-        std::cout << "Warning while loading " << filename << ": " << warn << std::endl;
+    if (!parsed && !ParseTinyObj(filename, options, materials, meshes, error)) {
+        return false;
     }
     
-    model.meshes.clear();
+    model.meshes = std::move(meshes);
     model.materials.clear();
+    model.mappedData.reset();
     model.name = filename;
     
     for (const auto& mat : materials) {
@@ -184,16 +209,38 @@ bool OBJLoader::LoadModel(const std::string& filename, Model& model) {
         model.materials.push_back(defaultMat);
     }
     
-    if (!ProcessShapes(shapes, materials, attrib, model)) {
-        return false;
+    pool.ParallelFor(model.meshes.size(), [this, &model, &options, &pool](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            FinalizeMesh(model.meshes[i], options, pool);
+        }
+    });
+    if (options.optimizeMeshes) {
+        OptimizeMeshes(model, pool);
+    }
+    if (options.lodLevels > 0) {
+        GenerateLods(model, options.lodLevels, pool);
+    }
+    if (options.buildMeshlets) {
+        pool.ParallelFor(model.meshes.size(), [&model](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                MeshletBuilder::Build(model.meshes[i]);
+            }
+        });
+    }
+    model.CalculateBounds();
+    
+    if (useCache) {
+        MeshCache::Save(realPath, GetCacheFlags(options), model);
+    }
+    if (options.useArena) {
+        ModelArena::Pack(model);
     }
-    model.CalculateBounds();    
     return true;
 }
 
-bool OBJLoader::LoadModel(const std::string& filename, Model& model, const Material& material) {
-    ClearError();
-    
+bool OBJLoader::ParseTinyObj(const std::string& filename, const LoadOptions& options,
+                             std::vector<tinyobj::material_t>& materials,
+                             std::vector<Mesh>& meshes, std::string& error) const {
     std::string mtl_basedir;
     size_t lastSlash = filename.find_last_of("/\\");
     if (lastSlash != std::string::npos) {
@@ -202,52 +249,103 @@ bool OBJLoader::LoadModel(const std::string& filename, Model& model, const Mater
     
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
     std::string warn, err;
     
-    bool success = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str(), mtl_basedir.c_str());
+    std::string contents;
+    if (!VirtualFileSystem::GetDefault().ReadText(filename, contents)) {
+        error = "Failed to load OBJ file: Cannot open file [" + filename + "]";
+        return false;
+    }
+    std::istringstream stream(contents);
+    VirtualMaterialReader materialReader(mtl_basedir);
+    bool success = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream, &materialReader);
     
     if (!success) {
-        SetError("Failed to load OBJ file: " + err);
+        error = "Failed to load OBJ file: " + err;
         return false;
     }
     
-    model.meshes.clear();
-    model.materials.clear();
-    model.name = filename;
-    
-    model.materials.push_back(material);
+    if (!warn.empty()) {
+        std::cout << "Warning while loading " << filename << ": " << warn << std::endl;
+    }
     
-    if (!ProcessShapes(shapes, materials, attrib, model)) {
+    return ProcessShapes(shapes, materials, attrib, options, meshes);
+}
+
+bool OBJLoader::LoadModel(const std::string& filename, Model& model, const Material& material) {
+    if (!LoadModel(filename, model)) {
         return false;
     }
     
-    model.CalculateBounds();    
+    model.materials.clear();
+    model.materials.push_back(material);
     return true;
 }
 
 bool OBJLoader::LoadModels(const std::vector<std::string>& filenames, std::vector<Model>& models) {
+    ClearError();
     models.clear();
+    if (filenames.empty()) {
+        return true;
+    }
     models.reserve(filenames.size());
     
-    for (const auto& filename : filenames) {
-        Model model;
-        if (!LoadModel(filename, model)) {
-            SetError("Failed to load model: " + filename + " - " + GetLastError());
+    size_t threadCount = std::min<size_t>(filenames.size(), std::thread::hardware_concurrency());
+    ThreadPool pool(std::max<size_t>(threadCount, 1));
+    std::vector<LoadResult> results = LoadModelsParallel(filenames, pool);
+    
+    for (auto& result : results) {
+        if (!result.success) {
+            SetError("Failed to load model: " + result.filename + " - " + result.error);
+            models.clear();
             return false;
         }
-        models.push_back(std::move(model));
+        models.push_back(std::move(result.model));
     }
     
     return true;
 }
 
+std::vector<OBJLoader::LoadResult> OBJLoader::LoadModelsParallel(const std::vector<std::string>& filenames, ThreadPool& pool) {
+    LoadOptions options = GetOptions();
+    std::vector<LoadResult> results(filenames.size());
+    
+    pool.ParallelFor(filenames.size(), [this, &filenames, &results, &options, &pool](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            LoadResult& result = results[i];
+            result.filename = filenames[i];
+            result.success = LoadModelInternal(filenames[i], result.model, options, pool, result.error);
+            if (!result.success) {
+                std::cerr << "OBJLoader Error: " << filenames[i] << ": " << result.error << std::endl;
+            }
+        }
+    });
+    
+    return results;
+}
+
+std::future<OBJLoader::LoadResult> OBJLoader::LoadModelAsync(const std::string& filename, ThreadPool& pool) {
+    LoadOptions options = GetOptions();
+    
+    return pool.Submit([this, filename, options, &pool]() {
+        LoadResult result;
+        result.filename = filename;
+        result.success = LoadModelInternal(filename, result.model, options, pool, result.error);
+        if (!result.success) {
+            std::cerr << "OBJLoader Error: " << filename << ": " << result.error << std::endl;
+        }
+        return result;
+    });
+}
+
 bool OBJLoader::ProcessShapes(const std::vector<tinyobj::shape_t>& shapes,
                              const std::vector<tinyobj::material_t>& materials,
                              const tinyobj::attrib_t& attrib,
-                             Model& model) {
+                             const LoadOptions& options,
+                             std::vector<Mesh>& meshes) const {
+    meshes.reserve(shapes.size());
     for (const auto& shape : shapes) {
-        if (!ProcessShape(shape, materials, attrib, model)) {
+        if (!ProcessShape(shape, materials, attrib, options, meshes)) {
             return false;
         }
     }
@@ -258,7 +356,8 @@ bool OBJLoader::ProcessShapes(const std::vector<tinyobj::shape_t>& shapes,
 bool OBJLoader::ProcessShape(const tinyobj::shape_t& shape,
                             const std::vector<tinyobj::material_t>& materials,
                             const tinyobj::attrib_t& attrib,
-                            Model& model) {
+                            const LoadOptions& options,
+                            std::vector<Mesh>& meshes) const {
     Mesh mesh;
     mesh.name = shape.name;
     
@@ -271,6 +370,18 @@ bool OBJLoader::ProcessShape(const tinyobj::shape_t& shape,
         mesh.materialIndex = 0;
     }
     
+    MeshAttributes attributes;
+    attributes.positions = attrib.vertices.data();
+    attributes.positionCount = attrib.vertices.size() / 3;
+    attributes.normals = attrib.normals.data();
+    attributes.normalCount = attrib.normals.size() / 3;
+    attributes.texCoords = attrib.texcoords.data();
+    attributes.texCoordCount = attrib.texcoords.size() / 2;
+    attributes.flipUVs = options.flipUVs;
+    
+    MeshBuilder builder(mesh, attributes, options.weldMode);
+    builder.Reserve(shape.mesh.indices.size());
+    
     size_t index_offset = 0;
     for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++) {
         int fv = shape.mesh.num_face_vertices[f];
@@ -283,48 +394,93 @@ bool OBJLoader::ProcessShape(const tinyobj::shape_t& shape,
         
         for (int v = 0; v < fv; v++) {
             tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
-            
-            Vertex vertex;
-            vertex.position = GetVertexPosition(attrib, idx.vertex_index);
-            vertex.normal = GetVertexNormal(attrib, idx.normal_index);
-            vertex.texCoord = GetVertexTexCoord(attrib, idx.texcoord_index);
-            vertex.tangent = GetVertexTangent(attrib, idx.vertex_index);
-            
-            mesh.vertices.push_back(vertex);
+            builder.AddCorner(idx.vertex_index, idx.normal_index, idx.texcoord_index);
         }
         
-        size_t baseIndex = mesh.vertices.size() - 3;
-        mesh.indices.push_back(static_cast<unsigned int>(baseIndex));
-        mesh.indices.push_back(static_cast<unsigned int>(baseIndex + 1));
-        mesh.indices.push_back(static_cast<unsigned int>(baseIndex + 2));
-        
         index_offset += fv;
     }
     
-    if (m_generateNormals) {
-        bool hasNormals = false;
+    builder.Finish();
+    meshes.push_back(std::move(mesh));
+    
+    return true;
+}
+
+void OBJLoader::FinalizeMesh(Mesh& mesh, const LoadOptions& options, ThreadPool& pool) const {
+    bool generateNormals = false;
+    if (options.generateNormals) {
+        generateNormals = true;
         for (const auto& vertex : mesh.vertices) {
             if (glm::length(vertex.normal) > 0.0f) {
-                hasNormals = true;
+                generateNormals = false;
                 break;
             }
         }
-        
-        if (!hasNormals) {
+    }
+    
+    if (!generateNormals && !options.generateTangents) {
+        return;
+    }
+    
+    if (mesh.vertices.size() < PARALLEL_FINALIZE_THRESHOLD) {
+        if (generateNormals) {
             mesh.CalculateNormals();
         }
+        if (options.generateTangents) {
+            mesh.CalculateTangents();
+        }
+        return;
     }
     
-    if (m_generateTangents) {
-        mesh.CalculateTangents();
+    MeshTopology topology;
+    topology.Build(mesh);
+    if (generateNormals) {
+        topology.ComputeNormals(mesh.vertices.data(), pool);
     }
+    if (options.generateTangents) {
+        topology.ComputeTangents(mesh.vertices.data(), pool);
+    }
+}
+
+void OBJLoader::OptimizeMeshes(Model& model, ThreadPool& pool) const {
+    std::vector<MeshOptimizer::Stats> before(model.meshes.size());
+    std::vector<MeshOptimizer::Stats> after(model.meshes.size());
+    
+    pool.ParallelFor(model.meshes.size(), [&model, &before, &after](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            before[i] = MeshOptimizer::Analyze(model.meshes[i]);
+            MeshOptimizer::Optimize(model.meshes[i]);
+            after[i] = MeshOptimizer::Analyze(model.meshes[i]);
+        }
+    });
     
-    model.meshes.push_back(std::move(mesh));
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        std::cout << "Optimized mesh '" << model.meshes[i].name << "' (" << after[i].triangleCount << " triangles): "
+                  << "ACMR " << before[i].acmr << " -> " << after[i].acmr
+                  << ", ATVR " << before[i].atvr << " -> " << after[i].atvr << std::endl;
+    }
+}
+
+void OBJLoader::GenerateLods(Model& model, size_t levels, ThreadPool& pool) const {
+    pool.ParallelFor(model.meshes.size(), [&model, levels](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            MeshSimplifier::GenerateLods(model.meshes[i], levels);
+        }
+    });
     
-    return true;
+    for (const auto& mesh : model.meshes) {
+        if (mesh.lods.empty()) {
+            continue;
+        }
+        std::cout << "Generated " << mesh.lods.size() << " LODs for mesh '" << mesh.name << "': " << mesh.indices.size() / 3;
+        for (const auto& lod : mesh.lods) {
+            std::cout << " -> " << lod.indices.size() / 3 << " (error " << lod.error << ")";
+        }
+        std::cout << " triangles" << std::endl;
+    }
 }
 
-Material OBJLoader::ConvertMaterial(const tinyobj::material_t& mat) {
+Material OBJLoader::ConvertMaterial(const tinyobj::material_t& mat) const {
     Material material;
     
     material.name = mat.name;
@@ -348,55 +504,109 @@ Material OBJLoader::ConvertMaterial(const tinyobj::material_t& mat) {
     return material;
 }
 
-glm::vec3 OBJLoader::GetVertexPosition(const tinyobj::attrib_t& attrib, int index) {
-    if (index < 0 || index >= static_cast<int>(attrib.vertices.size() / 3)) {
-        return glm::vec3(0.0f);
-    }
-    
-    return glm::vec3(
-        attrib.vertices[3 * index + 0],
-        attrib.vertices[3 * index + 1],
-        attrib.vertices[3 * index + 2]
-    );
+std::string OBJLoader::GetLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
 }
 
-glm::vec3 OBJLoader::GetVertexNormal(const tinyobj::attrib_t& attrib, int index) {
-    if (index < 0 || index >= static_cast<int>(attrib.normals.size() / 3)) {
-        return glm::vec3(0.0f);
+void OBJLoader::ClearError() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastError.clear();
+}
+
+void OBJLoader::SetGenerateNormals(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.generateNormals = enable;
+}
+
+void OBJLoader::SetGenerateTangents(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.generateTangents = enable;
+}
+
+void OBJLoader::SetFlipUVs(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.flipUVs = enable;
+}
+
+void OBJLoader::SetUseCache(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.useCache = enable;
+}
+
+void OBJLoader::SetWeldMode(WeldMode mode) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.weldMode = mode;
+}
+
+void OBJLoader::SetParserBackend(ParserBackend backend) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.parserBackend = backend;
+}
+
+void OBJLoader::SetOptimizeMeshes(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.optimizeMeshes = enable;
+}
+
+void OBJLoader::SetLodLevels(size_t levels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.lodLevels = std::min(levels, MAX_LOD_LEVELS);
+}
+
+void OBJLoader::SetBuildMeshlets(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.buildMeshlets = enable;
+}
+
+void OBJLoader::SetUseArena(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options.useArena = enable;
+}
+
+OBJLoader::LoadOptions OBJLoader::GetOptions() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_options;
+}
+
+ThreadPool& OBJLoader::GetThreadPool() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_threadPool) {
+        m_threadPool = std::make_unique<ThreadPool>();
     }
-    
-    return glm::vec3(
-        attrib.normals[3 * index + 0],
-        attrib.normals[3 * index + 1],
-        attrib.normals[3 * index + 2]
-    );
+    return *m_threadPool;
 }
 
-glm::vec2 OBJLoader::GetVertexTexCoord(const tinyobj::attrib_t& attrib, int index) {
-    if (index < 0 || index >= static_cast<int>(attrib.texcoords.size() / 2)) {
-        return glm::vec2(0.0f);
+bool OBJLoader::UseFastParser(const std::string& filename, const LoadOptions& options) {
+    if (options.parserBackend != ParserBackend::Auto) {
+        return options.parserBackend == ParserBackend::Fast;
     }
     
-    glm::vec2 texCoord(
-        attrib.texcoords[2 * index + 0],
-        attrib.texcoords[2 * index + 1]
-    );
-    
-    if (m_flipUVs) {
-        texCoord.y = 1.0f - texCoord.y;
+    uint64_t size = 0;
+    if (!VirtualFileSystem::GetDefault().GetFileSize(filename, size)) {
+        return false;
     }
-    
-    return texCoord;
+    return size >= FAST_PARSER_THRESHOLD;
 }
 
-glm::vec3 OBJLoader::GetVertexTangent(const tinyobj::attrib_t& attrib, int index) {
-    if (index < 0 || index >= static_cast<int>(attrib.vertices.size() / 3)) {
-        return glm::vec3(0.0f);
-    }
-    return glm::vec3(0.0f);
+uint32_t OBJLoader::GetOptionFlags() const {
+    return GetCacheFlags(GetOptions());
+}
+
+uint32_t OBJLoader::GetCacheFlags(const LoadOptions& options) {
+    uint32_t flags = 0;
+    if (options.generateNormals) flags |= 1u << 0;
+    if (options.generateTangents) flags |= 1u << 1;
+    if (options.flipUVs) flags |= 1u << 2;
+    flags |= static_cast<uint32_t>(options.weldMode) << 3;
+    if (options.optimizeMeshes) flags |= 1u << 5;
+    flags |= static_cast<uint32_t>(options.lodLevels) << 6;
+    if (options.buildMeshlets) flags |= 1u << 10;
+    return flags;
 }
 
 void OBJLoader::SetError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_lastError = error;
     std::cerr << "OBJLoader Error: " << error << std::endl;
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <future>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace tinyobj {
@@ -40,15 +43,60 @@ struct Material {
                  shininess(32.0f), transparency(1.0f), refractiveIndex(1.0f) {}
 };
 
+struct MeshLod {
+    std::vector<unsigned int> indices;
+    const unsigned int* mappedIndices;
+    size_t mappedIndexCount;
+    float error;
+    
+    MeshLod() : mappedIndices(nullptr), mappedIndexCount(0), error(0.0f) {}
+    
+    const unsigned int* GetIndexData() const { return mappedIndices ? mappedIndices : indices.data(); }
+    size_t GetIndexCount() const { return mappedIndices ? mappedIndexCount : indices.size(); }
+};
+
+struct Meshlet {
+    unsigned int indexOffset;
+    unsigned int triangleCount;
+    unsigned int vertexCount;
+    float coneCutoff;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    
+    Meshlet() : indexOffset(0), triangleCount(0), vertexCount(0), coneCutoff(1.0f),
+                center(0.0f), radius(0.0f), coneAxis(0.0f, 0.0f, 1.0f) {}
+};
+
 struct Mesh {
     std::string name;
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
     int materialIndex;
     
-    Mesh() : materialIndex(-1) {}
+    const Vertex* mappedVertices;
+    const unsigned int* mappedIndices;
+    const Meshlet* mappedMeshlets;
+    size_t mappedVertexCount;
+    size_t mappedIndexCount;
+    size_t mappedMeshletCount;
+    std::shared_ptr<const void> mappedData;
+    
+    Mesh() : materialIndex(-1), mappedVertices(nullptr), mappedIndices(nullptr), mappedMeshlets(nullptr),
+             mappedVertexCount(0), mappedIndexCount(0), mappedMeshletCount(0) {}
+    
+    bool IsMapped() const { return mappedVertices != nullptr; }
+    const Vertex* GetVertexData() const { return mappedVertices ? mappedVertices : vertices.data(); }
+    size_t GetVertexCount() const { return mappedVertices ? mappedVertexCount : vertices.size(); }
+    const unsigned int* GetIndexData() const { return mappedIndices ? mappedIndices : indices.data(); }
+    size_t GetIndexCount() const { return mappedIndices ? mappedIndexCount : indices.size(); }
+    const Meshlet* GetMeshletData() const { return mappedMeshlets ? mappedMeshlets : meshlets.data(); }
+    size_t GetMeshletCount() const { return mappedMeshlets ? mappedMeshletCount : meshlets.size(); }
     
     void CalculateBounds(glm::vec3& min, glm::vec3& max) const;
+    void Materialize();
     void CalculateNormals();
     void CalculateTangents();
 };
@@ -59,6 +107,7 @@ struct Model {
     std::vector<Material> materials;
     glm::vec3 boundsMin;
     glm::vec3 boundsMax;
+    std::shared_ptr<const void> mappedData;
     
     Model() : boundsMin(0.0f), boundsMax(0.0f) {}
     
@@ -67,44 +116,105 @@ struct Model {
     size_t GetTotalIndexCount() const;
 };
 
+class ThreadPool;
+
 class OBJLoader {
 public:
+    static const size_t MAX_LOD_LEVELS = 15;
+
+    enum class WeldMode {
+        None,
+        Indices,
+        Exact
+    };
+
+    enum class ParserBackend {
+        TinyObj,
+        Fast,
+        Auto
+    };
+
+    struct LoadResult {
+        std::string filename;
+        Model model;
+        bool success;
+        std::string error;
+        
+        LoadResult() : success(false) {}
+    };
+
     OBJLoader();
     ~OBJLoader();
     
     bool LoadModel(const std::string& filename, Model& model);
     bool LoadModel(const std::string& filename, Model& model, const Material& material);
     bool LoadModels(const std::vector<std::string>& filenames, std::vector<Model>& models);
-    const std::string& GetLastError() const { return m_lastError; }
-    void ClearError() { m_lastError.clear(); }
+    std::vector<LoadResult> LoadModelsParallel(const std::vector<std::string>& filenames, ThreadPool& pool);
+    std::future<LoadResult> LoadModelAsync(const std::string& filename, ThreadPool& pool);
+    std::string GetLastError() const;
+    void ClearError();
     
-    void SetGenerateNormals(bool enable) { m_generateNormals = enable; }
-    void SetGenerateTangents(bool enable) { m_generateTangents = enable; }
-    void SetFlipUVs(bool enable) { m_flipUVs = enable; }
+    void SetGenerateNormals(bool enable);
+    void SetGenerateTangents(bool enable);
+    void SetFlipUVs(bool enable);
+    void SetUseCache(bool enable);
+    void SetWeldMode(WeldMode mode);
+    void SetParserBackend(ParserBackend backend);
+    void SetOptimizeMeshes(bool enable);
+    void SetLodLevels(size_t levels);
+    void SetBuildMeshlets(bool enable);
+    void SetUseArena(bool enable);
+    uint32_t GetOptionFlags() const;
     
 private:
+    struct LoadOptions {
+        bool generateNormals;
+        bool generateTangents;
+        bool flipUVs;
+        bool useCache;
+        bool optimizeMeshes;
+        size_t lodLevels;
+        bool buildMeshlets;
+        bool useArena;
+        WeldMode weldMode;
+        ParserBackend parserBackend;
+        
+        LoadOptions() : generateNormals(true), generateTangents(false), flipUVs(false),
+                        useCache(true), optimizeMeshes(false), lodLevels(0), buildMeshlets(false), useArena(false), weldMode(WeldMode::None), parserBackend(ParserBackend::Auto) {}
+    };
+    
+    LoadOptions GetOptions() const;
+    ThreadPool& GetThreadPool();
+    bool LoadModelInternal(const std::string& filename, Model& model, const LoadOptions& options,
+                           ThreadPool& pool, std::string& error) const;
+    
+    bool ParseTinyObj(const std::string& filename, const LoadOptions& options,
+                      std::vector<tinyobj::material_t>& materials,
+                      std::vector<Mesh>& meshes, std::string& error) const;
+    
     bool ProcessShapes(const std::vector<tinyobj::shape_t>& shapes,
                       const std::vector<tinyobj::material_t>& materials,
                       const tinyobj::attrib_t& attrib,
-                      Model& model);
+                      const LoadOptions& options,
+                      std::vector<Mesh>& meshes) const;
     
     bool ProcessShape(const tinyobj::shape_t& shape,
                      const std::vector<tinyobj::material_t>& materials,
                      const tinyobj::attrib_t& attrib,
-                     Model& model);
+                     const LoadOptions& options,
+                     std::vector<Mesh>& meshes) const;
     
-    Material ConvertMaterial(const tinyobj::material_t& mat);
-    
-    glm::vec3 GetVertexPosition(const tinyobj::attrib_t& attrib, int index);
-    glm::vec3 GetVertexNormal(const tinyobj::attrib_t& attrib, int index);
-    glm::vec2 GetVertexTexCoord(const tinyobj::attrib_t& attrib, int index);
-    glm::vec3 GetVertexTangent(const tinyobj::attrib_t& attrib, int index);
+    void FinalizeMesh(Mesh& mesh, const LoadOptions& options, ThreadPool& pool) const;
+    void OptimizeMeshes(Model& model, ThreadPool& pool) const;
+    void GenerateLods(Model& model, size_t levels, ThreadPool& pool) const;
+    Material ConvertMaterial(const tinyobj::material_t& mat) const;
     
     void SetError(const std::string& error);
+    static uint32_t GetCacheFlags(const LoadOptions& options);
+    static bool UseFastParser(const std::string& filename, const LoadOptions& options);
     
-    bool m_generateNormals;
-    bool m_generateTangents;
-    bool m_flipUVs;
-    
+    mutable std::mutex m_mutex;
+    LoadOptions m_options;
     std::string m_lastError;
+    std::unique_ptr<ThreadPool> m_threadPool;
 };
@@ -0,0 +1,715 @@
+#include "OBJParser.h"
+#include "MappedFile.h"
+#include "MeshBuilder.h"
+#include "ThreadPool.h"
+#include "VirtualFileSystem.h"
+#include "../../../external/tiny_obj_loader.h"
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const size_t MIN_CHUNK_SIZE = 1 << 20;
+const size_t FACE_BLOCK_SIZE = 1 << 16;
+
+const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline bool IsDelimiter(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && IsSpace(*p)) ++p;
+    return p;
+}
+
+inline const char* SkipDelimiters(const char* p, const char* end) {
+    while (p < end && IsDelimiter(*p)) ++p;
+    return p;
+}
+
+inline const char* SkipToken(const char* p, const char* end) {
+    while (p < end && !IsDelimiter(*p)) ++p;
+    return p;
+}
+
+inline const char* LineEnd(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+inline const char* TrimLine(const char* begin, const char* end) {
+    if (end > begin && end[-1] == '\r') --end;
+    return end;
+}
+
+bool TryParseDouble(const char* s, const char* end, double& result) {
+    const char* c = s;
+    bool negative = false;
+    if (c < end && (*c == '+' || *c == '-')) {
+        negative = *c == '-';
+        ++c;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    while (c < end && IsDigit(*c)) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+            if (mantissa) ++digits;
+        } else {
+            ++exponent;
+        }
+        any = true;
+        ++c;
+    }
+
+    if (c < end && *c == '.') {
+        ++c;
+        while (c < end && IsDigit(*c)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+                if (mantissa) ++digits;
+                --exponent;
+            }
+            any = true;
+            ++c;
+        }
+    }
+
+    if (!any) {
+        return false;
+    }
+
+    if (c < end && (*c == 'e' || *c == 'E')) {
+        ++c;
+        bool negativeExponent = false;
+        if (c < end && (*c == '+' || *c == '-')) {
+            negativeExponent = *c == '-';
+            ++c;
+        }
+        if (c >= end || !IsDigit(*c)) {
+            return false;
+        }
+        int value = 0;
+        while (c < end && IsDigit(*c)) {
+            if (value < 100000) {
+                value = value * 10 + (*c - '0');
+            }
+            ++c;
+        }
+        exponent += negativeExponent ? -value : value;
+    }
+
+    double number = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        number = exponent >= -22 ? number / POW10[-exponent] : number * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        number = exponent <= 22 ? number * POW10[exponent] : number * std::pow(10.0, exponent);
+    }
+
+    result = negative ? -number : number;
+    return true;
+}
+
+inline float ParseFloat(const char*& p, const char* end) {
+    p = SkipSpaces(p, end);
+    const char* tokenEnd = SkipToken(p, end);
+    double value = 0.0;
+    if (!TryParseDouble(p, tokenEnd, value)) {
+        value = 0.0;
+    }
+    p = tokenEnd;
+    return static_cast<float>(value);
+}
+
+inline int ParseIndex(const char* p, const char* end) {
+    while (p < end && (IsSpace(*p) || *p == '\r')) ++p;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+    int value = 0;
+    while (p < end && IsDigit(*p)) {
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    return negative ? -value : value;
+}
+
+inline const char* SkipIndex(const char* p, const char* end) {
+    while (p < end && *p != '/' && !IsDelimiter(*p)) ++p;
+    return p;
+}
+
+inline bool FixIndex(int index, size_t count, int& result, bool allowZero) {
+    if (index > 0) {
+        result = index - 1;
+        return true;
+    }
+    if (index == 0) {
+        result = -1;
+        return allowZero;
+    }
+    result = static_cast<int>(count) + index;
+    return result >= 0;
+}
+
+inline bool StartsWith(const char* p, const char* end, const char* prefix, size_t length) {
+    return static_cast<size_t>(end - p) >= length && std::memcmp(p, prefix, length) == 0;
+}
+
+inline bool HasSpaceAt(const char* p, const char* end, size_t offset) {
+    return p + offset < end && IsSpace(p[offset]);
+}
+
+}
+
+OBJParser::OBJParser(ThreadPool& pool)
+    : m_pool(pool)
+    , m_flipUVs(false) {
+}
+
+OBJParser::Result OBJParser::Parse(const std::string& filename, OBJLoader::WeldMode weldMode, bool flipUVs,
+                                   std::vector<tinyobj::material_t>& materials, std::vector<Mesh>& meshes, std::string& error) {
+    VirtualFileSystem& fileSystem = VirtualFileSystem::GetDefault();
+    MappedFile file;
+    std::vector<char> buffer;
+    const char* data = nullptr;
+    size_t size = 0;
+    std::string realPath;
+    if (fileSystem.ResolveLoosePath(filename, realPath)) {
+        if (file.Open(realPath)) {
+            data = reinterpret_cast<const char*>(file.GetData());
+            size = file.GetSize();
+        }
+    } else if (!fileSystem.GetArchiveView(filename, data, size) && fileSystem.ReadFile(filename, buffer)) {
+        data = buffer.data();
+        size = buffer.size();
+    }
+    if (!data || size == 0) {
+        error = "Cannot open file [" + filename + "]";
+        return Result::Failed;
+    }
+
+    m_baseDir.clear();
+    size_t lastSlash = filename.find_last_of("/\\");
+    if (lastSlash != std::string::npos) {
+        m_baseDir = filename.substr(0, lastSlash + 1);
+    }
+    m_flipUVs = flipUVs;
+    m_shapes.clear();
+    m_loadedLibraries.clear();
+    m_materialMap.clear();
+
+    SplitChunks(data, size);
+
+    m_pool.ParallelFor(m_chunks.size(), [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            CountChunk(m_chunks[i]);
+        }
+    });
+
+    size_t positionCount = 0, normalCount = 0, texCoordCount = 0, faceCount = 0, cornerCount = 0;
+    for (auto& chunk : m_chunks) {
+        if (chunk.maxFaceSize > 4) {
+            return Result::Unsupported;
+        }
+        chunk.positionBase = positionCount;
+        chunk.normalBase = normalCount;
+        chunk.texCoordBase = texCoordCount;
+        chunk.faceBase = faceCount;
+        chunk.cornerBase = cornerCount;
+        positionCount += chunk.positionCount;
+        normalCount += chunk.normalCount;
+        texCoordCount += chunk.texCoordCount;
+        faceCount += chunk.faceCount;
+        cornerCount += chunk.cornerCount;
+    }
+
+    m_positions.resize(positionCount * 3);
+    m_normals.resize(normalCount * 3);
+    m_texCoords.resize(texCoordCount * 2);
+    m_corners.resize(cornerCount);
+    m_faceOffsets.resize(faceCount + 1);
+    m_faceOffsets[faceCount] = cornerCount;
+
+    m_pool.ParallelFor(m_chunks.size(), [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ParseChunk(m_chunks[i]);
+        }
+    });
+
+    for (const auto& chunk : m_chunks) {
+        if (!chunk.error.empty()) {
+            error = chunk.error;
+            return Result::Failed;
+        }
+    }
+
+    if (!BuildShapes(materials, error)) {
+        return Result::Failed;
+    }
+
+    meshes.clear();
+    meshes.resize(m_shapes.size());
+    if (weldMode == OBJLoader::WeldMode::None) {
+        for (size_t i = 0; i < m_shapes.size(); ++i) {
+            BuildMesh(m_shapes[i], weldMode, materials.size(), meshes[i]);
+        }
+    } else {
+        m_pool.ParallelFor(m_shapes.size(), [this, weldMode, &materials, &meshes](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                BuildMesh(m_shapes[i], weldMode, materials.size(), meshes[i]);
+            }
+        });
+    }
+
+    m_chunks.clear();
+    std::vector<float>().swap(m_positions);
+    std::vector<float>().swap(m_normals);
+    std::vector<float>().swap(m_texCoords);
+    std::vector<Corner>().swap(m_corners);
+    std::vector<size_t>().swap(m_faceOffsets);
+    m_shapes.clear();
+    return Result::Success;
+}
+
+void OBJParser::SplitChunks(const char* data, size_t size) {
+    m_chunks.clear();
+
+    size_t maxChunks = (m_pool.GetThreadCount() + 1) * 4;
+    size_t chunkCount = std::max<size_t>(1, std::min(maxChunks, size / MIN_CHUNK_SIZE));
+    size_t chunkSize = size / chunkCount;
+
+    const char* end = data + size;
+    const char* begin = data;
+    for (size_t i = 0; i < chunkCount && begin < end; ++i) {
+        const char* chunkEnd = (i + 1 == chunkCount) ? end : std::max(begin, data + (i + 1) * chunkSize);
+        if (chunkEnd < end) {
+            chunkEnd = LineEnd(chunkEnd, end);
+            if (chunkEnd < end) ++chunkEnd;
+        }
+
+        Chunk chunk = {};
+        chunk.begin = begin;
+        chunk.end = chunkEnd;
+        m_chunks.push_back(chunk);
+        begin = chunkEnd;
+    }
+}
+
+void OBJParser::CountChunk(Chunk& chunk) const {
+    const char* p = chunk.begin;
+    while (p < chunk.end) {
+        const char* next = LineEnd(p, chunk.end);
+        const char* lineEnd = TrimLine(p, next);
+        const char* t = SkipSpaces(p, lineEnd);
+
+        if (t < lineEnd && t[0] == 'v') {
+            if (HasSpaceAt(t, lineEnd, 1)) {
+                ++chunk.positionCount;
+            } else if (t + 1 < lineEnd && t[1] == 'n' && HasSpaceAt(t, lineEnd, 2)) {
+                ++chunk.normalCount;
+            } else if (t + 1 < lineEnd && t[1] == 't' && HasSpaceAt(t, lineEnd, 2)) {
+                ++chunk.texCoordCount;
+            }
+        } else if (t < lineEnd && t[0] == 'f' && HasSpaceAt(t, lineEnd, 1)) {
+            size_t corners = 0;
+            const char* c = SkipSpaces(t + 2, lineEnd);
+            while (c < lineEnd) {
+                c = SkipToken(c, lineEnd);
+                ++corners;
+                c = SkipDelimiters(c, lineEnd);
+            }
+            ++chunk.faceCount;
+            chunk.cornerCount += corners;
+            chunk.maxFaceSize = std::max(chunk.maxFaceSize, corners);
+        }
+
+        p = next < chunk.end ? next + 1 : chunk.end;
+    }
+}
+
+bool OBJParser::ParseChunk(Chunk& chunk) {
+    size_t positions = chunk.positionBase;
+    size_t normals = chunk.normalBase;
+    size_t texCoords = chunk.texCoordBase;
+    size_t face = chunk.faceBase;
+    size_t corner = chunk.cornerBase;
+
+    const char* p = chunk.begin;
+    while (p < chunk.end) {
+        const char* next = LineEnd(p, chunk.end);
+        const char* lineEnd = TrimLine(p, next);
+        const char* t = SkipSpaces(p, lineEnd);
+        p = next < chunk.end ? next + 1 : chunk.end;
+
+        if (t >= lineEnd || t[0] == '#') {
+            continue;
+        }
+
+        if (t[0] == 'v' && HasSpaceAt(t, lineEnd, 1)) {
+            t += 2;
+            float* out = &m_positions[positions * 3];
+            out[0] = ParseFloat(t, lineEnd);
+            out[1] = ParseFloat(t, lineEnd);
+            out[2] = ParseFloat(t, lineEnd);
+            ++positions;
+            continue;
+        }
+
+        if (t[0] == 'v' && t + 1 < lineEnd && t[1] == 'n' && HasSpaceAt(t, lineEnd, 2)) {
+            t += 3;
+            float* out = &m_normals[normals * 3];
+            out[0] = ParseFloat(t, lineEnd);
+            out[1] = ParseFloat(t, lineEnd);
+            out[2] = ParseFloat(t, lineEnd);
+            ++normals;
+            continue;
+        }
+
+        if (t[0] == 'v' && t + 1 < lineEnd && t[1] == 't' && HasSpaceAt(t, lineEnd, 2)) {
+            t += 3;
+            float* out = &m_texCoords[texCoords * 2];
+            out[0] = ParseFloat(t, lineEnd);
+            out[1] = ParseFloat(t, lineEnd);
+            ++texCoords;
+            continue;
+        }
+
+        if (t[0] == 'f' && HasSpaceAt(t, lineEnd, 1)) {
+            m_faceOffsets[face++] = corner;
+            t = SkipSpaces(t + 2, lineEnd);
+            while (t < lineEnd) {
+                Corner& c = m_corners[corner++];
+                c.normalIndex = -1;
+                c.texCoordIndex = -1;
+
+                bool valid = FixIndex(ParseIndex(t, lineEnd), positions, c.positionIndex, false);
+                t = SkipIndex(t, lineEnd);
+                if (valid && t < lineEnd && *t == '/') {
+                    ++t;
+                    if (t < lineEnd && *t == '/') {
+                        ++t;
+                        valid = FixIndex(ParseIndex(t, lineEnd), normals, c.normalIndex, true);
+                        t = SkipIndex(t, lineEnd);
+                    } else {
+                        valid = FixIndex(ParseIndex(t, lineEnd), texCoords, c.texCoordIndex, true);
+                        t = SkipIndex(t, lineEnd);
+                        if (valid && t < lineEnd && *t == '/') {
+                            ++t;
+                            valid = FixIndex(ParseIndex(t, lineEnd), normals, c.normalIndex, true);
+                            t = SkipIndex(t, lineEnd);
+                        }
+                    }
+                }
+
+                if (!valid) {
+                    chunk.error = "Failed to parse `f' line (e.g. a zero value for vertex index "
+                                  "or invalid relative vertex index).";
+                    return false;
+                }
+
+                t = SkipToken(t, lineEnd);
+                t = SkipDelimiters(t, lineEnd);
+            }
+            continue;
+        }
+
+        if (StartsWith(t, lineEnd, "usemtl", 6)) {
+            const char* name = SkipSpaces(t + 6, lineEnd);
+            chunk.events.push_back({ Event::Kind::UseMaterial, face, std::string(name, SkipToken(name, lineEnd)) });
+            continue;
+        }
+
+        if (StartsWith(t, lineEnd, "mtllib", 6) && HasSpaceAt(t, lineEnd, 6)) {
+            chunk.events.push_back({ Event::Kind::MaterialLibrary, face, std::string(t + 7, lineEnd) });
+            continue;
+        }
+
+        if (t[0] == 'g' && HasSpaceAt(t, lineEnd, 1)) {
+            std::string name;
+            const char* n = SkipDelimiters(t + 1, lineEnd);
+            while (n < lineEnd) {
+                const char* nameEnd = SkipToken(n, lineEnd);
+                if (!name.empty()) name += ' ';
+                name.append(n, nameEnd);
+                n = SkipDelimiters(nameEnd, lineEnd);
+            }
+            chunk.events.push_back({ Event::Kind::Group, face, name });
+            continue;
+        }
+
+        if (t[0] == 'o' && HasSpaceAt(t, lineEnd, 1)) {
+            chunk.events.push_back({ Event::Kind::Object, face, std::string(t + 2, lineEnd) });
+            continue;
+        }
+    }
+
+    return true;
+}
+
+bool OBJParser::LoadMaterialLibrary(const std::string& value, std::vector<tinyobj::material_t>& materials, std::string& error) {
+    std::vector<std::string> filenames;
+    size_t start = 0;
+    while (start < value.size()) {
+        size_t end = value.find(' ', start);
+        if (end == std::string::npos) end = value.size();
+        if (end > start) {
+            filenames.push_back(value.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+
+    std::vector<std::string> names;
+    std::vector<VirtualFileSystem::ReadRequest> requests;
+    for (const auto& name : filenames) {
+        if (std::find(m_loadedLibraries.begin(), m_loadedLibraries.end(), name) == m_loadedLibraries.end()) {
+            names.push_back(name);
+            requests.emplace_back(m_baseDir + name);
+        }
+    }
+    VirtualFileSystem::GetDefault().ReadFiles(requests);
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!requests[i].success) {
+            continue;
+        }
+        std::istringstream stream(std::string(requests[i].data.begin(), requests[i].data.end()));
+
+        std::string warn, err;
+        tinyobj::LoadMtl(&m_materialMap, &materials, &stream, &warn, &err);
+        if (!err.empty()) {
+            error += err;
+        }
+        m_loadedLibraries.push_back(names[i]);
+        break;
+    }
+
+    return true;
+}
+
+bool OBJParser::BuildShapes(std::vector<tinyobj::material_t>& materials, std::string& error) {
+    std::string name;
+    int material = -1;
+    size_t groupStart = 0;
+    Shape shape;
+    shape.triangleCount = 0;
+
+    auto exportGroup = [&](size_t cursor) {
+        if (cursor == groupStart) {
+            return false;
+        }
+        Segment segment = { groupStart, cursor, material };
+        shape.name = name;
+        shape.triangleCount += CountSegmentTriangles(segment);
+        shape.segments.push_back(segment);
+        groupStart = cursor;
+        return true;
+    };
+
+    auto flushShape = [&]() {
+        if (shape.triangleCount > 0) {
+            m_shapes.push_back(std::move(shape));
+        }
+        shape = Shape();
+        shape.triangleCount = 0;
+    };
+
+    for (const auto& chunk : m_chunks) {
+        for (const auto& event : chunk.events) {
+            switch (event.kind) {
+                case Event::Kind::UseMaterial: {
+                    auto it = m_materialMap.find(event.value);
+                    int newMaterial = it != m_materialMap.end() ? it->second : -1;
+                    if (newMaterial != material) {
+                        exportGroup(event.faceIndex);
+                        groupStart = event.faceIndex;
+                        material = newMaterial;
+                    }
+                    break;
+                }
+                case Event::Kind::MaterialLibrary:
+                    if (!LoadMaterialLibrary(event.value, materials, error)) {
+                        return false;
+                    }
+                    break;
+                case Event::Kind::Group:
+                case Event::Kind::Object:
+                    exportGroup(event.faceIndex);
+                    flushShape();
+                    groupStart = event.faceIndex;
+                    name = event.value;
+                    break;
+            }
+        }
+    }
+
+    size_t faceCount = m_faceOffsets.size() - 1;
+    if (exportGroup(faceCount) || shape.triangleCount > 0) {
+        m_shapes.push_back(std::move(shape));
+    }
+
+    return true;
+}
+
+size_t OBJParser::CountSegmentTriangles(const Segment& segment) const {
+    size_t triangles = 0;
+    Corner scratch[6];
+    for (size_t face = segment.faceBegin; face < segment.faceEnd; ++face) {
+        size_t corners = m_faceOffsets[face + 1] - m_faceOffsets[face];
+        if (corners == 3) {
+            ++triangles;
+        } else if (corners == 4) {
+            triangles += TriangulateFace(face, scratch) / 3;
+        }
+    }
+    return triangles;
+}
+
+size_t OBJParser::TriangulateFace(size_t face, Corner* out) const {
+    const Corner* corners = &m_corners[m_faceOffsets[face]];
+    size_t count = m_faceOffsets[face + 1] - m_faceOffsets[face];
+
+    if (count == 3) {
+        out[0] = corners[0];
+        out[1] = corners[1];
+        out[2] = corners[2];
+        return 3;
+    }
+
+    if (count != 4) {
+        return 0;
+    }
+
+    const float* p[4];
+    for (int i = 0; i < 4; ++i) {
+        size_t index = static_cast<size_t>(corners[i].positionIndex);
+        if (3 * index + 2 >= m_positions.size()) {
+            return 0;
+        }
+        p[i] = &m_positions[3 * index];
+    }
+
+    float e02x = p[2][0] - p[0][0];
+    float e02y = p[2][1] - p[0][1];
+    float e02z = p[2][2] - p[0][2];
+    float e13x = p[3][0] - p[1][0];
+    float e13y = p[3][1] - p[1][1];
+    float e13z = p[3][2] - p[1][2];
+    float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+    float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+
+    if (sqr02 < sqr13) {
+        out[0] = corners[0]; out[1] = corners[1]; out[2] = corners[2];
+        out[3] = corners[0]; out[4] = corners[2]; out[5] = corners[3];
+    } else {
+        out[0] = corners[0]; out[1] = corners[1]; out[2] = corners[3];
+        out[3] = corners[1]; out[4] = corners[2]; out[5] = corners[3];
+    }
+    return 6;
+}
+
+void OBJParser::BuildMesh(const Shape& shape, OBJLoader::WeldMode weldMode, size_t materialCount, Mesh& mesh) {
+    mesh.name = shape.name;
+    mesh.materialIndex = 0;
+    if (materialCount > 0) {
+        for (const auto& segment : shape.segments) {
+            if (CountSegmentTriangles(segment) > 0) {
+                if (segment.materialId >= 0 && segment.materialId < static_cast<int>(materialCount)) {
+                    mesh.materialIndex = segment.materialId;
+                }
+                break;
+            }
+        }
+    }
+
+    MeshAttributes attributes;
+    attributes.positions = m_positions.data();
+    attributes.positionCount = m_positions.size() / 3;
+    attributes.normals = m_normals.data();
+    attributes.normalCount = m_normals.size() / 3;
+    attributes.texCoords = m_texCoords.data();
+    attributes.texCoordCount = m_texCoords.size() / 2;
+    attributes.flipUVs = m_flipUVs;
+
+    if (weldMode != OBJLoader::WeldMode::None) {
+        MeshBuilder builder(mesh, attributes, weldMode);
+        builder.Reserve(shape.triangleCount * 3);
+        Corner triangles[6];
+        for (const auto& segment : shape.segments) {
+            for (size_t face = segment.faceBegin; face < segment.faceEnd; ++face) {
+                size_t count = TriangulateFace(face, triangles);
+                for (size_t k = 0; k < count; ++k) {
+                    builder.AddCorner(triangles[k].positionIndex, triangles[k].normalIndex, triangles[k].texCoordIndex);
+                }
+            }
+        }
+        builder.Finish();
+        return;
+    }
+
+    struct Block {
+        size_t faceBegin;
+        size_t faceEnd;
+        size_t firstCorner;
+    };
+
+    std::vector<Block> blocks;
+    for (const auto& segment : shape.segments) {
+        for (size_t face = segment.faceBegin; face < segment.faceEnd; face += FACE_BLOCK_SIZE) {
+            blocks.push_back({ face, std::min(segment.faceEnd, face + FACE_BLOCK_SIZE), 0 });
+        }
+    }
+
+    std::vector<size_t> blockCorners(blocks.size());
+    m_pool.ParallelFor(blocks.size(), [this, &blocks, &blockCorners](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Segment range = { blocks[i].faceBegin, blocks[i].faceEnd, -1 };
+            blockCorners[i] = CountSegmentTriangles(range) * 3;
+        }
+    });
+
+    size_t cornerCount = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i].firstCorner = cornerCount;
+        cornerCount += blockCorners[i];
+    }
+
+    mesh.vertices.resize(cornerCount);
+    mesh.indices.resize(cornerCount);
+    std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+
+    m_pool.ParallelFor(blocks.size(), [this, &blocks, &attributes, &mesh](size_t begin, size_t end) {
+        Corner triangles[6];
+        for (size_t i = begin; i < end; ++i) {
+            Vertex* out = mesh.vertices.data() + blocks[i].firstCorner;
+            for (size_t face = blocks[i].faceBegin; face < blocks[i].faceEnd; ++face) {
+                size_t count = TriangulateFace(face, triangles);
+                for (size_t k = 0; k < count; ++k) {
+                    *out++ = MeshBuilder::MakeVertex(attributes, triangles[k].positionIndex,
+                                                     triangles[k].normalIndex, triangles[k].texCoordIndex);
+                }
+            }
+        }
+    });
+}
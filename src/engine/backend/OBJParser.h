@@ -0,0 +1,95 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include <string>
+#include <vector>
+#include <map>
+
+class ThreadPool;
+
+class OBJParser {
+public:
+    enum class Result {
+        Success,
+        Unsupported,
+        Failed
+    };
+
+    explicit OBJParser(ThreadPool& pool);
+
+    Result Parse(const std::string& filename, OBJLoader::WeldMode weldMode, bool flipUVs,
+                 std::vector<tinyobj::material_t>& materials, std::vector<Mesh>& meshes, std::string& error);
+
+private:
+    struct Corner {
+        int positionIndex;
+        int normalIndex;
+        int texCoordIndex;
+    };
+
+    struct Event {
+        enum class Kind {
+            UseMaterial,
+            MaterialLibrary,
+            Group,
+            Object
+        };
+
+        Kind kind;
+        size_t faceIndex;
+        std::string value;
+    };
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        size_t positionCount;
+        size_t normalCount;
+        size_t texCoordCount;
+        size_t faceCount;
+        size_t cornerCount;
+        size_t positionBase;
+        size_t normalBase;
+        size_t texCoordBase;
+        size_t faceBase;
+        size_t cornerBase;
+        size_t maxFaceSize;
+        std::vector<Event> events;
+        std::string error;
+    };
+
+    struct Segment {
+        size_t faceBegin;
+        size_t faceEnd;
+        int materialId;
+    };
+
+    struct Shape {
+        std::string name;
+        std::vector<Segment> segments;
+        size_t triangleCount;
+    };
+
+    void SplitChunks(const char* data, size_t size);
+    void CountChunk(Chunk& chunk) const;
+    bool ParseChunk(Chunk& chunk);
+    bool LoadMaterialLibrary(const std::string& value, std::vector<tinyobj::material_t>& materials, std::string& error);
+    bool BuildShapes(std::vector<tinyobj::material_t>& materials, std::string& error);
+    size_t CountSegmentTriangles(const Segment& segment) const;
+    size_t TriangulateFace(size_t face, Corner* out) const;
+    void BuildMesh(const Shape& shape, OBJLoader::WeldMode weldMode, size_t materialCount, Mesh& mesh);
+
+    ThreadPool& m_pool;
+    std::string m_baseDir;
+    bool m_flipUVs;
+
+    std::vector<Chunk> m_chunks;
+    std::vector<float> m_positions;
+    std::vector<float> m_normals;
+    std::vector<float> m_texCoords;
+    std::vector<Corner> m_corners;
+    std::vector<size_t> m_faceOffsets;
+    std::vector<Shape> m_shapes;
+    std::vector<std::string> m_loadedLibraries;
+    std::map<std::string, int> m_materialMap;
+};
@@ -0,0 +1,347 @@
+#include "PackArchive.h"
+#include "LZ4.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+const uint32_t PackArchive::ARCHIVE_VERSION = 1;
+
+namespace {
+
+const char ARCHIVE_MAGIC[4] = { 'P', 'F', 'P', 'K' };
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t tocOffset;
+    uint64_t tocSize;
+};
+
+struct TocEntry {
+    uint64_t offset;
+    uint64_t storedSize;
+    uint64_t size;
+    uint32_t flags;
+    uint32_t pathLength;
+};
+
+bool ReadWholeFile(const std::string& path, std::vector<char>& data) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return !stream.bad();
+}
+
+}
+
+PackArchive::PackArchive() : m_totalSize(0) {
+}
+
+bool PackArchive::Open(const std::string& archivePath) {
+    Close();
+    if (!m_file.Open(archivePath)) {
+        return false;
+    }
+
+    const unsigned char* data = m_file.GetData();
+    size_t size = m_file.GetSize();
+    ArchiveHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "PackArchive: truncated header in " << archivePath << std::endl;
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != ARCHIVE_VERSION) {
+        std::cerr << "PackArchive: " << archivePath << " is not a version " << ARCHIVE_VERSION << " archive" << std::endl;
+        Close();
+        return false;
+    }
+    if (header.tocOffset > size || header.tocSize > size - header.tocOffset) {
+        std::cerr << "PackArchive: table of contents out of range in " << archivePath << std::endl;
+        Close();
+        return false;
+    }
+
+    size_t cursor = static_cast<size_t>(header.tocOffset);
+    size_t tocEnd = cursor + static_cast<size_t>(header.tocSize);
+    m_entries.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        TocEntry toc;
+        if (tocEnd - cursor < sizeof(toc)) {
+            break;
+        }
+        std::memcpy(&toc, data + cursor, sizeof(toc));
+        cursor += sizeof(toc);
+        if (tocEnd - cursor < toc.pathLength || toc.offset > size || toc.storedSize > size - toc.offset) {
+            break;
+        }
+
+        Entry entry;
+        entry.path.assign(reinterpret_cast<const char*>(data + cursor), toc.pathLength);
+        entry.offset = toc.offset;
+        entry.storedSize = toc.storedSize;
+        entry.size = toc.size;
+        entry.flags = toc.flags;
+        cursor += toc.pathLength;
+
+        m_lookup[entry.path] = m_entries.size();
+        m_totalSize += entry.size;
+        m_entries.push_back(std::move(entry));
+    }
+
+    if (m_entries.size() != header.entryCount) {
+        std::cerr << "PackArchive: corrupt table of contents in " << archivePath << std::endl;
+        Close();
+        return false;
+    }
+
+    m_path = archivePath;
+    return true;
+}
+
+void PackArchive::Close() {
+    m_file.Close();
+    m_path.clear();
+    m_entries.clear();
+    m_lookup.clear();
+    m_totalSize = 0;
+}
+
+const PackArchive::Entry* PackArchive::Find(const std::string& path) const {
+    auto it = m_lookup.find(path);
+    return it != m_lookup.end() ? &m_entries[it->second] : nullptr;
+}
+
+bool PackArchive::GetView(const Entry& entry, const char*& data, size_t& size) const {
+    if (!IsOpen() || entry.IsCompressed()) {
+        return false;
+    }
+    data = reinterpret_cast<const char*>(m_file.GetData() + entry.offset);
+    size = static_cast<size_t>(entry.size);
+    return true;
+}
+
+bool PackArchive::Read(const Entry& entry, std::vector<char>& data) const {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    const char* stored = reinterpret_cast<const char*>(m_file.GetData() + entry.offset);
+    data.resize(static_cast<size_t>(entry.size));
+    if (!entry.IsCompressed()) {
+        std::memcpy(data.data(), stored, data.size());
+        return true;
+    }
+
+    if (!LZ4::Decompress(stored, static_cast<size_t>(entry.storedSize), data.data(), data.size())) {
+        std::cerr << "PackArchive: failed to decompress " << entry.path << std::endl;
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PackArchive::Write(const std::string& archivePath, const std::string& sourceDirectory, const WriteOptions& options) {
+    std::vector<std::string> files;
+    if (!ListFiles(sourceDirectory, files)) {
+        std::cerr << "PackArchive: cannot read directory " << sourceDirectory << std::endl;
+        return false;
+    }
+
+    std::string tempPath = archivePath + ".tmp";
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        std::cerr << "PackArchive: cannot create " << tempPath << std::endl;
+        return false;
+    }
+
+    ArchiveHeader header;
+    std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = 0;
+    header.alignment = static_cast<uint32_t>(DATA_ALIGNMENT);
+    header.tocOffset = 0;
+    header.tocSize = 0;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    static const char zeros[DATA_ALIGNMENT] = {};
+    uint64_t offset = sizeof(header);
+    uint64_t totalSize = 0;
+    uint64_t totalStored = 0;
+    std::vector<Entry> entries;
+    std::vector<char> contents;
+    std::vector<char> compressed;
+
+    for (const auto& file : files) {
+        if (!ReadWholeFile(file, contents)) {
+            std::cerr << "PackArchive: cannot read " << file << std::endl;
+            continue;
+        }
+
+        Entry entry;
+        entry.path = NormalizePath(file);
+        entry.size = contents.size();
+        entry.flags = 0;
+
+        const char* payload = contents.data();
+        size_t payloadSize = contents.size();
+        if (options.compress && !contents.empty()) {
+            compressed.resize(LZ4::GetMaxCompressedSize(contents.size()));
+            size_t compressedSize = LZ4::Compress(contents.data(), contents.size(), compressed.data(), compressed.size());
+            if (compressedSize > 0 && compressedSize < contents.size() * options.minCompressionRatio) {
+                payload = compressed.data();
+                payloadSize = compressedSize;
+                entry.flags |= ENTRY_COMPRESSED_LZ4;
+            }
+        }
+
+        size_t padding = static_cast<size_t>((DATA_ALIGNMENT - offset % DATA_ALIGNMENT) % DATA_ALIGNMENT);
+        stream.write(zeros, static_cast<std::streamsize>(padding));
+        offset += padding;
+
+        entry.offset = offset;
+        entry.storedSize = payloadSize;
+        stream.write(payload, static_cast<std::streamsize>(payloadSize));
+        offset += payloadSize;
+
+        totalSize += entry.size;
+        totalStored += entry.storedSize;
+        entries.push_back(std::move(entry));
+    }
+
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.tocOffset = offset;
+    for (const auto& entry : entries) {
+        TocEntry toc;
+        toc.offset = entry.offset;
+        toc.storedSize = entry.storedSize;
+        toc.size = entry.size;
+        toc.flags = entry.flags;
+        toc.pathLength = static_cast<uint32_t>(entry.path.size());
+        stream.write(reinterpret_cast<const char*>(&toc), sizeof(toc));
+        stream.write(entry.path.data(), static_cast<std::streamsize>(entry.path.size()));
+        header.tocSize += sizeof(toc) + entry.path.size();
+    }
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.close();
+    if (!stream) {
+        std::cerr << "PackArchive: failed to write " << tempPath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::remove(archivePath.c_str());
+    if (std::rename(tempPath.c_str(), archivePath.c_str()) != 0) {
+        std::cerr << "PackArchive: failed to move " << tempPath << " to " << archivePath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::cout << "Packed " << entries.size() << " files from " << sourceDirectory << " into " << archivePath
+              << " (" << totalSize / 1024 << " KB -> " << totalStored / 1024 << " KB stored)" << std::endl;
+    return true;
+}
+
+bool PackArchive::ListFiles(const std::string& directory, std::vector<std::string>& files) {
+    std::vector<std::string> pending(1, directory);
+    while (!pending.empty()) {
+        std::string current = pending.back();
+        pending.pop_back();
+
+#ifdef _WIN32
+        WIN32_FIND_DATAA findData;
+        HANDLE handle = FindFirstFileA((current + "\\*").c_str(), &findData);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        do {
+            std::string name = findData.cFileName;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            std::string path = current + "/" + name;
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                pending.push_back(path);
+            } else {
+                files.push_back(path);
+            }
+        } while (FindNextFileA(handle, &findData));
+        FindClose(handle);
+#else
+        DIR* dir = opendir(current.c_str());
+        if (!dir) {
+            return false;
+        }
+        while (struct dirent* item = readdir(dir)) {
+            std::string name = item->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            std::string path = current + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) {
+                continue;
+            }
+            if (S_ISDIR(st.st_mode)) {
+                pending.push_back(path);
+            } else if (S_ISREG(st.st_mode)) {
+                files.push_back(path);
+            }
+        }
+        closedir(dir);
+#endif
+    }
+
+    std::sort(files.begin(), files.end());
+    return true;
+}
+
+std::string PackArchive::NormalizePath(const std::string& path) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        std::string part = path.substr(start, end - start);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") {
+                parts.pop_back();
+            } else {
+                parts.push_back(part);
+            }
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+
+    std::string result;
+    for (const auto& part : parts) {
+        if (!result.empty()) {
+            result += '/';
+        }
+        result += part;
+    }
+    return result;
+}
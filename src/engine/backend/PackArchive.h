@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class PackArchive {
+public:
+    static const uint32_t ARCHIVE_VERSION;
+    static const size_t DATA_ALIGNMENT = 64;
+
+    enum EntryFlags : uint32_t {
+        ENTRY_COMPRESSED_LZ4 = 1u << 0
+    };
+
+    struct Entry {
+        std::string path;
+        uint64_t offset;
+        uint64_t storedSize;
+        uint64_t size;
+        uint32_t flags;
+
+        bool IsCompressed() const { return (flags & ENTRY_COMPRESSED_LZ4) != 0; }
+    };
+
+    struct WriteOptions {
+        bool compress;
+        float minCompressionRatio;
+
+        WriteOptions() : compress(true), minCompressionRatio(0.9f) {}
+    };
+
+    PackArchive();
+
+    bool Open(const std::string& archivePath);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    const Entry* Find(const std::string& path) const;
+    bool Read(const Entry& entry, std::vector<char>& data) const;
+    bool GetView(const Entry& entry, const char*& data, size_t& size) const;
+
+    const std::string& GetPath() const { return m_path; }
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+    uint64_t GetTotalSize() const { return m_totalSize; }
+
+    static bool Write(const std::string& archivePath, const std::string& sourceDirectory,
+                      const WriteOptions& options = WriteOptions());
+    static bool ListFiles(const std::string& directory, std::vector<std::string>& files);
+    static std::string NormalizePath(const std::string& path);
+
+private:
+    MappedFile m_file;
+    std::string m_path;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_lookup;
+    uint64_t m_totalSize;
+};
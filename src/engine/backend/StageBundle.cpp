@@ -0,0 +1,998 @@
+#include "StageBundle.h"
+#include "MappedFile.h"
+#include "MeshletBuilder.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+const uint32_t StageBundle::BUNDLE_VERSION = 2;
+const std::string StageBundle::BUNDLE_EXTENSION = ".pfstage";
+
+namespace {
+
+const char BUNDLE_MAGIC[4] = { 'P', 'F', 'S', 'T' };
+const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t HASH_PRIME = 1099511628211ull;
+const char* const COLLISION_PREFIXES[] = { "collision", "col_" };
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct BundleHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t contentHash;
+    uint32_t vertexSize;
+    uint32_t loaderFlags;
+    uint32_t spawnCount;
+    uint32_t variantCount;
+    StringRef name;
+    StringRef description;
+    uint64_t spawnOffset;
+    uint64_t variantOffset;
+    uint64_t stringOffset;
+    uint64_t stringSize;
+    uint64_t fileSize;
+};
+
+struct SpawnRecord {
+    StringRef name;
+    float position[3];
+    float rotation[3];
+};
+
+struct VariantRecord {
+    StringRef source;
+    uint32_t present;
+    uint32_t meshCount;
+    uint32_t materialCount;
+    uint32_t collisionVertexCount;
+    uint32_t collisionIndexCount;
+    uint32_t cellCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    float collisionMin[3];
+    float collisionMax[3];
+    uint64_t meshOffset;
+    uint64_t materialOffset;
+    uint64_t collisionVertexOffset;
+    uint64_t collisionIndexOffset;
+    uint64_t cellOffset;
+};
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
+
+template<typename T>
+uint64_t HashValue(uint64_t hash, const T& value) {
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+uint64_t HashString(uint64_t hash, const std::string& value) {
+    hash = HashValue(hash, static_cast<uint64_t>(value.size()));
+    return HashBytes(hash, value.data(), value.size());
+}
+
+void CopyVec3(const glm::vec3& value, float* out) {
+    out[0] = value.x;
+    out[1] = value.y;
+    out[2] = value.z;
+}
+
+glm::vec3 ToVec3(const float* value) {
+    return glm::vec3(value[0], value[1], value[2]);
+}
+
+bool IndicesInRange(const unsigned int* indices, uint64_t indexCount, uint64_t vertexCount) {
+    for (uint64_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FindMaterialLibraries(const std::vector<char>& source, std::vector<std::string>& libraries) {
+    const char* cursor = source.data();
+    const char* end = cursor + source.size();
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        if (lineEnd - cursor > 7 && std::strncmp(cursor, "mtllib", 6) == 0 && (cursor[6] == ' ' || cursor[6] == '\t')) {
+            std::string names(cursor + 7, lineEnd);
+            size_t start = 0;
+            while (start < names.size()) {
+                size_t stop = names.find_first_of(" \t\r", start);
+                if (stop == std::string::npos) {
+                    stop = names.size();
+                }
+                if (stop > start) {
+                    libraries.push_back(names.substr(start, stop - start));
+                }
+                start = stop + 1;
+            }
+        }
+        cursor = lineEnd + 1;
+    }
+}
+
+struct PositionKey {
+    uint32_t bits[3];
+
+    bool operator==(const PositionKey& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const {
+        uint64_t hash = HASH_OFFSET_BASIS;
+        hash = HashValue(hash, key.bits);
+        return static_cast<size_t>(hash);
+    }
+};
+
+void ExtractCollision(const Model& model, const std::vector<bool>& useMesh, std::vector<glm::vec3>& vertices,
+                      std::vector<unsigned int>& indices, glm::vec3& boundsMin, glm::vec3& boundsMax) {
+    std::unordered_map<PositionKey, unsigned int, PositionKeyHash> welded;
+    boundsMin = glm::vec3(FLT_MAX);
+    boundsMax = glm::vec3(-FLT_MAX);
+
+    for (size_t m = 0; m < model.meshes.size(); ++m) {
+        if (!useMesh[m]) {
+            continue;
+        }
+        const Mesh& mesh = model.meshes[m];
+        const Vertex* meshVertices = mesh.GetVertexData();
+        const unsigned int* meshIndices = mesh.GetIndexData();
+        size_t indexCount = mesh.GetIndexCount() - mesh.GetIndexCount() % 3;
+
+        for (size_t i = 0; i < indexCount; i += 3) {
+            unsigned int triangle[3];
+            for (size_t corner = 0; corner < 3; ++corner) {
+                const glm::vec3& position = meshVertices[meshIndices[i + corner]].position;
+                PositionKey key;
+                std::memcpy(key.bits, &position.x, sizeof(key.bits));
+                auto inserted = welded.emplace(key, static_cast<unsigned int>(vertices.size()));
+                if (inserted.second) {
+                    vertices.push_back(position);
+                    boundsMin = glm::min(boundsMin, position);
+                    boundsMax = glm::max(boundsMax, position);
+                }
+                triangle[corner] = inserted.first->second;
+            }
+
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+                continue;
+            }
+            glm::vec3 normal = glm::cross(vertices[triangle[1]] - vertices[triangle[0]], vertices[triangle[2]] - vertices[triangle[0]]);
+            if (glm::dot(normal, normal) <= 0.0f) {
+                continue;
+            }
+            indices.insert(indices.end(), triangle, triangle + 3);
+        }
+    }
+
+    if (vertices.empty()) {
+        boundsMin = boundsMax = glm::vec3(0.0f);
+    }
+}
+
+struct CellBuild {
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    size_t triangleCount;
+    std::vector<Mesh> meshes;
+
+    CellBuild() : boundsMin(FLT_MAX), boundsMax(-FLT_MAX), triangleCount(0) {}
+};
+
+void SplitIntoCells(const Model& model, std::vector<CellBuild>& cells) {
+    size_t totalTriangles = 0;
+    for (const auto& mesh : model.meshes) {
+        totalTriangles += mesh.GetIndexCount() / 3;
+    }
+
+    size_t targetCells = (totalTriangles + StageBundle::CELL_TARGET_TRIANGLES - 1) / StageBundle::CELL_TARGET_TRIANGLES;
+    glm::vec3 extent = glm::max(model.boundsMax - model.boundsMin, glm::vec3(1e-4f));
+    size_t columns = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(targetCells) * extent.x / extent.z) + 0.5));
+    size_t rows = std::max<size_t>(1, (targetCells + columns - 1) / columns);
+    float cellWidth = extent.x / static_cast<float>(columns);
+    float cellDepth = extent.z / static_cast<float>(rows);
+
+    std::vector<CellBuild> grid(columns * rows);
+    std::vector<unsigned int> triangleCells;
+    std::vector<size_t> cellStarts;
+    std::vector<unsigned int> sortedTriangles;
+    std::vector<unsigned int> vertexStamp;
+    std::vector<unsigned int> vertexRemap;
+
+    for (const auto& mesh : model.meshes) {
+        const Vertex* vertices = mesh.GetVertexData();
+        const unsigned int* indices = mesh.GetIndexData();
+        size_t triangleCount = mesh.GetIndexCount() / 3;
+
+        triangleCells.resize(triangleCount);
+        cellStarts.assign(grid.size() + 1, 0);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            glm::vec3 centroid = (vertices[indices[t * 3]].position + vertices[indices[t * 3 + 1]].position
+                                  + vertices[indices[t * 3 + 2]].position) / 3.0f;
+            size_t column = std::min(columns - 1, static_cast<size_t>(std::max(0.0f, (centroid.x - model.boundsMin.x) / cellWidth)));
+            size_t row = std::min(rows - 1, static_cast<size_t>(std::max(0.0f, (centroid.z - model.boundsMin.z) / cellDepth)));
+            triangleCells[t] = static_cast<unsigned int>(row * columns + column);
+            ++cellStarts[triangleCells[t] + 1];
+        }
+        for (size_t c = 0; c < grid.size(); ++c) {
+            cellStarts[c + 1] += cellStarts[c];
+        }
+        sortedTriangles.resize(triangleCount);
+        std::vector<size_t> cursor(cellStarts.begin(), cellStarts.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            sortedTriangles[cursor[triangleCells[t]]++] = static_cast<unsigned int>(t);
+        }
+
+        vertexStamp.assign(mesh.GetVertexCount(), 0xFFFFFFFFu);
+        vertexRemap.resize(mesh.GetVertexCount());
+        for (size_t c = 0; c < grid.size(); ++c) {
+            if (cellStarts[c] == cellStarts[c + 1]) {
+                continue;
+            }
+
+            CellBuild& cell = grid[c];
+            cell.meshes.emplace_back();
+            Mesh& part = cell.meshes.back();
+            part.name = mesh.name;
+            part.materialIndex = mesh.materialIndex;
+            part.indices.reserve((cellStarts[c + 1] - cellStarts[c]) * 3);
+
+            for (size_t i = cellStarts[c]; i < cellStarts[c + 1]; ++i) {
+                size_t triangle = sortedTriangles[i];
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    unsigned int source = indices[triangle * 3 + corner];
+                    if (vertexStamp[source] != c) {
+                        vertexStamp[source] = static_cast<unsigned int>(c);
+                        vertexRemap[source] = static_cast<unsigned int>(part.vertices.size());
+                        part.vertices.push_back(vertices[source]);
+                        cell.boundsMin = glm::min(cell.boundsMin, vertices[source].position);
+                        cell.boundsMax = glm::max(cell.boundsMax, vertices[source].position);
+                    }
+                    part.indices.push_back(vertexRemap[source]);
+                }
+            }
+            cell.triangleCount += part.indices.size() / 3;
+            if (mesh.GetMeshletCount() > 0) {
+                MeshletBuilder::Build(part);
+            }
+        }
+    }
+
+    for (auto& cell : grid) {
+        if (!cell.meshes.empty()) {
+            cells.push_back(std::move(cell));
+        }
+    }
+}
+
+class BundleWriter {
+public:
+    BundleWriter() {}
+
+    uint64_t Append(const void* data, size_t size, size_t alignment = StageBundle::DATA_ALIGNMENT) {
+        size_t padding = (alignment - (m_data.size() % alignment)) % alignment;
+        m_data.insert(m_data.end(), padding, 0);
+        uint64_t offset = m_data.size();
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+        return offset;
+    }
+
+    template<typename T>
+    uint64_t AppendArray(const std::vector<T>& values) {
+        return Append(values.data(), values.size() * sizeof(T));
+    }
+
+    StringRef AddString(const std::string& value) {
+        StringRef ref;
+        ref.offset = static_cast<uint32_t>(m_strings.size());
+        ref.length = static_cast<uint32_t>(value.size());
+        m_strings += value;
+        return ref;
+    }
+
+    void Patch(uint64_t offset, const void* data, size_t size) {
+        std::memcpy(m_data.data() + offset, data, size);
+    }
+
+    uint64_t AppendStrings() {
+        return Append(m_strings.data(), m_strings.size());
+    }
+
+    size_t GetStringSize() const { return m_strings.size(); }
+    size_t GetSize() const { return m_data.size(); }
+    const std::vector<unsigned char>& GetData() const { return m_data; }
+
+private:
+    std::vector<unsigned char> m_data;
+    std::string m_strings;
+};
+
+}
+
+struct StageBundle::LodRecord {
+    float error;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+};
+
+struct StageBundle::MeshRecord {
+    StringRef name;
+    int32_t materialIndex;
+    uint32_t lodCount;
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t meshletOffset;
+    uint64_t meshletCount;
+    uint64_t lodOffset;
+};
+
+struct StageBundle::CellRecord {
+    float boundsMin[3];
+    uint32_t meshCount;
+    float boundsMax[3];
+    uint32_t triangleCount;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+struct StageBundle::CellMeshRecord {
+    StringRef name;
+    int32_t materialIndex;
+    uint32_t reserved;
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t meshletOffset;
+    uint64_t meshletCount;
+};
+
+struct StageBundle::MaterialRecord {
+    StringRef name;
+    StringRef diffuseTex;
+    StringRef normalTex;
+    StringRef specularTex;
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    float transparency;
+    float refractiveIndex;
+};
+
+StageBundle::StageBundle()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_residentSize(0)
+    , m_strings(nullptr)
+    , m_stringSize(0)
+    , m_contentHash(0)
+    , m_loaderFlags(0) {
+}
+
+std::string StageBundle::GetBundlePath(const std::string& stageDirectory) {
+    std::string directory = stageDirectory;
+    while (directory.size() > 1 && (directory.back() == '/' || directory.back() == '\\')) {
+        directory.pop_back();
+    }
+    return directory + BUNDLE_EXTENSION;
+}
+
+bool StageBundle::IsCollisionMeshName(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* prefix : COLLISION_PREFIXES) {
+        if (lower.compare(0, std::strlen(prefix), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StageBundle::Fail(const std::string& error) {
+    m_error = error;
+    Close();
+    return false;
+}
+
+void StageBundle::Close() {
+    m_storage.reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_residentSize = 0;
+    m_strings = nullptr;
+    m_stringSize = 0;
+    m_contentHash = 0;
+    m_loaderFlags = 0;
+    m_definition = StageDefinition();
+    for (auto& variant : m_variants) {
+        variant = VariantView();
+    }
+}
+
+template<typename T>
+const T* StageBundle::Fixup(uint64_t offset, uint64_t count) const {
+    if (offset > m_size || offset % alignof(T) != 0 || count > (m_size - offset) / sizeof(T)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(m_data + offset);
+}
+
+bool StageBundle::ResolveString(uint32_t offset, uint32_t length, std::string& value) const {
+    if (offset > m_stringSize || length > m_stringSize - offset) {
+        return false;
+    }
+    value.assign(m_strings + offset, length);
+    return true;
+}
+
+bool StageBundle::Load(const std::string& bundlePath) {
+    Close();
+    m_error.clear();
+
+    std::string realPath;
+    VirtualFileSystem& fileSystem = VirtualFileSystem::GetDefault();
+    if (fileSystem.ResolveLoosePath(bundlePath, realPath)) {
+        auto file = std::make_shared<MappedFile>();
+        if (!file->Open(realPath)) {
+            return Fail("Cannot map stage bundle [" + realPath + "]");
+        }
+        m_data = file->GetData();
+        m_size = file->GetSize();
+        m_storage = file;
+    } else {
+        auto buffer = std::make_shared<std::vector<char>>();
+        if (!fileSystem.ReadFile(bundlePath, *buffer) || buffer->empty()) {
+            return Fail("Cannot open stage bundle [" + bundlePath + "]");
+        }
+        m_data = reinterpret_cast<const unsigned char*>(buffer->data());
+        m_size = buffer->size();
+        m_residentSize = buffer->size();
+        m_storage = buffer;
+    }
+
+    const BundleHeader* header = Fixup<BundleHeader>(0, 1);
+    if (!header || std::memcmp(header->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0
+        || header->version != BUNDLE_VERSION || header->vertexSize != sizeof(Vertex)
+        || header->fileSize != m_size || header->variantCount != StageDefinition::VARIANT_COUNT) {
+        return Fail("Stage bundle " + bundlePath + " is invalid or from an incompatible version");
+    }
+
+    m_strings = reinterpret_cast<const char*>(Fixup<char>(header->stringOffset, header->stringSize));
+    const SpawnRecord* spawns = Fixup<SpawnRecord>(header->spawnOffset, header->spawnCount);
+    const VariantRecord* variants = Fixup<VariantRecord>(header->variantOffset, header->variantCount);
+    if (!m_strings || !spawns || !variants) {
+        return Fail("Stage bundle " + bundlePath + " has out of range sections");
+    }
+    m_stringSize = static_cast<size_t>(header->stringSize);
+
+    std::string name, description;
+    if (!ResolveString(header->name.offset, header->name.length, name)
+        || !ResolveString(header->description.offset, header->description.length, description)) {
+        return Fail("Stage bundle " + bundlePath + " has corrupt strings");
+    }
+    m_definition.SetName(name);
+    m_definition.SetDescription(description);
+    if (bundlePath.size() > BUNDLE_EXTENSION.size()
+        && bundlePath.compare(bundlePath.size() - BUNDLE_EXTENSION.size(), BUNDLE_EXTENSION.size(), BUNDLE_EXTENSION) == 0) {
+        m_definition.SetDirectory(bundlePath.substr(0, bundlePath.size() - BUNDLE_EXTENSION.size()));
+    }
+
+    std::vector<SpawnPoint> spawnPoints(header->spawnCount);
+    for (size_t i = 0; i < spawnPoints.size(); ++i) {
+        if (!ResolveString(spawns[i].name.offset, spawns[i].name.length, spawnPoints[i].name)) {
+            return Fail("Stage bundle " + bundlePath + " has corrupt spawn points");
+        }
+        spawnPoints[i].position = ToVec3(spawns[i].position);
+        spawnPoints[i].rotation = ToVec3(spawns[i].rotation);
+    }
+    m_definition.SetSpawnPoints(spawnPoints);
+
+    for (size_t v = 0; v < StageDefinition::VARIANT_COUNT; ++v) {
+        const VariantRecord& record = variants[v];
+        VariantView& view = m_variants[v];
+        if (!record.present) {
+            continue;
+        }
+
+        view.meshes = Fixup<MeshRecord>(record.meshOffset, record.meshCount);
+        view.materials = Fixup<MaterialRecord>(record.materialOffset, record.materialCount);
+        view.collision.vertices = Fixup<glm::vec3>(record.collisionVertexOffset, record.collisionVertexCount);
+        view.collision.indices = Fixup<unsigned int>(record.collisionIndexOffset, record.collisionIndexCount);
+        if (!view.meshes || !view.materials || !view.collision.vertices || !view.collision.indices
+            || !ResolveString(record.source.offset, record.source.length, view.source)) {
+            return Fail("Stage bundle " + bundlePath + " has a corrupt variant table");
+        }
+        view.meshCount = record.meshCount;
+        view.materialCount = record.materialCount;
+        view.boundsMin = ToVec3(record.boundsMin);
+        view.boundsMax = ToVec3(record.boundsMax);
+        view.collision.vertexCount = record.collisionVertexCount;
+        view.collision.indexCount = record.collisionIndexCount;
+        view.collision.boundsMin = ToVec3(record.collisionMin);
+        view.collision.boundsMax = ToVec3(record.collisionMax);
+
+        if (!IndicesInRange(view.collision.indices, view.collision.indexCount, view.collision.vertexCount)) {
+            return Fail("Stage bundle " + bundlePath + " has out of range collision indices");
+        }
+
+        for (size_t m = 0; m < view.meshCount; ++m) {
+            const MeshRecord& mesh = view.meshes[m];
+            if (!Fixup<Vertex>(mesh.vertexOffset, mesh.vertexCount) || !Fixup<unsigned int>(mesh.indexOffset, mesh.indexCount)
+                || !Fixup<Meshlet>(mesh.meshletOffset, mesh.meshletCount) || !Fixup<LodRecord>(mesh.lodOffset, mesh.lodCount)) {
+                return Fail("Stage bundle " + bundlePath + " has out of range mesh data");
+            }
+            if (!IndicesInRange(Fixup<unsigned int>(mesh.indexOffset, mesh.indexCount), mesh.indexCount, mesh.vertexCount)) {
+                return Fail("Stage bundle " + bundlePath + " has out of range mesh indices");
+            }
+            const LodRecord* lods = Fixup<LodRecord>(mesh.lodOffset, mesh.lodCount);
+            for (uint32_t l = 0; l < mesh.lodCount; ++l) {
+                const unsigned int* lodIndices = Fixup<unsigned int>(lods[l].indexOffset, lods[l].indexCount);
+                if (!lodIndices) {
+                    return Fail("Stage bundle " + bundlePath + " has out of range LOD data");
+                }
+                if (!IndicesInRange(lodIndices, lods[l].indexCount, mesh.vertexCount)) {
+                    return Fail("Stage bundle " + bundlePath + " has out of range LOD indices");
+                }
+            }
+        }
+
+        const CellRecord* cells = Fixup<CellRecord>(record.cellOffset, record.cellCount);
+        if (!cells) {
+            return Fail("Stage bundle " + bundlePath + " has a corrupt cell table");
+        }
+        view.cells.resize(record.cellCount);
+        for (size_t c = 0; c < view.cells.size(); ++c) {
+            if (!Fixup<unsigned char>(cells[c].dataOffset, cells[c].dataSize)
+                || cells[c].meshCount > cells[c].dataSize / sizeof(CellMeshRecord)) {
+                return Fail("Stage bundle " + bundlePath + " has out of range cell data");
+            }
+            CellInfo& cell = view.cells[c];
+            cell.boundsMin = ToVec3(cells[c].boundsMin);
+            cell.boundsMax = ToVec3(cells[c].boundsMax);
+            cell.meshCount = cells[c].meshCount;
+            cell.triangleCount = cells[c].triangleCount;
+            cell.dataOffset = cells[c].dataOffset;
+            cell.dataSize = cells[c].dataSize;
+        }
+
+        view.present = true;
+        m_definition.SetModelFile(static_cast<Variant>(v), view.source);
+    }
+
+    m_contentHash = header->contentHash;
+    m_loaderFlags = header->loaderFlags;
+    return true;
+}
+
+bool StageBundle::GetModel(Variant variant, Model& model) const {
+    const VariantView& view = m_variants[static_cast<size_t>(variant)];
+    if (!IsLoaded() || !view.present) {
+        return false;
+    }
+
+    Model result;
+    result.name = view.source;
+    result.boundsMin = view.boundsMin;
+    result.boundsMax = view.boundsMax;
+    result.mappedData = m_storage;
+
+    ReadMaterials(view, result.materials);
+
+    result.meshes.resize(view.meshCount);
+    for (size_t i = 0; i < view.meshCount; ++i) {
+        const MeshRecord& record = view.meshes[i];
+        Mesh& mesh = result.meshes[i];
+        ResolveString(record.name.offset, record.name.length, mesh.name);
+        mesh.materialIndex = record.materialIndex;
+        mesh.mappedVertices = Fixup<Vertex>(record.vertexOffset, record.vertexCount);
+        mesh.mappedVertexCount = static_cast<size_t>(record.vertexCount);
+        mesh.mappedIndices = Fixup<unsigned int>(record.indexOffset, record.indexCount);
+        mesh.mappedIndexCount = static_cast<size_t>(record.indexCount);
+        mesh.mappedData = m_storage;
+        if (record.meshletCount > 0) {
+            mesh.mappedMeshlets = Fixup<Meshlet>(record.meshletOffset, record.meshletCount);
+            mesh.mappedMeshletCount = static_cast<size_t>(record.meshletCount);
+        }
+
+        const LodRecord* lods = Fixup<LodRecord>(record.lodOffset, record.lodCount);
+        mesh.lods.resize(record.lodCount);
+        for (uint32_t l = 0; l < record.lodCount; ++l) {
+            mesh.lods[l].error = lods[l].error;
+            mesh.lods[l].mappedIndices = Fixup<unsigned int>(lods[l].indexOffset, lods[l].indexCount);
+            mesh.lods[l].mappedIndexCount = static_cast<size_t>(lods[l].indexCount);
+        }
+    }
+
+    model = std::move(result);
+    return true;
+}
+
+void StageBundle::ReadMaterials(const VariantView& view, std::vector<Material>& materials) const {
+    materials.resize(view.materialCount);
+    for (size_t i = 0; i < view.materialCount; ++i) {
+        const MaterialRecord& record = view.materials[i];
+        Material& material = materials[i];
+        ResolveString(record.name.offset, record.name.length, material.name);
+        ResolveString(record.diffuseTex.offset, record.diffuseTex.length, material.diffuseTex);
+        ResolveString(record.normalTex.offset, record.normalTex.length, material.normalTex);
+        ResolveString(record.specularTex.offset, record.specularTex.length, material.specularTex);
+        material.ambient = ToVec3(record.ambient);
+        material.diffuse = ToVec3(record.diffuse);
+        material.specular = ToVec3(record.specular);
+        material.shininess = record.shininess;
+        material.transparency = record.transparency;
+        material.refractiveIndex = record.refractiveIndex;
+    }
+}
+
+bool StageBundle::LoadCell(Variant variant, size_t index, Model& model) const {
+    const VariantView& view = m_variants[static_cast<size_t>(variant)];
+    if (!IsLoaded() || !view.present || index >= view.cells.size()) {
+        return false;
+    }
+
+    const CellInfo& cell = view.cells[index];
+    size_t size = static_cast<size_t>(cell.dataSize);
+    auto buffer = std::make_shared<std::vector<char>>(size);
+    std::memcpy(buffer->data(), m_data + cell.dataOffset, size);
+    const char* data = buffer->data();
+
+    auto span = [size](uint64_t offset, uint64_t count, size_t elementSize) {
+        return offset <= size && count <= (size - offset) / elementSize;
+    };
+
+    Model result;
+    result.name = view.source + "#" + std::to_string(index);
+    result.boundsMin = cell.boundsMin;
+    result.boundsMax = cell.boundsMax;
+    ReadMaterials(view, result.materials);
+
+    const CellMeshRecord* records = reinterpret_cast<const CellMeshRecord*>(data);
+    result.meshes.resize(cell.meshCount);
+    for (size_t i = 0; i < cell.meshCount; ++i) {
+        const CellMeshRecord& record = records[i];
+        if (!span(record.vertexOffset, record.vertexCount, sizeof(Vertex))
+            || !span(record.indexOffset, record.indexCount, sizeof(unsigned int))
+            || !span(record.meshletOffset, record.meshletCount, sizeof(Meshlet))) {
+            return false;
+        }
+
+        Mesh& mesh = result.meshes[i];
+        ResolveString(record.name.offset, record.name.length, mesh.name);
+        mesh.materialIndex = record.materialIndex;
+        mesh.mappedVertices = reinterpret_cast<const Vertex*>(data + record.vertexOffset);
+        mesh.mappedVertexCount = static_cast<size_t>(record.vertexCount);
+        mesh.mappedIndices = reinterpret_cast<const unsigned int*>(data + record.indexOffset);
+        mesh.mappedIndexCount = static_cast<size_t>(record.indexCount);
+        mesh.mappedData = buffer;
+        if (!IndicesInRange(mesh.mappedIndices, mesh.mappedIndexCount, mesh.mappedVertexCount)) {
+            return false;
+        }
+        if (record.meshletCount > 0) {
+            mesh.mappedMeshlets = reinterpret_cast<const Meshlet*>(data + record.meshletOffset);
+            mesh.mappedMeshletCount = static_cast<size_t>(record.meshletCount);
+        }
+    }
+
+    result.mappedData = buffer;
+    model = std::move(result);
+    return true;
+}
+
+bool StageBundle::ComputeContentHash(const StageDefinition& definition, uint32_t loaderFlags, uint64_t& hash) {
+    VirtualFileSystem& fileSystem = VirtualFileSystem::GetDefault();
+    hash = HASH_OFFSET_BASIS;
+    hash = HashValue(hash, BUNDLE_VERSION);
+    hash = HashValue(hash, static_cast<uint32_t>(sizeof(Vertex)));
+    hash = HashValue(hash, loaderFlags);
+
+    std::vector<VirtualFileSystem::ReadRequest> sources;
+    sources.emplace_back(definition.GetDirectory() + "/" + StageDefinition::DATA_FILE);
+    for (size_t v = 0; v < StageDefinition::VARIANT_COUNT; ++v) {
+        sources.emplace_back(definition.GetModelPath(static_cast<Variant>(v)));
+    }
+    fileSystem.ReadFiles(sources);
+    if (!sources[0].success) {
+        return false;
+    }
+    hash = HashBytes(hash, sources[0].data.data(), sources[0].data.size());
+
+    std::vector<std::vector<std::string>> libraries(StageDefinition::VARIANT_COUNT);
+    std::vector<VirtualFileSystem::ReadRequest> materials;
+    for (size_t v = 0; v < StageDefinition::VARIANT_COUNT; ++v) {
+        const VirtualFileSystem::ReadRequest& model = sources[v + 1];
+        if (model.path.empty()) {
+            continue;
+        }
+        if (!model.success) {
+            return false;
+        }
+        FindMaterialLibraries(model.data, libraries[v]);
+        for (const auto& library : libraries[v]) {
+            materials.emplace_back(definition.GetDirectory() + "/" + library);
+        }
+    }
+    fileSystem.ReadFiles(materials);
+
+    size_t material = 0;
+    for (size_t v = 0; v < StageDefinition::VARIANT_COUNT; ++v) {
+        const VirtualFileSystem::ReadRequest& model = sources[v + 1];
+        hash = HashString(hash, model.path);
+        if (model.path.empty()) {
+            continue;
+        }
+        hash = HashBytes(hash, model.data.data(), model.data.size());
+
+        for (const auto& library : libraries[v]) {
+            hash = HashString(hash, library);
+            const VirtualFileSystem::ReadRequest& request = materials[material++];
+            if (request.success) {
+                hash = HashBytes(hash, request.data.data(), request.data.size());
+            }
+        }
+    }
+    return true;
+}
+
+bool StageBundle::ReadContentHash(const std::string& bundlePath, uint64_t& hash) {
+    std::ifstream stream(bundlePath, std::ios::binary);
+    BundleHeader header;
+    if (!stream || !stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 || header.version != BUNDLE_VERSION) {
+        return false;
+    }
+    hash = header.contentHash;
+    return true;
+}
+
+bool StageBundle::Cook(const std::string& stageDirectory, OBJLoader& loader, bool force) {
+    auto start = std::chrono::high_resolution_clock::now();
+    StageDefinition definition;
+    if (!definition.Load(stageDirectory)) {
+        std::cerr << "Stage cook failed: " << definition.GetError() << std::endl;
+        return false;
+    }
+
+    uint32_t loaderFlags = loader.GetOptionFlags();
+    uint64_t contentHash = 0;
+    if (!ComputeContentHash(definition, loaderFlags, contentHash)) {
+        std::cerr << "Stage cook failed: missing source files for " << stageDirectory << std::endl;
+        return false;
+    }
+
+    std::string bundlePath = GetBundlePath(stageDirectory);
+    uint64_t existingHash = 0;
+    if (!force && ReadContentHash(bundlePath, existingHash) && existingHash == contentHash) {
+        std::cout << "Stage '" << definition.GetName() << "' is up to date (" << bundlePath << ")" << std::endl;
+        return true;
+    }
+
+    BundleWriter writer;
+    BundleHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    header.version = BUNDLE_VERSION;
+    header.contentHash = contentHash;
+    header.vertexSize = sizeof(Vertex);
+    header.loaderFlags = loaderFlags;
+    header.variantCount = static_cast<uint32_t>(StageDefinition::VARIANT_COUNT);
+    header.name = writer.AddString(definition.GetName());
+    header.description = writer.AddString(definition.GetDescription());
+    writer.Append(&header, sizeof(header));
+
+    std::vector<SpawnRecord> spawns;
+    for (const auto& spawn : definition.GetSpawnPoints()) {
+        SpawnRecord record;
+        record.name = writer.AddString(spawn.name);
+        CopyVec3(spawn.position, record.position);
+        CopyVec3(spawn.rotation, record.rotation);
+        spawns.push_back(record);
+    }
+    header.spawnCount = static_cast<uint32_t>(spawns.size());
+    header.spawnOffset = writer.AppendArray(spawns);
+
+    std::vector<VariantRecord> variants(StageDefinition::VARIANT_COUNT);
+    for (size_t v = 0; v < StageDefinition::VARIANT_COUNT; ++v) {
+        VariantRecord& record = variants[v];
+        std::memset(&record, 0, sizeof(record));
+        Variant variant = static_cast<Variant>(v);
+        std::string modelPath = definition.GetModelPath(variant);
+        if (modelPath.empty()) {
+            continue;
+        }
+
+        Model model;
+        if (!loader.LoadModel(modelPath, model)) {
+            std::cerr << "Stage cook failed: " << loader.GetLastError() << std::endl;
+            return false;
+        }
+
+        std::vector<bool> collisionOnly(model.meshes.size(), false);
+        bool hasCollisionMeshes = false;
+        for (size_t m = 0; m < model.meshes.size(); ++m) {
+            collisionOnly[m] = IsCollisionMeshName(model.meshes[m].name);
+            hasCollisionMeshes = hasCollisionMeshes || collisionOnly[m];
+        }
+
+        std::vector<glm::vec3> collisionVertices;
+        std::vector<unsigned int> collisionIndices;
+        glm::vec3 collisionMin, collisionMax;
+        std::vector<bool> useForCollision = hasCollisionMeshes ? collisionOnly : std::vector<bool>(model.meshes.size(), true);
+        ExtractCollision(model, useForCollision, collisionVertices, collisionIndices, collisionMin, collisionMax);
+
+        if (hasCollisionMeshes) {
+            std::vector<Mesh> renderMeshes;
+            for (size_t m = 0; m < model.meshes.size(); ++m) {
+                if (!collisionOnly[m]) {
+                    renderMeshes.push_back(std::move(model.meshes[m]));
+                }
+            }
+            model.meshes = std::move(renderMeshes);
+            model.CalculateBounds();
+        }
+
+        std::vector<StageBundle::MeshRecord> meshes;
+        for (const auto& mesh : model.meshes) {
+            StageBundle::MeshRecord meshRecord;
+            std::memset(&meshRecord, 0, sizeof(meshRecord));
+            meshRecord.name = writer.AddString(mesh.name);
+            meshRecord.materialIndex = mesh.materialIndex;
+            meshRecord.vertexCount = mesh.GetVertexCount();
+            meshRecord.vertexOffset = writer.Append(mesh.GetVertexData(), mesh.GetVertexCount() * sizeof(Vertex));
+            meshRecord.indexCount = mesh.GetIndexCount();
+            meshRecord.indexOffset = writer.Append(mesh.GetIndexData(), mesh.GetIndexCount() * sizeof(unsigned int));
+            meshRecord.meshletCount = mesh.GetMeshletCount();
+            meshRecord.meshletOffset = writer.Append(mesh.GetMeshletData(), mesh.GetMeshletCount() * sizeof(Meshlet));
+
+            std::vector<StageBundle::LodRecord> lods;
+            for (const auto& lod : mesh.lods) {
+                StageBundle::LodRecord lodRecord;
+                lodRecord.error = lod.error;
+                lodRecord.reserved = 0;
+                lodRecord.indexCount = lod.GetIndexCount();
+                lodRecord.indexOffset = writer.Append(lod.GetIndexData(), lod.GetIndexCount() * sizeof(unsigned int));
+                lods.push_back(lodRecord);
+            }
+            meshRecord.lodCount = static_cast<uint32_t>(lods.size());
+            meshRecord.lodOffset = writer.AppendArray(lods);
+            meshes.push_back(meshRecord);
+        }
+
+        std::vector<StageBundle::MaterialRecord> materials;
+        for (const auto& material : model.materials) {
+            StageBundle::MaterialRecord materialRecord;
+            materialRecord.name = writer.AddString(material.name);
+            materialRecord.diffuseTex = writer.AddString(material.diffuseTex);
+            materialRecord.normalTex = writer.AddString(material.normalTex);
+            materialRecord.specularTex = writer.AddString(material.specularTex);
+            CopyVec3(material.ambient, materialRecord.ambient);
+            CopyVec3(material.diffuse, materialRecord.diffuse);
+            CopyVec3(material.specular, materialRecord.specular);
+            materialRecord.shininess = material.shininess;
+            materialRecord.transparency = material.transparency;
+            materialRecord.refractiveIndex = material.refractiveIndex;
+            materials.push_back(materialRecord);
+        }
+
+        std::vector<CellBuild> cells;
+        size_t triangleCount = model.GetTotalIndexCount() / 3;
+        if (triangleCount >= CELL_TARGET_TRIANGLES * 2) {
+            SplitIntoCells(model, cells);
+        }
+
+        std::vector<StageBundle::CellRecord> cellRecords;
+        for (const auto& cell : cells) {
+            BundleWriter cellWriter;
+            std::vector<StageBundle::CellMeshRecord> cellMeshes(cell.meshes.size());
+            cellWriter.Append(cellMeshes.data(), cellMeshes.size() * sizeof(StageBundle::CellMeshRecord));
+            for (size_t m = 0; m < cell.meshes.size(); ++m) {
+                const Mesh& mesh = cell.meshes[m];
+                StageBundle::CellMeshRecord& meshRecord = cellMeshes[m];
+                std::memset(&meshRecord, 0, sizeof(meshRecord));
+                meshRecord.name = writer.AddString(mesh.name);
+                meshRecord.materialIndex = mesh.materialIndex;
+                meshRecord.vertexCount = mesh.vertices.size();
+                meshRecord.vertexOffset = cellWriter.AppendArray(mesh.vertices);
+                meshRecord.indexCount = mesh.indices.size();
+                meshRecord.indexOffset = cellWriter.AppendArray(mesh.indices);
+                meshRecord.meshletCount = mesh.meshlets.size();
+                meshRecord.meshletOffset = cellWriter.AppendArray(mesh.meshlets);
+            }
+            cellWriter.Patch(0, cellMeshes.data(), cellMeshes.size() * sizeof(StageBundle::CellMeshRecord));
+
+            StageBundle::CellRecord cellRecord;
+            CopyVec3(cell.boundsMin, cellRecord.boundsMin);
+            CopyVec3(cell.boundsMax, cellRecord.boundsMax);
+            cellRecord.meshCount = static_cast<uint32_t>(cell.meshes.size());
+            cellRecord.triangleCount = static_cast<uint32_t>(cell.triangleCount);
+            cellRecord.dataSize = cellWriter.GetSize();
+            cellRecord.dataOffset = writer.Append(cellWriter.GetData().data(), cellWriter.GetSize(), CELL_ALIGNMENT);
+            cellRecords.push_back(cellRecord);
+        }
+
+        record.present = 1;
+        record.cellCount = static_cast<uint32_t>(cellRecords.size());
+        record.cellOffset = writer.AppendArray(cellRecords);
+        record.source = writer.AddString(definition.GetModelFile(variant));
+        record.meshCount = static_cast<uint32_t>(meshes.size());
+        record.meshOffset = writer.AppendArray(meshes);
+        record.materialCount = static_cast<uint32_t>(materials.size());
+        record.materialOffset = writer.AppendArray(materials);
+        record.collisionVertexCount = static_cast<uint32_t>(collisionVertices.size());
+        record.collisionVertexOffset = writer.AppendArray(collisionVertices);
+        record.collisionIndexCount = static_cast<uint32_t>(collisionIndices.size());
+        record.collisionIndexOffset = writer.AppendArray(collisionIndices);
+        CopyVec3(model.boundsMin, record.boundsMin);
+        CopyVec3(model.boundsMax, record.boundsMax);
+        CopyVec3(collisionMin, record.collisionMin);
+        CopyVec3(collisionMax, record.collisionMax);
+
+        std::cout << "Cooked " << StageDefinition::GetVariantName(variant) << " variant from " << modelPath << ": "
+                  << meshes.size() << " meshes, " << cellRecords.size() << " streaming cells, "
+                  << collisionIndices.size() / 3 << " collision triangles" << std::endl;
+    }
+
+    header.variantOffset = writer.AppendArray(variants);
+    header.stringSize = writer.GetStringSize();
+    header.stringOffset = writer.AppendStrings();
+    header.fileSize = writer.GetSize();
+    writer.Patch(0, &header, sizeof(header));
+
+    std::string tempPath = bundlePath + ".tmp";
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        std::cerr << "Stage cook failed: cannot create " << tempPath << std::endl;
+        return false;
+    }
+    stream.write(reinterpret_cast<const char*>(writer.GetData().data()), static_cast<std::streamsize>(writer.GetSize()));
+    stream.close();
+    if (!stream) {
+        std::remove(tempPath.c_str());
+        std::cerr << "Stage cook failed: error while writing " << tempPath << std::endl;
+        return false;
+    }
+    std::remove(bundlePath.c_str());
+    if (std::rename(tempPath.c_str(), bundlePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        std::cerr << "Stage cook failed: cannot move " << tempPath << " to " << bundlePath << std::endl;
+        return false;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Cooked stage '" << definition.GetName() << "' into " << bundlePath << " (" << writer.GetSize() / 1024
+              << " KB) in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return true;
+}
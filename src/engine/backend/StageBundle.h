@@ -0,0 +1,107 @@
+#pragma once
+
+#include "OBJLoader.h"
+#include "StageDefinition.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class StageBundle {
+public:
+    typedef StageDefinition::Variant Variant;
+
+    static const uint32_t BUNDLE_VERSION;
+    static const std::string BUNDLE_EXTENSION;
+    static const size_t DATA_ALIGNMENT = 16;
+    static const size_t CELL_ALIGNMENT = 4096;
+    static const size_t CELL_TARGET_TRIANGLES = 16384;
+
+    struct CollisionMesh {
+        const glm::vec3* vertices;
+        size_t vertexCount;
+        const unsigned int* indices;
+        size_t indexCount;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+
+        CollisionMesh() : vertices(nullptr), vertexCount(0), indices(nullptr), indexCount(0), boundsMin(0.0f), boundsMax(0.0f) {}
+        size_t GetTriangleCount() const { return indexCount / 3; }
+    };
+
+    struct CellInfo {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        size_t meshCount;
+        size_t triangleCount;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+
+        CellInfo() : boundsMin(0.0f), boundsMax(0.0f), meshCount(0), triangleCount(0), dataOffset(0), dataSize(0) {}
+    };
+
+    StageBundle();
+
+    bool Load(const std::string& bundlePath);
+    void Close();
+
+    bool IsLoaded() const { return m_data != nullptr; }
+    bool HasVariant(Variant variant) const { return m_variants[static_cast<size_t>(variant)].present; }
+    bool GetModel(Variant variant, Model& model) const;
+    const CollisionMesh& GetCollision(Variant variant) const { return m_variants[static_cast<size_t>(variant)].collision; }
+    size_t GetCellCount(Variant variant) const { return m_variants[static_cast<size_t>(variant)].cells.size(); }
+    const CellInfo& GetCell(Variant variant, size_t index) const { return m_variants[static_cast<size_t>(variant)].cells[index]; }
+    bool LoadCell(Variant variant, size_t index, Model& model) const;
+    const StageDefinition& GetDefinition() const { return m_definition; }
+    uint64_t GetContentHash() const { return m_contentHash; }
+    uint32_t GetLoaderFlags() const { return m_loaderFlags; }
+    size_t GetSize() const { return m_size; }
+    size_t GetResidentSize() const { return m_residentSize; }
+    const std::string& GetError() const { return m_error; }
+
+    static std::string GetBundlePath(const std::string& stageDirectory);
+    static bool ComputeContentHash(const StageDefinition& definition, uint32_t loaderFlags, uint64_t& hash);
+    static bool ReadContentHash(const std::string& bundlePath, uint64_t& hash);
+    static bool Cook(const std::string& stageDirectory, OBJLoader& loader, bool force = false);
+    static bool IsCollisionMeshName(const std::string& name);
+
+private:
+    struct MeshRecord;
+    struct MaterialRecord;
+    struct LodRecord;
+    struct CellRecord;
+    struct CellMeshRecord;
+
+    struct VariantView {
+        bool present;
+        std::string source;
+        const MeshRecord* meshes;
+        size_t meshCount;
+        const MaterialRecord* materials;
+        size_t materialCount;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        CollisionMesh collision;
+        std::vector<CellInfo> cells;
+
+        VariantView() : present(false), meshes(nullptr), meshCount(0), materials(nullptr), materialCount(0),
+                        boundsMin(0.0f), boundsMax(0.0f) {}
+    };
+
+    template<typename T>
+    const T* Fixup(uint64_t offset, uint64_t count) const;
+    bool ResolveString(uint32_t offset, uint32_t length, std::string& value) const;
+    void ReadMaterials(const VariantView& view, std::vector<Material>& materials) const;
+    bool Fail(const std::string& error);
+
+    std::shared_ptr<const void> m_storage;
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_residentSize;
+    const char* m_strings;
+    size_t m_stringSize;
+    uint64_t m_contentHash;
+    uint32_t m_loaderFlags;
+    StageDefinition m_definition;
+    VariantView m_variants[StageDefinition::VARIANT_COUNT];
+    std::string m_error;
+};
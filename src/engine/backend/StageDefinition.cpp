@@ -0,0 +1,71 @@
+#include "StageDefinition.h"
+#include "JsonValue.h"
+#include "VirtualFileSystem.h"
+
+const std::string StageDefinition::DATA_FILE = "data.json";
+
+namespace {
+
+glm::vec3 ReadVec3(const JsonValue& value) {
+    glm::vec3 result(0.0f);
+    for (size_t i = 0; i < 3; ++i) {
+        result[static_cast<int>(i)] = static_cast<float>(value[i].AsNumber());
+    }
+    return result;
+}
+
+}
+
+StageDefinition::StageDefinition() {
+}
+
+bool StageDefinition::Load(const std::string& stageDirectory) {
+    std::string dataPath = stageDirectory + "/" + DATA_FILE;
+    std::string text;
+    if (!VirtualFileSystem::GetDefault().ReadText(dataPath, text)) {
+        m_error = "Cannot open stage description [" + dataPath + "]";
+        return false;
+    }
+
+    JsonValue root;
+    std::string parseError;
+    if (!JsonValue::Parse(text, root, parseError)) {
+        m_error = "Failed to parse " + dataPath + ": " + parseError;
+        return false;
+    }
+    if (!root.IsObject()) {
+        m_error = "Stage description " + dataPath + " is not an object";
+        return false;
+    }
+
+    m_directory = stageDirectory;
+    m_name = root["mapName"].AsString(stageDirectory);
+    m_description = root["mapDescription"].AsString();
+    m_modelFiles[static_cast<size_t>(Variant::Small)] = root["smallMap"].AsString();
+    m_modelFiles[static_cast<size_t>(Variant::Big)] = root["bigMap"].AsString();
+    if (m_modelFiles[static_cast<size_t>(Variant::Small)].empty()) {
+        m_error = "Stage description " + dataPath + " has no smallMap";
+        return false;
+    }
+
+    m_spawnPoints.clear();
+    for (const auto& member : root["spawnPoints"].GetMembers()) {
+        SpawnPoint spawn;
+        spawn.name = member.first;
+        spawn.position = ReadVec3(member.second["position"]);
+        spawn.rotation = ReadVec3(member.second["rotation"]);
+        m_spawnPoints.push_back(spawn);
+    }
+
+    m_error.clear();
+    return true;
+}
+
+std::string StageDefinition::GetModelPath(Variant variant) const {
+    const std::string& file = GetModelFile(variant);
+    return file.empty() ? std::string() : m_directory + "/" + file;
+}
+
+const char* StageDefinition::GetVariantName(Variant variant) {
+    return variant == Variant::Small ? "small" : "big";
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+struct SpawnPoint {
+    std::string name;
+    glm::vec3 position;
+    glm::vec3 rotation;
+
+    SpawnPoint() : position(0.0f), rotation(0.0f) {}
+};
+
+class StageDefinition {
+public:
+    enum class Variant {
+        Small,
+        Big
+    };
+
+    static const size_t VARIANT_COUNT = 2;
+    static const std::string DATA_FILE;
+
+    StageDefinition();
+
+    bool Load(const std::string& stageDirectory);
+
+    const std::string& GetDirectory() const { return m_directory; }
+    const std::string& GetName() const { return m_name; }
+    const std::string& GetDescription() const { return m_description; }
+    const std::string& GetModelFile(Variant variant) const { return m_modelFiles[static_cast<size_t>(variant)]; }
+    std::string GetModelPath(Variant variant) const;
+    const std::vector<SpawnPoint>& GetSpawnPoints() const { return m_spawnPoints; }
+    const std::string& GetError() const { return m_error; }
+
+    void SetName(const std::string& name) { m_name = name; }
+    void SetDescription(const std::string& description) { m_description = description; }
+    void SetModelFile(Variant variant, const std::string& file) { m_modelFiles[static_cast<size_t>(variant)] = file; }
+    void SetSpawnPoints(const std::vector<SpawnPoint>& spawnPoints) { m_spawnPoints = spawnPoints; }
+    void SetDirectory(const std::string& directory) { m_directory = directory; }
+
+    static const char* GetVariantName(Variant variant);
+
+private:
+    std::string m_directory;
+    std::string m_name;
+    std::string m_description;
+    std::string m_modelFiles[VARIANT_COUNT];
+    std::vector<SpawnPoint> m_spawnPoints;
+    std::string m_error;
+};
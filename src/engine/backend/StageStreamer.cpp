@@ -0,0 +1,195 @@
+#include "StageStreamer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+StageStreamer::StageStreamer()
+    : m_bundle(nullptr)
+    , m_variant(StageDefinition::Variant::Small)
+    , m_pool(nullptr) {
+}
+
+StageStreamer::~StageStreamer() {
+    Close();
+}
+
+bool StageStreamer::Open(const StageBundle* bundle, Variant variant, ThreadPool* pool) {
+    Close();
+    if (!bundle || !bundle->IsLoaded() || !bundle->HasVariant(variant) || bundle->GetCellCount(variant) == 0) {
+        std::cerr << "StageStreamer: bundle has no streaming cells for this variant" << std::endl;
+        return false;
+    }
+
+    m_bundle = bundle;
+    m_variant = variant;
+    m_pool = pool;
+    m_cells = std::vector<Cell>(bundle->GetCellCount(variant));
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        m_cells[i].bytes = static_cast<size_t>(bundle->GetCell(variant, i).dataSize);
+    }
+    m_stats.bundleBytes = bundle->GetResidentSize();
+    if (m_stats.bundleBytes > m_settings.memoryBudget) {
+        std::cerr << "StageStreamer: bundle keeps " << m_stats.bundleBytes / (1024 * 1024)
+                  << " MB resident, over the streaming budget" << std::endl;
+    }
+    std::cout << "StageStreamer: streaming " << m_cells.size() << " cells of "
+              << bundle->GetDefinition().GetName() << std::endl;
+    return true;
+}
+
+void StageStreamer::Close() {
+    for (auto& cell : m_cells) {
+        if (cell.pending.valid()) {
+            cell.pending.wait();
+        }
+    }
+    m_cells.clear();
+    m_bundle = nullptr;
+    m_pool = nullptr;
+    m_stats = Stats();
+}
+
+void StageStreamer::Update(const std::vector<glm::vec3>& focusPoints, const std::function<void(const Model&)>& onEvict) {
+    if (!m_bundle) {
+        return;
+    }
+
+    CompleteLoads();
+    UpdateDistances(focusPoints);
+
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        if (m_cells[i].state == CellState::Resident && m_cells[i].distance > m_settings.unloadRadius) {
+            Evict(i, onEvict);
+        }
+    }
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        const Cell& cell = m_cells[i];
+        if (cell.state == CellState::Unloaded && !cell.failed && cell.distance <= m_settings.loadRadius) {
+            candidates.push_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return m_cells[a].distance < m_cells[b].distance;
+    });
+
+    for (size_t index : candidates) {
+        if (m_stats.loadingCells >= m_settings.maxConcurrentLoads) {
+            break;
+        }
+        const Cell& cell = m_cells[index];
+        if (m_stats.bundleBytes + cell.bytes > m_settings.memoryBudget) {
+            continue;
+        }
+        if (!MakeRoom(cell.bytes, cell.distance, onEvict)) {
+            break;
+        }
+        IssueLoad(index);
+    }
+
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.bundleBytes + m_stats.residentBytes + m_stats.loadingBytes);
+}
+
+size_t StageStreamer::GetResidentModels(std::vector<const Model*>& models) const {
+    size_t before = models.size();
+    for (const auto& cell : m_cells) {
+        if (cell.state == CellState::Resident) {
+            models.push_back(cell.model.get());
+        }
+    }
+    return models.size() - before;
+}
+
+float StageStreamer::DistanceToBounds(const glm::vec3& point, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 closest = glm::clamp(point, boundsMin, boundsMax);
+    return glm::length(point - closest);
+}
+
+void StageStreamer::UpdateDistances(const std::vector<glm::vec3>& focusPoints) {
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        const StageBundle::CellInfo& info = m_bundle->GetCell(m_variant, i);
+        float distance = FLT_MAX;
+        for (const auto& point : focusPoints) {
+            distance = std::min(distance, DistanceToBounds(point, info.boundsMin, info.boundsMax));
+        }
+        m_cells[i].distance = distance;
+    }
+}
+
+void StageStreamer::CompleteLoads() {
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        Cell& cell = m_cells[i];
+        if (cell.state == CellState::Loading
+            && cell.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            FinishLoad(i, cell.pending.get());
+        }
+    }
+}
+
+void StageStreamer::Evict(size_t index, const std::function<void(const Model&)>& onEvict) {
+    Cell& cell = m_cells[index];
+    if (onEvict) {
+        onEvict(*cell.model);
+    }
+    cell.model.reset();
+    cell.state = CellState::Unloaded;
+    m_stats.residentBytes -= cell.bytes;
+    --m_stats.residentCells;
+    ++m_stats.evictions;
+}
+
+bool StageStreamer::MakeRoom(size_t bytes, float distance, const std::function<void(const Model&)>& onEvict) {
+    while (m_stats.bundleBytes + m_stats.residentBytes + m_stats.loadingBytes + bytes > m_settings.memoryBudget) {
+        size_t farthest = m_cells.size();
+        for (size_t i = 0; i < m_cells.size(); ++i) {
+            const Cell& cell = m_cells[i];
+            if (cell.state == CellState::Resident && cell.distance > distance
+                && (farthest == m_cells.size() || cell.distance > m_cells[farthest].distance)) {
+                farthest = i;
+            }
+        }
+        if (farthest == m_cells.size()) {
+            return false;
+        }
+        Evict(farthest, onEvict);
+    }
+    return true;
+}
+
+void StageStreamer::IssueLoad(size_t index) {
+    Cell& cell = m_cells[index];
+    cell.model.reset(new Model());
+    cell.state = CellState::Loading;
+    m_stats.loadingBytes += cell.bytes;
+    ++m_stats.loadingCells;
+    ++m_stats.loadsIssued;
+
+    const StageBundle* bundle = m_bundle;
+    Variant variant = m_variant;
+    Model* model = cell.model.get();
+    if (m_pool) {
+        cell.pending = m_pool->Submit([bundle, variant, index, model]() {
+            return bundle->LoadCell(variant, index, *model);
+        });
+        return;
+    }
+    FinishLoad(index, bundle->LoadCell(variant, index, *model));
+}
+
+void StageStreamer::FinishLoad(size_t index, bool success) {
+    Cell& cell = m_cells[index];
+    m_stats.loadingBytes -= cell.bytes;
+    --m_stats.loadingCells;
+    if (!success) {
+        std::cerr << "StageStreamer: failed to load cell " << index << std::endl;
+        cell.model.reset();
+        cell.state = CellState::Unloaded;
+        cell.failed = true;
+        return;
+    }
+    cell.state = CellState::Resident;
+    m_stats.residentBytes += cell.bytes;
+    ++m_stats.residentCells;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "StageBundle.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+class StageStreamer {
+public:
+    typedef StageBundle::Variant Variant;
+
+    struct Settings {
+        float loadRadius;
+        float unloadRadius;
+        size_t memoryBudget;
+        size_t maxConcurrentLoads;
+
+        Settings() : loadRadius(60.0f), unloadRadius(80.0f), memoryBudget(256 * 1024 * 1024), maxConcurrentLoads(4) {}
+    };
+
+    enum class CellState {
+        Unloaded,
+        Loading,
+        Resident
+    };
+
+    struct Stats {
+        size_t residentCells;
+        size_t loadingCells;
+        size_t residentBytes;
+        size_t loadingBytes;
+        size_t bundleBytes;
+        size_t peakBytes;
+        size_t loadsIssued;
+        size_t evictions;
+
+        Stats() : residentCells(0), loadingCells(0), residentBytes(0), loadingBytes(0), bundleBytes(0), peakBytes(0), loadsIssued(0), evictions(0) {}
+    };
+
+    StageStreamer();
+    ~StageStreamer();
+
+    StageStreamer(const StageStreamer&) = delete;
+    StageStreamer& operator=(const StageStreamer&) = delete;
+
+    bool Open(const StageBundle* bundle, Variant variant, ThreadPool* pool = nullptr);
+    void Close();
+
+    void Update(const std::vector<glm::vec3>& focusPoints, const std::function<void(const Model&)>& onEvict);
+    size_t GetResidentModels(std::vector<const Model*>& models) const;
+
+    void SetSettings(const Settings& settings) { m_settings = settings; }
+    const Settings& GetSettings() const { return m_settings; }
+    const Stats& GetStats() const { return m_stats; }
+    bool IsOpen() const { return m_bundle != nullptr; }
+    size_t GetCellCount() const { return m_cells.size(); }
+    CellState GetCellState(size_t index) const { return m_cells[index].state; }
+
+private:
+    struct Cell {
+        CellState state;
+        size_t bytes;
+        float distance;
+        bool failed;
+        std::unique_ptr<Model> model;
+        std::future<bool> pending;
+
+        Cell() : state(CellState::Unloaded), bytes(0), distance(0.0f), failed(false) {}
+    };
+
+    static float DistanceToBounds(const glm::vec3& point, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    void UpdateDistances(const std::vector<glm::vec3>& focusPoints);
+    void CompleteLoads();
+    void Evict(size_t index, const std::function<void(const Model&)>& onEvict);
+    bool MakeRoom(size_t bytes, float distance, const std::function<void(const Model&)>& onEvict);
+    void IssueLoad(size_t index);
+    void FinishLoad(size_t index, bool success);
+
+    const StageBundle* m_bundle;
+    Variant m_variant;
+    ThreadPool* m_pool;
+    Settings m_settings;
+    Stats m_stats;
+    std::vector<Cell> m_cells;
+};
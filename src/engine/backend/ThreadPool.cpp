@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount) : m_stopping(false) {
+    if (threadCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& body, size_t minBatchSize) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t participants = m_workers.size() + 1;
+    size_t batchSize = std::max(minBatchSize, (count + participants * 4 - 1) / (participants * 4));
+    size_t batchCount = (count + batchSize - 1) / batchSize;
+
+    if (batchCount == 1) {
+        body(0, count);
+        return;
+    }
+
+    struct SharedState {
+        std::atomic<size_t> nextBatch;
+        std::atomic<size_t> finishedBatches;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::function<void(size_t, size_t)> body;
+    };
+
+    auto state = std::make_shared<SharedState>();
+    state->nextBatch = 0;
+    state->finishedBatches = 0;
+    state->body = body;
+
+    auto runBatches = [state, count, batchSize, batchCount]() {
+        for (;;) {
+            size_t batch = state->nextBatch.fetch_add(1);
+            if (batch >= batchCount) {
+                return;
+            }
+            size_t begin = batch * batchSize;
+            size_t end = std::min(count, begin + batchSize);
+            state->body(begin, end);
+            if (state->finishedBatches.fetch_add(1) + 1 == batchCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(m_workers.size(), batchCount - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        Enqueue(runBatches);
+    }
+
+    runBatches();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state, batchCount]() { return state->finishedBatches.load() == batchCount; });
+}
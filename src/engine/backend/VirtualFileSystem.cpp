@@ -0,0 +1,216 @@
+#include "VirtualFileSystem.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <sys/stat.h>
+
+VirtualFileSystem::VirtualFileSystem()
+    : m_reader(new AsyncFileReader()) {
+}
+
+VirtualFileSystem& VirtualFileSystem::GetDefault() {
+    static VirtualFileSystem fileSystem;
+    return fileSystem;
+}
+
+bool VirtualFileSystem::MountDirectory(const std::string& directory, const std::string& prefix) {
+    struct stat st;
+    if (stat(directory.c_str(), &st) != 0 || (st.st_mode & S_IFMT) != S_IFDIR) {
+        std::cerr << "VirtualFileSystem: cannot mount missing directory " << directory << std::endl;
+        return false;
+    }
+
+    Mount mount;
+    mount.prefix = PackArchive::NormalizePath(prefix);
+    mount.directory = directory;
+    m_mounts.push_back(std::move(mount));
+    std::cout << "Mounted directory " << directory << " at /" << m_mounts.back().prefix << std::endl;
+    return true;
+}
+
+bool VirtualFileSystem::MountArchive(const std::string& archivePath, const std::string& prefix) {
+    std::unique_ptr<PackArchive> archive(new PackArchive());
+    if (!archive->Open(archivePath)) {
+        return false;
+    }
+
+    Mount mount;
+    mount.prefix = PackArchive::NormalizePath(prefix);
+    mount.archive = std::move(archive);
+    std::cout << "Mounted archive " << archivePath << " at /" << mount.prefix << " ("
+              << mount.archive->GetEntries().size() << " files, " << mount.archive->GetTotalSize() / 1024 << " KB)" << std::endl;
+    m_mounts.push_back(std::move(mount));
+    return true;
+}
+
+void VirtualFileSystem::UnmountAll() {
+    m_mounts.clear();
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) const {
+    std::string realPath;
+    const PackArchive* archive = nullptr;
+    return ResolveLoosePath(path, realPath) || FindArchiveEntry(path, archive) != nullptr;
+}
+
+bool VirtualFileSystem::ResolveLoosePath(const std::string& path, std::string& realPath) const {
+    std::string normalized = PackArchive::NormalizePath(path);
+    std::string relative;
+    for (const auto& mount : m_mounts) {
+        if (mount.archive || !MatchPrefix(normalized, mount.prefix, relative)) {
+            continue;
+        }
+        std::string candidate = mount.directory + "/" + relative;
+        if (IsRegularFile(candidate)) {
+            realPath = candidate;
+            return true;
+        }
+    }
+
+    const PackArchive* archive = nullptr;
+    if (FindArchiveEntry(normalized, archive)) {
+        return false;
+    }
+    if (IsRegularFile(path)) {
+        realPath = path;
+        return true;
+    }
+    return false;
+}
+
+bool VirtualFileSystem::GetFileSize(const std::string& path, uint64_t& size) const {
+    std::string realPath;
+    if (ResolveLoosePath(path, realPath)) {
+        struct stat st;
+        if (stat(realPath.c_str(), &st) != 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(st.st_size);
+        return true;
+    }
+
+    const PackArchive* archive = nullptr;
+    const PackArchive::Entry* entry = FindArchiveEntry(path, archive);
+    if (!entry) {
+        return false;
+    }
+    size = entry->size;
+    return true;
+}
+
+bool VirtualFileSystem::ReadFile(const std::string& path, std::vector<char>& data) const {
+    std::string realPath;
+    if (ResolveLoosePath(path, realPath)) {
+        std::vector<ReadRequest> requests(1, ReadRequest(realPath));
+        if (m_reader->ReadBatch(requests) == 0) {
+            return false;
+        }
+        data.swap(requests[0].data);
+        return true;
+    }
+
+    const PackArchive* archive = nullptr;
+    const PackArchive::Entry* entry = FindArchiveEntry(path, archive);
+    return entry && archive->Read(*entry, data);
+}
+
+bool VirtualFileSystem::ReadText(const std::string& path, std::string& text) const {
+    std::vector<char> data;
+    if (!ReadFile(path, data)) {
+        return false;
+    }
+    text.assign(data.begin(), data.end());
+    return true;
+}
+
+bool VirtualFileSystem::GetArchiveView(const std::string& path, const char*& data, size_t& size) const {
+    std::string realPath;
+    if (ResolveLoosePath(path, realPath)) {
+        return false;
+    }
+    const PackArchive* archive = nullptr;
+    const PackArchive::Entry* entry = FindArchiveEntry(path, archive);
+    return entry && archive->GetView(*entry, data, size);
+}
+
+size_t VirtualFileSystem::ReadFiles(std::vector<ReadRequest>& requests, ThreadPool* pool) const {
+    std::vector<ReadRequest> looseRequests;
+    std::vector<size_t> looseIndices;
+    std::vector<size_t> archiveIndices;
+    std::vector<std::pair<const PackArchive*, const PackArchive::Entry*>> archiveEntries;
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        ReadRequest& request = requests[i];
+        request.success = false;
+        request.data.clear();
+
+        std::string realPath;
+        if (ResolveLoosePath(request.path, realPath)) {
+            looseRequests.emplace_back(realPath);
+            looseIndices.push_back(i);
+            continue;
+        }
+
+        const PackArchive* archive = nullptr;
+        if (const PackArchive::Entry* entry = FindArchiveEntry(request.path, archive)) {
+            archiveIndices.push_back(i);
+            archiveEntries.emplace_back(archive, entry);
+        }
+    }
+
+    m_reader->ReadBatch(looseRequests, pool);
+    for (size_t i = 0; i < looseRequests.size(); ++i) {
+        ReadRequest& request = requests[looseIndices[i]];
+        request.data.swap(looseRequests[i].data);
+        request.success = looseRequests[i].success;
+    }
+
+    auto readArchive = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ReadRequest& request = requests[archiveIndices[i]];
+            request.success = archiveEntries[i].first->Read(*archiveEntries[i].second, request.data);
+        }
+    };
+    if (pool && archiveIndices.size() > 1) {
+        pool->ParallelFor(archiveIndices.size(), readArchive);
+    } else {
+        readArchive(0, archiveIndices.size());
+    }
+
+    size_t succeeded = 0;
+    for (const auto& request : requests) {
+        succeeded += request.success ? 1 : 0;
+    }
+    return succeeded;
+}
+
+bool VirtualFileSystem::MatchPrefix(const std::string& path, const std::string& prefix, std::string& relative) {
+    if (prefix.empty()) {
+        relative = path;
+        return true;
+    }
+    if (path.compare(0, prefix.size(), prefix) != 0 || path.size() <= prefix.size() || path[prefix.size()] != '/') {
+        return false;
+    }
+    relative = path.substr(prefix.size() + 1);
+    return true;
+}
+
+bool VirtualFileSystem::IsRegularFile(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG;
+}
+
+const PackArchive::Entry* VirtualFileSystem::FindArchiveEntry(const std::string& path, const PackArchive*& archive) const {
+    std::string normalized = PackArchive::NormalizePath(path);
+    std::string relative;
+    for (const auto& mount : m_mounts) {
+        if (!mount.archive || !MatchPrefix(normalized, mount.prefix, relative)) {
+            continue;
+        }
+        if (const PackArchive::Entry* entry = mount.archive->Find(relative)) {
+            archive = mount.archive.get();
+            return entry;
+        }
+    }
+    return nullptr;
+}
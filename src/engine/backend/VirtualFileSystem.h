@@ -0,0 +1,50 @@
+#pragma once
+
+#include "AsyncFileReader.h"
+#include "PackArchive.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+class VirtualFileSystem {
+public:
+    typedef AsyncFileReader::Request ReadRequest;
+
+    VirtualFileSystem();
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    static VirtualFileSystem& GetDefault();
+
+    bool MountDirectory(const std::string& directory, const std::string& prefix = "");
+    bool MountArchive(const std::string& archivePath, const std::string& prefix = "");
+    void UnmountAll();
+
+    bool Exists(const std::string& path) const;
+    bool ResolveLoosePath(const std::string& path, std::string& realPath) const;
+    bool GetFileSize(const std::string& path, uint64_t& size) const;
+    bool ReadFile(const std::string& path, std::vector<char>& data) const;
+    bool ReadText(const std::string& path, std::string& text) const;
+    bool GetArchiveView(const std::string& path, const char*& data, size_t& size) const;
+    size_t ReadFiles(std::vector<ReadRequest>& requests, ThreadPool* pool = nullptr) const;
+
+    size_t GetMountCount() const { return m_mounts.size(); }
+    bool IsUsingIoUring() const { return m_reader->IsUsingIoUring(); }
+
+private:
+    struct Mount {
+        std::string prefix;
+        std::string directory;
+        std::unique_ptr<PackArchive> archive;
+    };
+
+    static bool MatchPrefix(const std::string& path, const std::string& prefix, std::string& relative);
+    static bool IsRegularFile(const std::string& path);
+    const PackArchive::Entry* FindArchiveEntry(const std::string& path, const PackArchive*& archive) const;
+
+    std::vector<Mount> m_mounts;
+    std::unique_ptr<AsyncFileReader> m_reader;
+};
@@ -5,8 +5,9 @@
 const std::string BackgroundRenderer::DEFAULT_VERTEX_SHADER = "assets/shaders/background/default.vert";
 const std::string BackgroundRenderer::DEFAULT_FRAGMENT_SHADER = "assets/shaders/background/default.frag";
 
-BackgroundRenderer::BackgroundRenderer() 
+BackgroundRenderer::BackgroundRenderer(GLStateCache& state) 
     : m_initialized(false)
+    , m_state(state)
     , m_VAO(0)
     , m_VBO(0)
     , m_EBO(0)
@@ -41,7 +42,8 @@ void BackgroundRenderer::Shutdown() {
     }
     
     DeleteBackgroundMesh();
-    m_shader.reset();
+    m_shaders.Clear();
+    m_activeShader = AssetHandle();
     m_initialized = false;
 }
 
@@ -50,6 +52,7 @@ void BackgroundRenderer::Render() {
         return;
     }
     
+    m_shaders.Collect();
     if (HasShader()) {
         RenderWithShader();
     } else {
@@ -58,15 +61,55 @@ void BackgroundRenderer::Render() {
 }
 
 bool BackgroundRenderer::LoadShader(const std::string& vertexPath, const std::string& fragmentPath) {
-    m_shader = std::make_unique<Shader>();
-    if (!m_shader->CreateFromFiles(vertexPath, fragmentPath)) {
-        std::cerr << "Warning: Failed to load background shader from files. Using fallback rendering." << std::endl;
-        m_shader.reset();
+    std::string key = vertexPath + "|" + fragmentPath;
+    AssetHandle handle = m_shaders.Find(key);
+    if (!handle.IsValid()) {
+        std::unique_ptr<Shader> shader = std::make_unique<Shader>();
+        if (!shader->CreateFromFiles(vertexPath, fragmentPath)) {
+            std::cerr << "Warning: Failed to load background shader from files. Using fallback rendering." << std::endl;
+            m_activeShader = AssetHandle();
+            m_vertexPath.clear();
+            m_fragmentPath.clear();
+            return false;
+        }
+        handle = m_shaders.Add(key, std::move(shader));
+    }
+    m_activeShader = handle;
+    m_vertexPath = vertexPath;
+    m_fragmentPath = fragmentPath;
+    return true;
+}
+
+bool BackgroundRenderer::ReloadShader() {
+    if (m_vertexPath.empty() || m_fragmentPath.empty()) {
+        return false;
+    }
+    
+    std::unique_ptr<Shader> shader = std::make_unique<Shader>();
+    if (!shader->CreateFromFiles(m_vertexPath, m_fragmentPath)) {
+        std::cerr << "Warning: Failed to reload background shader, keeping previous version" << std::endl;
         return false;
     }
+    m_shaders.Replace(m_activeShader, std::move(shader));
     return true;
 }
 
+bool BackgroundRenderer::HasShader() const {
+    const Shader* shader = m_shaders.Get(m_activeShader);
+    return shader && shader->IsValid();
+}
+
+bool BackgroundRenderer::UsesShaderFile(const std::string& path) const {
+    return !path.empty() && (path == m_vertexPath || path == m_fragmentPath);
+}
+
+void BackgroundRenderer::GetShaderFiles(std::vector<std::string>& files) const {
+    if (!m_vertexPath.empty()) {
+        files.push_back(m_vertexPath);
+        files.push_back(m_fragmentPath);
+    }
+}
+
 bool BackgroundRenderer::LoadShader(const std::string& shaderName) {
     std::string vertexPath = "assets/shaders/background/" + shaderName + ".vert";
     std::string fragmentPath = "assets/shaders/background/" + shaderName + ".frag";
@@ -105,12 +148,12 @@ bool BackgroundRenderer::CreateBackgroundMesh() {
     glGenBuffers(1, &m_VBO);
     glGenBuffers(1, &m_EBO);
     
-    glBindVertexArray(m_VAO);
+    m_state.BindVertexArray(m_VAO);
     
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    m_state.BindBuffer(GL_ARRAY_BUFFER, m_VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    m_state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
     
     glEnableVertexAttribArray(0);
@@ -119,49 +162,36 @@ bool BackgroundRenderer::CreateBackgroundMesh() {
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
     
-    glBindVertexArray(0);
-    
     return true;
 }
 
 void BackgroundRenderer::DeleteBackgroundMesh() {
-    if (m_VAO != 0) {
-        glDeleteVertexArrays(1, &m_VAO);
-        m_VAO = 0;
-    }
-    
-    if (m_VBO != 0) {
-        glDeleteBuffers(1, &m_VBO);
-        m_VBO = 0;
-    }
-    
-    if (m_EBO != 0) {
-        glDeleteBuffers(1, &m_EBO);
-        m_EBO = 0;
-    }
+    m_state.DeleteVertexArray(m_VAO);
+    m_state.DeleteBuffer(m_VBO);
+    m_state.DeleteBuffer(m_EBO);
 }
 
 void BackgroundRenderer::RenderWithShader() {
-    if (!m_shader || !m_shader->IsValid()) {
+    Shader* shader = m_shaders.Get(m_activeShader);
+    if (!shader || !shader->IsValid()) {
         RenderWithoutShader();
         return;
     }
     
-    glDisable(GL_DEPTH_TEST);
-    m_shader->Use();
+    m_state.SetEnabled(GL_DEPTH_TEST, false);
+    m_state.SetEnabled(GL_BLEND, false);
+    m_state.UseProgram(shader->GetProgramID());
     
     if (m_useGradient) {
-        m_shader->SetVec4("topColor", m_topGradientColor);
-        m_shader->SetVec4("bottomColor", m_bottomGradientColor);
+        shader->SetVec4("topColor", m_topGradientColor);
+        shader->SetVec4("bottomColor", m_bottomGradientColor);
     } else {
-        m_shader->SetVec4("color", m_solidColor);
+        shader->SetVec4("color", m_solidColor);
     }
-    m_shader->SetFloat("time", m_time);
+    shader->SetFloat("time", m_time);
     
-    glBindVertexArray(m_VAO);
+    m_state.BindVertexArray(m_VAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);    
-    glEnable(GL_DEPTH_TEST);
 }
 
 void BackgroundRenderer::RenderWithoutShader() {
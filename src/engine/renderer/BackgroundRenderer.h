@@ -4,11 +4,14 @@
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 #include "Shader.h"
+#include "GLStateCache.h"
+#include "../backend/AssetRegistry.h"
 
 class BackgroundRenderer {
 public:
-    BackgroundRenderer();
+    explicit BackgroundRenderer(GLStateCache& state);
     ~BackgroundRenderer();
 
     bool Initialize();
@@ -17,11 +20,15 @@ public:
     
     bool LoadShader(const std::string& vertexPath, const std::string& fragmentPath);
     bool LoadShader(const std::string& shaderName);    
+    bool ReloadShader();
+    bool UsesShaderFile(const std::string& path) const;
+    void GetShaderFiles(std::vector<std::string>& files) const;
     void SetColor(const glm::vec4& color);
     void SetGradient(const glm::vec4& topColor, const glm::vec4& bottomColor);
     void SetTime(float time);
     bool IsInitialized() const { return m_initialized; }
-    bool HasShader() const { return m_shader && m_shader->IsValid(); }
+    bool HasShader() const;
+    size_t GetCachedShaderCount() const { return m_shaders.GetCount(); }
 
 private:
     bool CreateBackgroundMesh();
@@ -31,8 +38,12 @@ private:
 
 private:
     bool m_initialized;
+    GLStateCache& m_state;
     
-    std::unique_ptr<Shader> m_shader;
+    AssetRegistry<Shader> m_shaders;
+    AssetHandle m_activeShader;
+    std::string m_vertexPath;
+    std::string m_fragmentPath;
     
     GLuint m_VAO;
     GLuint m_VBO;
@@ -0,0 +1,265 @@
+#include "FrustumCuller.h"
+#include "../backend/MeshKernels.h"
+#include "../backend/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PF_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#if defined(PF_X86_SIMD) && defined(__GNUC__)
+#define PF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PF_TARGET_AVX2
+#endif
+
+const size_t FrustumCuller::PLANE_COUNT;
+const size_t FrustumCuller::PARALLEL_THRESHOLD;
+const size_t FrustumCuller::JOB_BATCH_SIZE;
+
+namespace {
+
+struct Streams {
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* extentX;
+    const float* extentY;
+    const float* extentZ;
+    const float* radius;
+    uint8_t* visible;
+};
+
+size_t CountBits(unsigned int mask) {
+    size_t count = 0;
+    for (; mask != 0; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+size_t CullScalar(const Streams& in, const FrustumCuller::Frustum& planes, size_t begin, size_t end) {
+    size_t visible = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (size_t p = 0; p < FrustumCuller::PLANE_COUNT && inside; ++p) {
+            float distance = planes.normalX[p] * in.centerX[i] + planes.normalY[p] * in.centerY[i] +
+                             planes.normalZ[p] * in.centerZ[i] + planes.distance[p];
+            float projected = std::fabs(planes.normalX[p]) * in.extentX[i] + std::fabs(planes.normalY[p]) * in.extentY[i] +
+                              std::fabs(planes.normalZ[p]) * in.extentZ[i];
+            inside = distance >= -in.radius[i] && distance >= -projected;
+        }
+        in.visible[i] = inside ? 1 : 0;
+        visible += inside ? 1 : 0;
+    }
+    return visible;
+}
+
+#if defined(PF_X86_SIMD)
+
+size_t CullSSE2(const Streams& in, const FrustumCuller::Frustum& planes, size_t begin, size_t end) {
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    size_t visible = 0;
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 cx = _mm_loadu_ps(in.centerX + i);
+        __m128 cy = _mm_loadu_ps(in.centerY + i);
+        __m128 cz = _mm_loadu_ps(in.centerZ + i);
+        __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(in.radius + i));
+
+        __m128 distances[FrustumCuller::PLANE_COUNT];
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t p = 0; p < FrustumCuller::PLANE_COUNT; ++p) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalX[p]), cx), _mm_set1_ps(planes.distance[p]));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.normalY[p]), cy));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.normalZ[p]), cz));
+            distances[p] = d;
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negativeRadius));
+        }
+
+        if (_mm_movemask_ps(inside) != 0) {
+            __m128 ex = _mm_loadu_ps(in.extentX + i);
+            __m128 ey = _mm_loadu_ps(in.extentY + i);
+            __m128 ez = _mm_loadu_ps(in.extentZ + i);
+            for (size_t p = 0; p < FrustumCuller::PLANE_COUNT; ++p) {
+                __m128 projected = _mm_mul_ps(_mm_and_ps(_mm_set1_ps(planes.normalX[p]), signMask), ex);
+                projected = _mm_add_ps(projected, _mm_mul_ps(_mm_and_ps(_mm_set1_ps(planes.normalY[p]), signMask), ey));
+                projected = _mm_add_ps(projected, _mm_mul_ps(_mm_and_ps(_mm_set1_ps(planes.normalZ[p]), signMask), ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distances[p], projected), _mm_setzero_ps()));
+            }
+        }
+
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(inside));
+        for (size_t lane = 0; lane < 4; ++lane) {
+            in.visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+        visible += CountBits(mask);
+    }
+
+    return visible + CullScalar(in, planes, i, end);
+}
+
+PF_TARGET_AVX2 size_t CullAVX2(const Streams& in, const FrustumCuller::Frustum& planes, size_t begin, size_t end) {
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    size_t visible = 0;
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 cx = _mm256_loadu_ps(in.centerX + i);
+        __m256 cy = _mm256_loadu_ps(in.centerY + i);
+        __m256 cz = _mm256_loadu_ps(in.centerZ + i);
+        __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(in.radius + i));
+
+        __m256 distances[FrustumCuller::PLANE_COUNT];
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < FrustumCuller::PLANE_COUNT; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.normalX[p]), cx), _mm256_set1_ps(planes.distance[p]));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.normalY[p]), cy));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.normalZ[p]), cz));
+            distances[p] = d;
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negativeRadius, _CMP_GE_OQ));
+        }
+
+        if (_mm256_movemask_ps(inside) != 0) {
+            __m256 ex = _mm256_loadu_ps(in.extentX + i);
+            __m256 ey = _mm256_loadu_ps(in.extentY + i);
+            __m256 ez = _mm256_loadu_ps(in.extentZ + i);
+            for (size_t p = 0; p < FrustumCuller::PLANE_COUNT; ++p) {
+                __m256 projected = _mm256_mul_ps(_mm256_and_ps(_mm256_set1_ps(planes.normalX[p]), signMask), ex);
+                projected = _mm256_add_ps(projected, _mm256_mul_ps(_mm256_and_ps(_mm256_set1_ps(planes.normalY[p]), signMask), ey));
+                projected = _mm256_add_ps(projected, _mm256_mul_ps(_mm256_and_ps(_mm256_set1_ps(planes.normalZ[p]), signMask), ez));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distances[p], projected), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+        }
+
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(inside));
+        for (size_t lane = 0; lane < 8; ++lane) {
+            in.visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+        visible += CountBits(mask);
+    }
+
+    return visible + CullScalar(in, planes, i, end);
+}
+
+#endif
+
+}
+
+FrustumCuller::FrustumCuller() {
+    SetFrustum(glm::mat4(1.0f));
+}
+
+void FrustumCuller::Clear() {
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+    m_radius.clear();
+    m_visible.clear();
+}
+
+void FrustumCuller::Reserve(size_t count) {
+    m_centerX.reserve(count);
+    m_centerY.reserve(count);
+    m_centerZ.reserve(count);
+    m_extentX.reserve(count);
+    m_extentY.reserve(count);
+    m_extentZ.reserve(count);
+    m_radius.reserve(count);
+    m_visible.reserve(count);
+}
+
+size_t FrustumCuller::Add(const glm::vec3& center, const glm::vec3& extent, const glm::mat4& transform) {
+    glm::vec3 worldCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+    glm::vec3 axisX = glm::vec3(transform[0]);
+    glm::vec3 axisY = glm::vec3(transform[1]);
+    glm::vec3 axisZ = glm::vec3(transform[2]);
+    glm::vec3 worldExtent = glm::abs(axisX) * extent.x + glm::abs(axisY) * extent.y + glm::abs(axisZ) * extent.z;
+
+    float scale = std::sqrt(std::max(glm::dot(axisX, axisX), std::max(glm::dot(axisY, axisY), glm::dot(axisZ, axisZ))));
+    float radius = std::min(glm::length(extent) * scale, glm::length(worldExtent));
+
+    m_centerX.push_back(worldCenter.x);
+    m_centerY.push_back(worldCenter.y);
+    m_centerZ.push_back(worldCenter.z);
+    m_extentX.push_back(worldExtent.x);
+    m_extentY.push_back(worldExtent.y);
+    m_extentZ.push_back(worldExtent.z);
+    m_radius.push_back(radius);
+    m_visible.push_back(1);
+    return m_centerX.size() - 1;
+}
+
+void FrustumCuller::SetFrustum(const glm::mat4& viewProjection) {
+    glm::vec4 w(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+    for (int axis = 0; axis < 3; ++axis) {
+        glm::vec4 row(viewProjection[0][axis], viewProjection[1][axis], viewProjection[2][axis], viewProjection[3][axis]);
+        glm::vec4 planes[2] = { w + row, w - row };
+        for (int side = 0; side < 2; ++side) {
+            glm::vec4 plane = planes[side];
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) {
+                plane /= length;
+            }
+            size_t index = axis * 2 + side;
+            m_frustum.normalX[index] = plane.x;
+            m_frustum.normalY[index] = plane.y;
+            m_frustum.normalZ[index] = plane.z;
+            m_frustum.distance[index] = plane.w;
+        }
+    }
+}
+
+void FrustumCuller::Cull(ThreadPool* pool) {
+    m_stats = Stats();
+    size_t count = GetCount();
+    if (count == 0) {
+        return;
+    }
+
+    m_stats.tested = count;
+    if (pool && count >= PARALLEL_THRESHOLD) {
+        std::atomic<size_t> visible(0);
+        std::atomic<size_t> jobs(0);
+        pool->ParallelFor(count, [this, &visible, &jobs](size_t begin, size_t end) {
+            visible += CullRange(begin, end);
+            ++jobs;
+        }, JOB_BATCH_SIZE);
+        m_stats.visible = visible;
+        m_stats.jobs = jobs;
+    } else {
+        m_stats.visible = CullRange(0, count);
+        m_stats.jobs = 1;
+    }
+    m_stats.culled = count - m_stats.visible;
+}
+
+size_t FrustumCuller::CullRange(size_t begin, size_t end) {
+    Streams in;
+    in.centerX = m_centerX.data();
+    in.centerY = m_centerY.data();
+    in.centerZ = m_centerZ.data();
+    in.extentX = m_extentX.data();
+    in.extentY = m_extentY.data();
+    in.extentZ = m_extentZ.data();
+    in.radius = m_radius.data();
+    in.visible = m_visible.data();
+
+#if defined(PF_X86_SIMD)
+    MeshKernels::SimdLevel level = MeshKernels::GetSimdLevel();
+    if (level == MeshKernels::SimdLevel::AVX2) {
+        return CullAVX2(in, m_frustum, begin, end);
+    }
+    if (level == MeshKernels::SimdLevel::SSE2) {
+        return CullSSE2(in, m_frustum, begin, end);
+    }
+#endif
+    return CullScalar(in, m_frustum, begin, end);
+}
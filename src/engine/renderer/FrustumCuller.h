@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+class FrustumCuller {
+public:
+    static const size_t PLANE_COUNT = 6;
+    static const size_t PARALLEL_THRESHOLD = 16384;
+    static const size_t JOB_BATCH_SIZE = 4096;
+
+    struct Stats {
+        size_t tested;
+        size_t visible;
+        size_t culled;
+        size_t jobs;
+
+        Stats() : tested(0), visible(0), culled(0), jobs(0) {}
+    };
+
+    struct Frustum {
+        float normalX[PLANE_COUNT];
+        float normalY[PLANE_COUNT];
+        float normalZ[PLANE_COUNT];
+        float distance[PLANE_COUNT];
+    };
+
+    FrustumCuller();
+
+    void Clear();
+    void Reserve(size_t count);
+    size_t Add(const glm::vec3& center, const glm::vec3& extent, const glm::mat4& transform);
+    void SetFrustum(const glm::mat4& viewProjection);
+    void Cull(ThreadPool* pool = nullptr);
+
+    bool IsVisible(size_t index) const { return m_visible[index] != 0; }
+    size_t GetCount() const { return m_centerX.size(); }
+    const Frustum& GetFrustum() const { return m_frustum; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    size_t CullRange(size_t begin, size_t end);
+
+    Frustum m_frustum;
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_centerZ;
+    std::vector<float> m_extentX;
+    std::vector<float> m_extentY;
+    std::vector<float> m_extentZ;
+    std::vector<float> m_radius;
+    std::vector<uint8_t> m_visible;
+    Stats m_stats;
+};
@@ -0,0 +1,227 @@
+#include "GLStateCache.h"
+
+namespace {
+
+const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+}
+
+GLStateCache::GLStateCache() {
+    Invalidate();
+}
+
+void GLStateCache::Invalidate() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    for (GLuint& buffer : m_buffers) {
+        buffer = UNKNOWN;
+    }
+    for (GLuint& binding : m_uniformBindings) {
+        binding = UNKNOWN;
+    }
+    m_activeTexture = UNKNOWN;
+    for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+        m_textureTargets[unit] = UNKNOWN;
+        m_textures[unit] = UNKNOWN;
+    }
+    for (Tristate& capability : m_capabilities) {
+        capability = Tristate::Unknown;
+    }
+    m_blendSource = UNKNOWN;
+    m_blendDestination = UNKNOWN;
+    m_depthMask = Tristate::Unknown;
+    m_depthFunc = UNKNOWN;
+    m_viewport = glm::ivec4(-1);
+}
+
+void GLStateCache::BeginFrame() {
+    m_lastFrame = m_current;
+    m_current = Stats();
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+    if (Changed(m_program != program)) {
+        glUseProgram(program);
+        m_program = program;
+    }
+}
+
+void GLStateCache::BindVertexArray(GLuint vao) {
+    if (Changed(m_vertexArray != vao)) {
+        glBindVertexArray(vao);
+        m_vertexArray = vao;
+        m_buffers[ElementArrayBuffer] = UNKNOWN;
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+    int slot = GetBufferSlot(target);
+    if (slot < 0) {
+        Changed(true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Changed(m_buffers[slot] != buffer)) {
+        glBindBuffer(target, buffer);
+        m_buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::BindUniformBuffer(GLuint binding, GLuint buffer) {
+    if (binding < MAX_UNIFORM_BINDINGS && !Changed(m_uniformBindings[binding] != buffer)) {
+        return;
+    }
+    if (binding >= MAX_UNIFORM_BINDINGS) {
+        Changed(true);
+    } else {
+        m_uniformBindings[binding] = buffer;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+    m_buffers[UniformBuffer] = buffer;
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        Changed(true);
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        m_activeTexture = unit;
+        return;
+    }
+    if (m_textureTargets[unit] == target && m_textures[unit] == texture) {
+        Changed(false);
+        return;
+    }
+    if (Changed(m_activeTexture != unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeTexture = unit;
+    }
+    Changed(true);
+    glBindTexture(target, texture);
+    m_textureTargets[unit] = target;
+    m_textures[unit] = texture;
+}
+
+void GLStateCache::SetEnabled(GLenum capability, bool enabled) {
+    int slot = GetCapabilitySlot(capability);
+    Tristate state = enabled ? Tristate::On : Tristate::Off;
+    if (slot >= 0 && !Changed(m_capabilities[slot] != state)) {
+        return;
+    }
+    if (slot < 0) {
+        Changed(true);
+    } else {
+        m_capabilities[slot] = state;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GLStateCache::SetBlendFunc(GLenum source, GLenum destination) {
+    if (Changed(m_blendSource != source || m_blendDestination != destination)) {
+        glBlendFunc(source, destination);
+        m_blendSource = source;
+        m_blendDestination = destination;
+    }
+}
+
+void GLStateCache::SetDepthMask(bool enabled) {
+    Tristate state = enabled ? Tristate::On : Tristate::Off;
+    if (Changed(m_depthMask != state)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        m_depthMask = state;
+    }
+}
+
+void GLStateCache::SetDepthFunc(GLenum func) {
+    if (Changed(m_depthFunc != func)) {
+        glDepthFunc(func);
+        m_depthFunc = func;
+    }
+}
+
+void GLStateCache::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    glm::ivec4 viewport(x, y, width, height);
+    if (Changed(m_viewport != viewport)) {
+        glViewport(x, y, width, height);
+        m_viewport = viewport;
+    }
+}
+
+void GLStateCache::DeleteVertexArray(GLuint& vao) {
+    if (vao == 0) {
+        return;
+    }
+    if (m_vertexArray == vao) {
+        m_vertexArray = 0;
+        m_buffers[ElementArrayBuffer] = UNKNOWN;
+    }
+    glDeleteVertexArrays(1, &vao);
+    vao = 0;
+}
+
+void GLStateCache::DeleteBuffer(GLuint& buffer) {
+    if (buffer == 0) {
+        return;
+    }
+    for (GLuint& bound : m_buffers) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+    for (GLuint& bound : m_uniformBindings) {
+        if (bound == buffer) {
+            bound = 0;
+        }
+    }
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+}
+
+void GLStateCache::DeleteTexture(GLuint& texture) {
+    if (texture == 0) {
+        return;
+    }
+    for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+        if (m_textures[unit] == texture) {
+            m_textures[unit] = 0;
+        }
+    }
+    glDeleteTextures(1, &texture);
+    texture = 0;
+}
+
+int GLStateCache::GetBufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: return ArrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER: return ElementArrayBuffer;
+        case GL_COPY_READ_BUFFER: return CopyReadBuffer;
+        case GL_COPY_WRITE_BUFFER: return CopyWriteBuffer;
+        case GL_DRAW_INDIRECT_BUFFER: return DrawIndirectBuffer;
+        case GL_UNIFORM_BUFFER: return UniformBuffer;
+        default: return -1;
+    }
+}
+
+int GLStateCache::GetCapabilitySlot(GLenum capability) {
+    switch (capability) {
+        case GL_BLEND: return Blend;
+        case GL_DEPTH_TEST: return DepthTest;
+        case GL_CULL_FACE: return CullFace;
+        case GL_SCISSOR_TEST: return ScissorTest;
+        default: return -1;
+    }
+}
+
+bool GLStateCache::Changed(bool changed) {
+    if (changed) {
+        ++m_current.issued;
+    } else {
+        ++m_current.skipped;
+    }
+    return changed;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+class GLStateCache {
+public:
+    static const GLuint MAX_TEXTURE_UNITS = 16;
+    static const GLuint MAX_UNIFORM_BINDINGS = 16;
+
+    struct Stats {
+        size_t issued;
+        size_t skipped;
+
+        Stats() : issued(0), skipped(0) {}
+    };
+
+    GLStateCache();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    void Invalidate();
+    void BeginFrame();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindUniformBuffer(GLuint binding, GLuint buffer);
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    void SetEnabled(GLenum capability, bool enabled);
+    void SetBlendFunc(GLenum source, GLenum destination);
+    void SetDepthMask(bool enabled);
+    void SetDepthFunc(GLenum func);
+    void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    void DeleteVertexArray(GLuint& vao);
+    void DeleteBuffer(GLuint& buffer);
+    void DeleteTexture(GLuint& texture);
+
+    GLuint GetProgram() const { return m_program; }
+    GLuint GetVertexArray() const { return m_vertexArray; }
+    const Stats& GetFrameStats() const { return m_lastFrame; }
+    const Stats& GetCurrentStats() const { return m_current; }
+
+private:
+    enum BufferSlot {
+        ArrayBuffer,
+        ElementArrayBuffer,
+        CopyReadBuffer,
+        CopyWriteBuffer,
+        DrawIndirectBuffer,
+        UniformBuffer,
+        BufferSlotCount
+    };
+
+    enum CapabilitySlot {
+        Blend,
+        DepthTest,
+        CullFace,
+        ScissorTest,
+        CapabilitySlotCount
+    };
+
+    enum class Tristate : uint8_t {
+        Unknown,
+        Off,
+        On
+    };
+
+    static int GetBufferSlot(GLenum target);
+    static int GetCapabilitySlot(GLenum capability);
+    bool Changed(bool changed);
+
+    GLuint m_program;
+    GLuint m_vertexArray;
+    GLuint m_buffers[BufferSlotCount];
+    GLuint m_uniformBindings[MAX_UNIFORM_BINDINGS];
+    GLuint m_activeTexture;
+    GLenum m_textureTargets[MAX_TEXTURE_UNITS];
+    GLuint m_textures[MAX_TEXTURE_UNITS];
+    Tristate m_capabilities[CapabilitySlotCount];
+    GLenum m_blendSource;
+    GLenum m_blendDestination;
+    Tristate m_depthMask;
+    GLenum m_depthFunc;
+    glm::ivec4 m_viewport;
+
+    Stats m_current;
+    Stats m_lastFrame;
+};
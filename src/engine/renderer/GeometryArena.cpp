@@ -0,0 +1,216 @@
+#include "GeometryArena.h"
+#include "VertexLayout.h"
+#include <algorithm>
+#include <iostream>
+
+GeometryArena::GeometryArena(GLStateCache& state)
+    : m_state(state)
+    , m_format(VertexFormat::Packed)
+    , m_vertexSize(sizeof(PackedVertex))
+    , m_drawDataBuffer(0) {
+}
+
+GeometryArena::~GeometryArena() {
+    Shutdown();
+}
+
+void GeometryArena::Initialize(VertexFormat format, GLuint drawDataBuffer) {
+    Shutdown();
+    m_format = format;
+    m_vertexSize = format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    m_drawDataBuffer = drawDataBuffer;
+}
+
+void GeometryArena::Shutdown() {
+    for (auto& page : m_pages) {
+        DestroyPage(page);
+    }
+    m_pages.clear();
+}
+
+bool GeometryArena::Allocate(size_t vertexCount, size_t indexCount, GLenum indexType, Allocation& allocation) {
+    for (uint32_t i = 0; i < m_pages.size(); ++i) {
+        Page& page = m_pages[i];
+        if (page.VAO == 0 || page.indexType != indexType) {
+            continue;
+        }
+
+        size_t baseVertex = 0;
+        size_t firstIndex = 0;
+        if (!TakeRange(page.freeVertices, vertexCount, baseVertex)) {
+            continue;
+        }
+        if (!TakeRange(page.freeIndices, indexCount, firstIndex)) {
+            ReturnRange(page.freeVertices, baseVertex, vertexCount);
+            continue;
+        }
+
+        allocation.page = i;
+        allocation.baseVertex = baseVertex;
+        allocation.vertexCount = vertexCount;
+        allocation.firstIndex = firstIndex;
+        allocation.indexCount = indexCount;
+        ++page.allocationCount;
+        return true;
+    }
+
+    uint32_t pageIndex = INVALID_PAGE;
+    if (!CreatePage(indexType, vertexCount, indexCount, pageIndex)) {
+        return false;
+    }
+    return Allocate(vertexCount, indexCount, indexType, allocation);
+}
+
+void GeometryArena::Free(Allocation& allocation) {
+    if (!allocation.IsValid() || allocation.page >= m_pages.size()) {
+        allocation = Allocation();
+        return;
+    }
+
+    Page& page = m_pages[allocation.page];
+    ReturnRange(page.freeVertices, allocation.baseVertex, allocation.vertexCount);
+    ReturnRange(page.freeIndices, allocation.firstIndex, allocation.indexCount);
+    if (--page.allocationCount == 0) {
+        DestroyPage(page);
+    }
+    allocation = Allocation();
+}
+
+size_t GeometryArena::GetResidentPageCount() const {
+    size_t count = 0;
+    for (const auto& page : m_pages) {
+        if (page.VAO != 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t GeometryArena::GetCapacityBytes() const {
+    size_t bytes = 0;
+    for (const auto& page : m_pages) {
+        if (page.VAO != 0) {
+            bytes += page.vertexCapacity * m_vertexSize + page.indexCapacity * GetIndexSize(page.indexType);
+        }
+    }
+    return bytes;
+}
+
+void GeometryArena::BindDrawData(size_t firstDraw) {
+    m_state.BindBuffer(GL_ARRAY_BUFFER, m_drawDataBuffer);
+    size_t offset = firstDraw * sizeof(DrawData);
+    for (GLuint column = 0; column < DRAW_DATA_ATTRIBUTES; ++column) {
+        glVertexAttribPointer(DRAW_DATA_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof(DrawData),
+                              reinterpret_cast<const void*>(offset + column * sizeof(glm::vec4)));
+    }
+}
+
+bool GeometryArena::TakeRange(std::map<size_t, size_t>& freeRanges, size_t count, size_t& offset) {
+    if (count == 0) {
+        offset = 0;
+        return true;
+    }
+
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second < count) {
+            continue;
+        }
+        offset = it->first;
+        size_t remaining = it->second - count;
+        freeRanges.erase(it);
+        if (remaining > 0) {
+            freeRanges[offset + count] = remaining;
+        }
+        return true;
+    }
+    return false;
+}
+
+void GeometryArena::ReturnRange(std::map<size_t, size_t>& freeRanges, size_t offset, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.end() && offset + count == next->first) {
+        count += next->second;
+        next = freeRanges.erase(next);
+    }
+    if (next != freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += count;
+            return;
+        }
+    }
+    freeRanges[offset] = count;
+}
+
+bool GeometryArena::CreatePage(GLenum indexType, size_t vertexCount, size_t indexCount, uint32_t& pageIndex) {
+    size_t indexSize = GetIndexSize(indexType);
+    size_t vertexCapacity = std::max(vertexCount, PAGE_VERTEX_BYTES / m_vertexSize);
+    size_t indexCapacity = std::max(indexCount, PAGE_INDEX_BYTES / indexSize);
+
+    pageIndex = INVALID_PAGE;
+    for (uint32_t i = 0; i < m_pages.size(); ++i) {
+        if (m_pages[i].VAO == 0) {
+            pageIndex = i;
+            break;
+        }
+    }
+    if (pageIndex == INVALID_PAGE) {
+        pageIndex = static_cast<uint32_t>(m_pages.size());
+        m_pages.emplace_back();
+    }
+
+    Page& page = m_pages[pageIndex];
+    page.indexType = indexType;
+    page.vertexCapacity = vertexCapacity;
+    page.indexCapacity = indexCapacity;
+    page.allocationCount = 0;
+    page.freeVertices.clear();
+    page.freeIndices.clear();
+    page.freeVertices[0] = vertexCapacity;
+    page.freeIndices[0] = indexCapacity;
+
+    glGenVertexArrays(1, &page.VAO);
+    m_state.BindVertexArray(page.VAO);
+
+    glGenBuffers(1, &page.VBO);
+    m_state.BindBuffer(GL_ARRAY_BUFFER, page.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCapacity * m_vertexSize, nullptr, GL_STATIC_DRAW);
+    if (m_format == VertexFormat::Packed) {
+        PackedVertexLayout::Apply();
+    } else {
+        FullVertexLayout::Apply();
+    }
+
+    glGenBuffers(1, &page.EBO);
+    m_state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * indexSize, nullptr, GL_STATIC_DRAW);
+
+    for (GLuint column = 0; column < DRAW_DATA_ATTRIBUTES; ++column) {
+        glEnableVertexAttribArray(DRAW_DATA_LOCATION + column);
+        glVertexAttribDivisor(DRAW_DATA_LOCATION + column, 1);
+    }
+    BindDrawData(0);
+
+    if (glGetError() == GL_OUT_OF_MEMORY) {
+        std::cerr << "GeometryArena: out of memory creating a " << (vertexCapacity * m_vertexSize + indexCapacity * indexSize) / 1024
+                  << " KB page" << std::endl;
+        DestroyPage(page);
+        return false;
+    }
+    return true;
+}
+
+void GeometryArena::DestroyPage(Page& page) {
+    m_state.DeleteVertexArray(page.VAO);
+    m_state.DeleteBuffer(page.VBO);
+    m_state.DeleteBuffer(page.EBO);
+    page.freeVertices.clear();
+    page.freeIndices.clear();
+    page.vertexCapacity = 0;
+    page.indexCapacity = 0;
+    page.allocationCount = 0;
+}
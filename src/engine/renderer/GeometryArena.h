@@ -0,0 +1,84 @@
+#pragma once
+
+#include "VertexPacking.h"
+#include "GLStateCache.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class GeometryArena {
+public:
+    static const size_t PAGE_VERTEX_BYTES = 32 * 1024 * 1024;
+    static const size_t PAGE_INDEX_BYTES = 16 * 1024 * 1024;
+    static const GLuint DRAW_DATA_LOCATION = 4;
+    static const GLuint DRAW_DATA_ATTRIBUTES = 7;
+    static const uint32_t INVALID_PAGE = 0xFFFFFFFFu;
+
+    struct DrawData {
+        glm::mat4 model;
+        glm::vec4 positionScale;
+        glm::vec4 positionOffset;
+        glm::vec4 tint;
+    };
+
+    struct Allocation {
+        uint32_t page;
+        size_t baseVertex;
+        size_t vertexCount;
+        size_t firstIndex;
+        size_t indexCount;
+
+        Allocation() : page(INVALID_PAGE), baseVertex(0), vertexCount(0), firstIndex(0), indexCount(0) {}
+        bool IsValid() const { return page != INVALID_PAGE; }
+    };
+
+    struct Page {
+        GLuint VAO;
+        GLuint VBO;
+        GLuint EBO;
+        GLenum indexType;
+        size_t vertexCapacity;
+        size_t indexCapacity;
+        size_t allocationCount;
+        std::map<size_t, size_t> freeVertices;
+        std::map<size_t, size_t> freeIndices;
+
+        Page() : VAO(0), VBO(0), EBO(0), indexType(GL_UNSIGNED_INT), vertexCapacity(0), indexCapacity(0), allocationCount(0) {}
+    };
+
+    explicit GeometryArena(GLStateCache& state);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    void Initialize(VertexFormat format, GLuint drawDataBuffer);
+    void Shutdown();
+
+    bool Allocate(size_t vertexCount, size_t indexCount, GLenum indexType, Allocation& allocation);
+    void Free(Allocation& allocation);
+
+    const Page& GetPage(uint32_t page) const { return m_pages[page]; }
+    size_t GetPageCount() const { return m_pages.size(); }
+    size_t GetResidentPageCount() const;
+    size_t GetVertexSize() const { return m_vertexSize; }
+    size_t GetCapacityBytes() const;
+
+    static size_t GetIndexSize(GLenum indexType) { return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int); }
+    void BindDrawData(size_t firstDraw);
+
+private:
+    static bool TakeRange(std::map<size_t, size_t>& freeRanges, size_t count, size_t& offset);
+    static void ReturnRange(std::map<size_t, size_t>& freeRanges, size_t offset, size_t count);
+    bool CreatePage(GLenum indexType, size_t vertexCount, size_t indexCount, uint32_t& pageIndex);
+    void DestroyPage(Page& page);
+
+    GLStateCache& m_state;
+    std::vector<Page> m_pages;
+    VertexFormat m_format;
+    size_t m_vertexSize;
+    GLuint m_drawDataBuffer;
+};
@@ -0,0 +1,130 @@
+#include "GpuResidency.h"
+
+GpuResidency::GpuResidency() : m_frame(1) {
+    m_stats.budget = DEFAULT_BUDGET;
+}
+
+void GpuResidency::Allocate(const void* owner, ResourceType type, size_t bytes) {
+    auto inserted = m_entries.emplace(owner, Entry());
+    Entry& entry = inserted.first->second;
+    if (inserted.second) {
+        entry.lastUsedFrame = m_frame;
+        entry.lruPosition = m_lru.end();
+        ++m_stats.resourceCount;
+    }
+
+    if (type == ResourceType::Texture) {
+        entry.textureBytes += bytes;
+        m_stats.textureBytes += bytes;
+    } else {
+        entry.bufferBytes += bytes;
+        m_stats.bufferBytes += bytes;
+    }
+    if (entry.pinned) {
+        m_stats.pinnedBytes += bytes;
+    } else if (entry.lruPosition == m_lru.end()) {
+        Link(owner, entry);
+    }
+
+    m_stats.usedBytes += bytes;
+    if (m_stats.usedBytes > m_stats.peakBytes) {
+        m_stats.peakBytes = m_stats.usedBytes;
+    }
+}
+
+void GpuResidency::Free(const void* owner, ResourceType type, size_t bytes) {
+    auto it = m_entries.find(owner);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    size_t& tracked = type == ResourceType::Texture ? entry.textureBytes : entry.bufferBytes;
+    bytes = bytes < tracked ? bytes : tracked;
+    tracked -= bytes;
+    if (type == ResourceType::Texture) {
+        m_stats.textureBytes -= bytes;
+    } else {
+        m_stats.bufferBytes -= bytes;
+    }
+    if (entry.pinned) {
+        m_stats.pinnedBytes -= bytes;
+    }
+    m_stats.usedBytes -= bytes;
+
+    if (entry.GetBytes() == 0) {
+        Unlink(entry);
+        m_entries.erase(it);
+        --m_stats.resourceCount;
+    }
+}
+
+void GpuResidency::SetPinned(const void* owner, bool pinned) {
+    auto it = m_entries.find(owner);
+    if (it == m_entries.end() || it->second.pinned == pinned) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.pinned = pinned;
+    if (pinned) {
+        Unlink(entry);
+        m_stats.pinnedBytes += entry.GetBytes();
+    } else {
+        m_stats.pinnedBytes -= entry.GetBytes();
+        entry.lastUsedFrame = m_frame;
+        Link(owner, entry);
+    }
+}
+
+void GpuResidency::Touch(const void* owner) {
+    auto it = m_entries.find(owner);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.lastUsedFrame = m_frame;
+    if (!entry.pinned && entry.lruPosition != m_lru.begin()) {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    }
+}
+
+void GpuResidency::RecordEviction(size_t bytes) {
+    ++m_stats.evictions;
+    m_stats.evictedBytes += bytes;
+}
+
+bool GpuResidency::HasRoom(size_t bytes) const {
+    return m_stats.budget == 0 || m_stats.usedBytes + bytes <= m_stats.budget;
+}
+
+const void* GpuResidency::SelectVictim() const {
+    if (m_lru.empty()) {
+        return nullptr;
+    }
+
+    const void* owner = m_lru.back();
+    auto it = m_entries.find(owner);
+    if (it == m_entries.end() || it->second.lastUsedFrame >= m_frame) {
+        return nullptr;
+    }
+    return owner;
+}
+
+size_t GpuResidency::GetOwnerBytes(const void* owner) const {
+    auto it = m_entries.find(owner);
+    return it != m_entries.end() ? it->second.GetBytes() : 0;
+}
+
+void GpuResidency::Link(const void* owner, Entry& entry) {
+    m_lru.push_front(owner);
+    entry.lruPosition = m_lru.begin();
+}
+
+void GpuResidency::Unlink(Entry& entry) {
+    if (entry.lruPosition != m_lru.end()) {
+        m_lru.erase(entry.lruPosition);
+        entry.lruPosition = m_lru.end();
+    }
+}
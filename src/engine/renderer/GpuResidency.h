@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+class GpuResidency {
+public:
+    static const size_t DEFAULT_BUDGET = 512 * 1024 * 1024;
+
+    enum class ResourceType {
+        Buffer,
+        Texture
+    };
+
+    struct Stats {
+        size_t budget;
+        size_t usedBytes;
+        size_t peakBytes;
+        size_t bufferBytes;
+        size_t textureBytes;
+        size_t pinnedBytes;
+        size_t resourceCount;
+        size_t evictions;
+        size_t evictedBytes;
+        size_t deferredUploads;
+
+        Stats() : budget(0), usedBytes(0), peakBytes(0), bufferBytes(0), textureBytes(0), pinnedBytes(0),
+                  resourceCount(0), evictions(0), evictedBytes(0), deferredUploads(0) {}
+    };
+
+    GpuResidency();
+
+    void SetBudget(size_t bytes) { m_stats.budget = bytes; }
+    size_t GetBudget() const { return m_stats.budget; }
+    void BeginFrame() { ++m_frame; }
+
+    void Allocate(const void* owner, ResourceType type, size_t bytes);
+    void Free(const void* owner, ResourceType type, size_t bytes);
+    void SetPinned(const void* owner, bool pinned);
+    void Touch(const void* owner);
+    void RecordEviction(size_t bytes);
+    void RecordDeferredUpload() { ++m_stats.deferredUploads; }
+
+    bool HasRoom(size_t bytes) const;
+    const void* SelectVictim() const;
+    size_t GetOwnerBytes(const void* owner) const;
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        size_t bufferBytes;
+        size_t textureBytes;
+        uint64_t lastUsedFrame;
+        bool pinned;
+        std::list<const void*>::iterator lruPosition;
+
+        Entry() : bufferBytes(0), textureBytes(0), lastUsedFrame(0), pinned(false) {}
+        size_t GetBytes() const { return bufferBytes + textureBytes; }
+    };
+
+    void Link(const void* owner, Entry& entry);
+    void Unlink(Entry& entry);
+
+    std::unordered_map<const void*, Entry> m_entries;
+    std::list<const void*> m_lru;
+    uint64_t m_frame;
+    Stats m_stats;
+};
@@ -1,15 +1,58 @@
 #include "ModelRenderer.h"
 #include "Shader.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cfloat>
 
-ModelRenderer::ModelRenderer() 
+namespace {
+
+const size_t STAGING_BUFFER_SIZE = 4 * 1024 * 1024;
+const uint32_t MODEL_SHADER_KEY = 0;
+const uint32_t MATERIAL_CAPACITY = 256;
+const uint32_t DEFAULT_MATERIAL_SLOT = 0;
+const uint32_t FIRST_TRANSIENT_MATERIAL_SLOT = 1;
+const uint32_t TRANSIENT_MATERIAL_SLOTS = 32;
+const uint32_t FIRST_MODEL_MATERIAL_SLOT = FIRST_TRANSIENT_MATERIAL_SLOT + TRANSIENT_MATERIAL_SLOTS;
+const GLuint FRAME_UNIFORM_BINDING = 0;
+const GLuint MATERIAL_UNIFORM_BINDING = 1;
+
+}
+
+const std::string ModelRenderer::DEFAULT_VERTEX_SHADER = "assets/shaders/default/default.vert";
+const std::string ModelRenderer::DEFAULT_FRAGMENT_SHADER = "assets/shaders/default/default.frag";
+
+ModelRenderer::ModelRenderer(GLStateCache& state) 
     : m_initialized(false)
+    , m_state(state)
+    , m_farPlane(100.0f)
+    , m_viewportHeight(720.0f)
+    , m_lodThreshold(1.0f)
+    , m_meshletCulling(true)
+    , m_frustumCulling(true)
+    , m_threadPool(nullptr)
+    , m_geometry(state)
+    , m_indirectDraws(false)
+    , m_drawDataBuffer(0)
+    , m_drawDataCapacity(0)
+    , m_indirectBuffer(0)
+    , m_indirectCapacity(0)
+    , m_frameUniformBuffer(0)
+    , m_materialUniformBuffer(0)
+    , m_materialTableFull(false)
+    , m_transientMaterialsFull(false)
     , m_lightPosition(5.0f, 5.0f, 5.0f)
     , m_lightColor(1.0f, 1.0f, 1.0f)
     , m_lightIntensity(1.0f)
     , m_cameraPosition(0.0f, 0.0f, 5.0f)
     , m_cameraTarget(0.0f, 0.0f, 0.0f)
-    , m_cameraUp(0.0f, 1.0f, 0.0f) {
+    , m_cameraUp(0.0f, 1.0f, 0.0f)
+    , m_stagingBuffer(0)
+    , m_stagingMapped(false)
+    , m_uploadBudgetMs(2.0f)
+    , m_uploadBudgetBytes(8 * 1024 * 1024)
+    , m_vertexFormat(VertexFormat::Packed) {
     
     m_defaultMaterial.name = "default";
     m_defaultMaterial.ambient = glm::vec3(0.2f, 0.2f, 0.2f);
@@ -35,6 +78,25 @@ bool ModelRenderer::Initialize() {
         return false;
     }
     
+    glGenBuffers(1, &m_stagingBuffer);
+    m_state.BindBuffer(GL_COPY_READ_BUFFER, m_stagingBuffer);
+    glBufferData(GL_COPY_READ_BUFFER, STAGING_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+    m_residency.Allocate(this, GpuResidency::ResourceType::Buffer, STAGING_BUFFER_SIZE);
+    m_residency.SetPinned(this, true);
+    
+    m_indirectDraws = GLAD_GL_VERSION_4_3 != 0;
+    glGenBuffers(1, &m_drawDataBuffer);
+    if (m_indirectDraws) {
+        glGenBuffers(1, &m_indirectBuffer);
+    }
+    m_geometry.Initialize(m_vertexFormat, m_drawDataBuffer);
+    if (!CreateUniformBuffers()) {
+        std::cerr << "Failed to create uniform buffers" << std::endl;
+        return false;
+    }
+    std::cout << "ModelRenderer: submitting draws with "
+              << (m_indirectDraws ? "glMultiDrawElementsIndirect" : "glDrawElementsBaseVertex") << std::endl;
+    
     m_initialized = true;
     return true;
 }
@@ -44,10 +106,31 @@ void ModelRenderer::Shutdown() {
         return;
     }
     
-    for (auto& meshData : m_meshBuffers) {
-        DeleteMeshBuffers(meshData);
+    ClearUploads();
+    for (auto& entry : m_meshBuffers) {
+        DeleteMeshBuffers(entry.second);
     }
     m_meshBuffers.clear();
+    ClearDraws();
+    m_geometry.Shutdown();
+    DeleteUniformBuffers();
+    
+    if (m_drawDataBuffer != 0) {
+        m_state.DeleteBuffer(m_drawDataBuffer);
+        m_residency.Free(this, GpuResidency::ResourceType::Buffer, m_drawDataCapacity);
+        m_drawDataCapacity = 0;
+    }
+    
+    if (m_indirectBuffer != 0) {
+        m_state.DeleteBuffer(m_indirectBuffer);
+        m_residency.Free(this, GpuResidency::ResourceType::Buffer, m_indirectCapacity);
+        m_indirectCapacity = 0;
+    }
+    
+    if (m_stagingBuffer != 0) {
+        m_state.DeleteBuffer(m_stagingBuffer);
+        m_residency.Free(this, GpuResidency::ResourceType::Buffer, STAGING_BUFFER_SIZE);
+    }
     
     m_initialized = false;
 }
@@ -61,6 +144,7 @@ void ModelRenderer::SetCamera(const glm::vec3& position, const glm::vec3& target
 
 void ModelRenderer::SetProjection(float fov, float aspectRatio, float nearPlane, float farPlane) {
     m_projectionMatrix = glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
+    m_farPlane = farPlane;
 }
 
 void ModelRenderer::SetLight(const glm::vec3& position, const glm::vec3& color, float intensity) {
@@ -69,147 +153,967 @@ void ModelRenderer::SetLight(const glm::vec3& position, const glm::vec3& color,
     m_lightIntensity = intensity;
 }
 
+void ModelRenderer::SetViewportHeight(int height) {
+    m_viewportHeight = static_cast<float>(height > 0 ? height : 1);
+}
+
+void ModelRenderer::BeginFrame() {
+    m_cullingStats = CullingStats();
+    m_transientMaterials.clear();
+    m_residency.BeginFrame();
+    ClearDraws();
+}
+
+void ModelRenderer::ClearDraws() {
+    m_renderQueue.Clear();
+    m_modelBatches.clear();
+    m_modelBatchIndices.clear();
+    m_drawCommands.clear();
+    m_drawData.clear();
+}
+
+void ModelRenderer::SetVertexFormat(VertexFormat format) {
+    if (format == m_vertexFormat) {
+        return;
+    }
+    
+    ClearUploads();
+    for (auto& entry : m_meshBuffers) {
+        DeleteMeshBuffers(entry.second);
+    }
+    m_meshBuffers.clear();
+    m_vertexFormat = format;
+    ResetGeometry();
+}
+
+void ModelRenderer::ResetGeometry() {
+    ClearDraws();
+    if (m_initialized) {
+        m_geometry.Initialize(m_vertexFormat, m_drawDataBuffer);
+    }
+}
+
+size_t ModelRenderer::GetGpuMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& entry : m_meshBuffers) {
+        bytes += entry.second.vertexBytes + entry.second.indexBytes;
+    }
+    return bytes;
+}
+
+size_t ModelRenderer::GetModelGpuMemory(const Model& model) const {
+    size_t bytes = 0;
+    for (const auto& mesh : model.meshes) {
+        bytes += m_residency.GetOwnerBytes(&mesh);
+    }
+    return bytes;
+}
+
 void ModelRenderer::RenderModel(const Model& model, const glm::mat4& modelMatrix) {
     if (!m_initialized || !m_shader || !m_shader->IsValid()) {
         return;
     }
     
-    while (m_meshBuffers.size() < model.meshes.size()) {
-        m_meshBuffers.emplace_back();
+    GetModelBatch(model).instances.emplace_back(modelMatrix);
+}
+
+void ModelRenderer::RenderModelInstanced(const Model& model, const InstanceData* instances, size_t count) {
+    if (!m_initialized || !m_shader || !m_shader->IsValid() || count == 0) {
+        return;
+    }
+    
+    std::vector<InstanceData>& batch = GetModelBatch(model).instances;
+    batch.insert(batch.end(), instances, instances + count);
+}
+
+void ModelRenderer::RenderMesh(const Mesh& mesh, const Material& material, const glm::mat4& modelMatrix) {
+    if (!m_initialized || !m_shader || !m_shader->IsValid()) {
+        return;
     }
     
-    for (size_t i = 0; i < model.meshes.size(); ++i) {
-        const auto& mesh = model.meshes[i];
+    QueueMesh(mesh, material, AcquireTransientMaterialSlot(material), modelMatrix, glm::vec4(1.0f));
+}
+
+ModelRenderer::ModelBatch& ModelRenderer::GetModelBatch(const Model& model) {
+    auto inserted = m_modelBatchIndices.emplace(&model, m_modelBatches.size());
+    if (inserted.second) {
+        m_modelBatches.emplace_back(&model);
+    }
+    return m_modelBatches[inserted.first->second];
+}
+
+const Material& ModelRenderer::ResolveMaterial(const Model& model, int materialIndex, uint32_t& materialSlot) {
+    if (materialIndex >= 0 && materialIndex < static_cast<int>(model.materials.size())) {
+        materialSlot = AcquireMaterialSlot(model, materialIndex);
+        return model.materials[materialIndex];
+    }
+    materialSlot = DEFAULT_MATERIAL_SLOT;
+    return m_defaultMaterial;
+}
+
+void ModelRenderer::SubmitModelBatches() {
+    m_frustumCuller.Clear();
+    m_cullRanges.clear();
+    for (size_t i = 0; i < m_modelBatches.size(); ++i) {
+        const ModelBatch& batch = m_modelBatches[i];
+        for (const auto& mesh : batch.model->meshes) {
+            const MeshData* meshData = GetMeshData(mesh);
+            if (!meshData) {
+                continue;
+            }
+            
+            CullRange range;
+            range.batch = i;
+            range.mesh = &mesh;
+            range.first = m_frustumCuller.GetCount();
+            m_cullRanges.push_back(range);
+            for (const auto& instance : batch.instances) {
+                m_frustumCuller.Add(meshData->boundsCenter, meshData->boundsExtent, instance.transform);
+            }
+        }
+    }
+    
+    m_frustumCuller.SetFrustum(m_projectionMatrix * m_viewMatrix);
+    if (m_frustumCulling) {
+        m_frustumCuller.Cull(m_threadPool);
+        const FrustumCuller::Stats& stats = m_frustumCuller.GetStats();
+        m_cullingStats.objectsTested += stats.tested;
+        m_cullingStats.objectsVisible += stats.visible;
+        m_cullingStats.objectsCulled += stats.culled;
+        m_cullingStats.cullJobs += stats.jobs;
+    } else {
+        m_cullingStats.objectsTested += m_frustumCuller.GetCount();
+        m_cullingStats.objectsVisible += m_frustumCuller.GetCount();
+    }
+    
+    for (const auto& range : m_cullRanges) {
+        const ModelBatch& batch = m_modelBatches[range.batch];
+        m_visibleInstances.clear();
+        for (size_t i = 0; i < batch.instances.size(); ++i) {
+            if (m_frustumCuller.IsVisible(range.first + i)) {
+                m_visibleInstances.push_back(batch.instances[i]);
+            }
+        }
         
-        const Material* material = &m_defaultMaterial;
-        if (mesh.materialIndex >= 0 && mesh.materialIndex < static_cast<int>(model.materials.size())) {
-            material = &model.materials[mesh.materialIndex];
+        if (m_visibleInstances.size() > 1) {
+            QueueMeshInstances(*batch.model, *range.mesh, m_visibleInstances);
+        } else if (m_visibleInstances.size() == 1) {
+            const InstanceData& instance = m_visibleInstances[0];
+            int materialIndex = instance.materialIndex >= 0 ? instance.materialIndex : range.mesh->materialIndex;
+            uint32_t materialSlot;
+            const Material& material = ResolveMaterial(*batch.model, materialIndex, materialSlot);
+            QueueMesh(*range.mesh, material, materialSlot, instance.transform, instance.tint);
+        }
+    }
+    m_modelBatches.clear();
+    m_modelBatchIndices.clear();
+}
+
+void ModelRenderer::QueueMesh(const Mesh& mesh, const Material& material, uint32_t materialSlot, const glm::mat4& modelMatrix, const glm::vec4& tint) {
+    MeshData* meshData = GetMeshData(mesh);
+    if (!meshData) {
+        return;
+    }
+    m_residency.Touch(&mesh);
+    
+    GLuint drawIndex = PushDrawData(*meshData, modelMatrix, materialSlot, tint);
+    uint64_t key = MakeDrawKey(*meshData, material, materialSlot, modelMatrix, tint.a);
+    const LodLevel& lod = SelectLod(*meshData, modelMatrix);
+    if (&lod == &meshData->lods[0] && m_meshletCulling && mesh.GetMeshletCount() > 0) {
+        DrawMeshlets(mesh, *meshData, modelMatrix, drawIndex, key);
+    } else {
+        QueueDraw(*meshData, lod.indexOffset, lod.indexCount, drawIndex, 1, key);
+    }
+}
+
+void ModelRenderer::QueueMeshInstances(const Model& model, const Mesh& mesh, const std::vector<InstanceData>& instances) {
+    MeshData* meshData = GetMeshData(mesh);
+    if (!meshData) {
+        return;
+    }
+    m_residency.Touch(&mesh);
+    
+    m_instanceRefs.clear();
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const InstanceData& instance = instances[i];
+        InstanceRef ref;
+        int materialIndex = instance.materialIndex >= 0 ? instance.materialIndex : mesh.materialIndex;
+        ref.material = &ResolveMaterial(model, materialIndex, ref.materialSlot);
+        ref.translucent = ref.material->transparency * instance.tint.a < 1.0f;
+        ref.lod = static_cast<uint32_t>(&SelectLod(*meshData, instance.transform) - meshData->lods.data());
+        ref.instance = static_cast<uint32_t>(i);
+        m_instanceRefs.push_back(ref);
+    }
+    std::sort(m_instanceRefs.begin(), m_instanceRefs.end(), [](const InstanceRef& a, const InstanceRef& b) {
+        if (a.lod != b.lod) {
+            return a.lod < b.lod;
+        }
+        return a.materialSlot != b.materialSlot ? a.materialSlot < b.materialSlot : a.translucent < b.translucent;
+    });
+    
+    for (size_t start = 0; start < m_instanceRefs.size();) {
+        const InstanceRef& first = m_instanceRefs[start];
+        size_t end = start + 1;
+        while (end < m_instanceRefs.size() && m_instanceRefs[end].lod == first.lod
+               && m_instanceRefs[end].materialSlot == first.materialSlot
+               && m_instanceRefs[end].translucent == first.translucent) {
+            ++end;
         }
         
-        if (!m_meshBuffers[i].initialized) {
-            if (!CreateMeshBuffers(mesh, m_meshBuffers[i])) {
-                std::cerr << "Failed to create buffers for mesh: " << mesh.name << std::endl;
-                continue;
+        GLuint drawIndex = static_cast<GLuint>(m_drawData.size());
+        size_t keyInstance = first.instance;
+        float keyDepth = first.translucent ? -FLT_MAX : FLT_MAX;
+        for (size_t i = start; i < end; ++i) {
+            const InstanceData& instance = instances[m_instanceRefs[i].instance];
+            PushDrawData(*meshData, instance.transform, first.materialSlot, instance.tint);
+            float depth = GetViewDepth(*meshData, instance.transform);
+            if (first.translucent ? depth > keyDepth : depth < keyDepth) {
+                keyDepth = depth;
+                keyInstance = m_instanceRefs[i].instance;
             }
         }
         
-        RenderMesh(mesh, *material, modelMatrix);
+        const LodLevel& lod = meshData->lods[first.lod];
+        float alpha = first.translucent ? 0.0f : 1.0f;
+        uint64_t key = MakeDrawKey(*meshData, *first.material, first.materialSlot, instances[keyInstance].transform, alpha);
+        QueueDraw(*meshData, lod.indexOffset, lod.indexCount, drawIndex, static_cast<GLuint>(end - start), key);
+        ++m_drawStats.instancedDraws;
+        start = end;
     }
 }
 
-void ModelRenderer::RenderMesh(const Mesh& mesh, const Material& material, const glm::mat4& modelMatrix) {
-    if (!m_initialized || !m_shader || !m_shader->IsValid()) {
+GLuint ModelRenderer::PushDrawData(const MeshData& meshData, const glm::mat4& modelMatrix, uint32_t materialSlot, const glm::vec4& tint) {
+    GeometryArena::DrawData drawData;
+    drawData.model = modelMatrix;
+    drawData.positionScale = glm::vec4(meshData.positionScale, 1.0f);
+    drawData.positionOffset = glm::vec4(meshData.positionOffset, static_cast<float>(materialSlot));
+    drawData.tint = tint;
+    m_drawData.push_back(drawData);
+    return static_cast<GLuint>(m_drawData.size() - 1);
+}
+
+float ModelRenderer::GetViewDepth(const MeshData& meshData, const glm::mat4& modelMatrix) const {
+    glm::vec4 center = m_viewMatrix * modelMatrix * glm::vec4(meshData.boundsCenter, 1.0f);
+    return -center.z;
+}
+
+uint64_t ModelRenderer::MakeDrawKey(const MeshData& meshData, const Material& material, uint32_t materialSlot, const glm::mat4& modelMatrix, float alpha) const {
+    float depth = m_farPlane > 0.0f ? GetViewDepth(meshData, modelMatrix) / m_farPlane : 0.0f;
+    RenderQueue::Pass pass = material.transparency * alpha < 1.0f ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque;
+    return RenderQueue::MakeKey(pass, MODEL_SHADER_KEY, materialSlot, meshData.allocation.page, depth);
+}
+
+void ModelRenderer::QueueDraw(const MeshData& meshData, size_t indexOffset, size_t indexCount, GLuint drawIndex, GLuint instanceCount, uint64_t key) {
+    DrawCommand command;
+    command.count = static_cast<GLuint>(indexCount);
+    command.instanceCount = instanceCount;
+    command.firstIndex = static_cast<GLuint>(meshData.allocation.firstIndex + indexOffset);
+    command.baseVertex = static_cast<GLint>(meshData.allocation.baseVertex);
+    command.baseInstance = drawIndex;
+    m_renderQueue.Push(key, static_cast<uint32_t>(m_drawCommands.size()));
+    m_drawCommands.push_back(command);
+}
+
+void ModelRenderer::FlushDraws() {
+    m_drawStats = DrawStats();
+    m_drawStats.geometryPages = m_geometry.GetResidentPageCount();
+    m_drawStats.geometryBytes = m_geometry.GetCapacityBytes();
+    SubmitModelBatches();
+    if (!m_initialized || !m_shader || !m_shader->IsValid() || m_renderQueue.IsEmpty()) {
+        ClearDraws();
         return;
     }
     
-    MeshData* meshData = nullptr;
-    for (auto& md : m_meshBuffers) {
-        if (md.initialized) {
-            meshData = &md;
-            break;
+    m_renderQueue.Sort();
+    const std::vector<RenderQueue::Item>& items = m_renderQueue.GetItems();
+    m_drawStats.drawCommands = items.size();
+    m_drawStats.instances = m_drawData.size();
+    m_drawStats.residentMaterials = 1 + m_transientMaterials.size() + m_materialSlots.size();
+    UpdateFrameUniforms();
+    
+    UploadStream(GL_ARRAY_BUFFER, m_drawDataBuffer, m_drawDataCapacity, m_drawData.data(),
+                 m_drawData.size() * sizeof(GeometryArena::DrawData));
+    if (m_indirectDraws) {
+        m_indirectCommands.clear();
+        for (const auto& item : items) {
+            m_indirectCommands.push_back(m_drawCommands[item.payload]);
         }
+        UploadStream(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer, m_indirectCapacity, m_indirectCommands.data(),
+                     m_indirectCommands.size() * sizeof(DrawCommand));
     }
     
-    if (!meshData || !meshData->initialized) {
-        return;
+    uint64_t previous = 0;
+    for (size_t start = 0; start < items.size();) {
+        uint64_t state = RenderQueue::GetStateBits(items[start].key);
+        size_t end = start + 1;
+        while (end < items.size() && RenderQueue::GetStateBits(items[end].key) == state) {
+            ++end;
+        }
+        
+        ApplyDrawState(state, previous, start == 0);
+        previous = state;
+        
+        GLenum indexType = m_geometry.GetPage(RenderQueue::GetVao(state)).indexType;
+        if (RenderQueue::GetPass(state) == RenderQueue::Pass::Transparent) {
+            m_drawStats.transparentDraws += end - start;
+        }
+        
+        if (m_indirectDraws) {
+            glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, reinterpret_cast<const void*>(start * sizeof(DrawCommand)),
+                                        static_cast<GLsizei>(end - start), 0);
+            ++m_drawStats.drawCalls;
+        } else {
+            size_t indexSize = GeometryArena::GetIndexSize(indexType);
+            for (size_t i = start; i < end; ++i) {
+                const DrawCommand& command = m_drawCommands[items[i].payload];
+                m_geometry.BindDrawData(command.baseInstance);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), indexType,
+                                                  reinterpret_cast<const void*>(command.firstIndex * indexSize),
+                                                  static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+            }
+            m_drawStats.drawCalls += end - start;
+        }
+        start = end;
+    }
+    
+    ClearDraws();
+}
+
+void ModelRenderer::ApplyDrawState(uint64_t state, uint64_t previous, bool first) {
+    RenderQueue::Pass pass = RenderQueue::GetPass(state);
+    if (first || pass != RenderQueue::GetPass(previous)) {
+        bool transparent = pass == RenderQueue::Pass::Transparent;
+        m_state.SetEnabled(GL_DEPTH_TEST, true);
+        m_state.SetEnabled(GL_BLEND, transparent);
+        if (transparent) {
+            m_state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        m_state.SetDepthMask(!transparent);
+        ++m_drawStats.stateChanges;
+    }
+    
+    uint32_t shader = RenderQueue::GetShader(state);
+    if (first || shader != RenderQueue::GetShader(previous)) {
+        m_state.UseProgram(m_shader->GetProgramID());
+        ++m_drawStats.stateChanges;
     }
     
-    m_shader->Use();
-    SetShaderUniforms(material, modelMatrix);
+    uint32_t vao = RenderQueue::GetVao(state);
+    if (first || vao != RenderQueue::GetVao(previous)) {
+        m_state.BindVertexArray(m_geometry.GetPage(vao).VAO);
+        ++m_drawStats.stateChanges;
+    }
+}
+
+void ModelRenderer::UploadStream(GLenum target, GLuint buffer, size_t& capacity, const void* data, size_t bytes) {
+    m_state.BindBuffer(target, buffer);
+    if (bytes > capacity) {
+        size_t grown = std::max(bytes, capacity * 2);
+        m_residency.Allocate(this, GpuResidency::ResourceType::Buffer, grown - capacity);
+        capacity = grown;
+    }
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, bytes, data);
+}
+
+ModelRenderer::MeshData* ModelRenderer::GetMeshData(const Mesh& mesh) {
+    auto it = m_meshBuffers.find(&mesh);
+    if (it != m_meshBuffers.end() && IsMeshResident(mesh)) {
+        return &it->second;
+    }
     
-    glBindVertexArray(meshData->VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(meshData->indexCount), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    if (it != m_meshBuffers.end()) {
+        DeleteMeshBuffers(it->second);
+        m_meshBuffers.erase(it);
+    }
+    if (!IsUploadQueued(mesh)) {
+        m_uploadQueue.emplace_back(&mesh);
+    }
+    return nullptr;
 }
 
-bool ModelRenderer::CreateMeshBuffers(const Mesh& mesh, MeshData& meshData) {
-    if (meshData.initialized) {
-        DeleteMeshBuffers(meshData);
+bool ModelRenderer::IsMeshResident(const Mesh& mesh) const {
+    auto it = m_meshBuffers.find(&mesh);
+    if (it == m_meshBuffers.end()) {
+        return false;
+    }
+    
+    const MeshData& meshData = it->second;
+    return meshData.initialized
+        && meshData.sourceVertices == mesh.GetVertexData()
+        && meshData.sourceVertexCount == mesh.GetVertexCount()
+        && meshData.indexCount == mesh.GetIndexCount()
+        && meshData.lods.size() == mesh.lods.size() + 1;
+}
+
+bool ModelRenderer::IsUploadQueued(const Mesh& mesh) const {
+    for (const auto& job : m_uploadQueue) {
+        if (job.mesh == &mesh) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModelRenderer::SetUploadBudget(float milliseconds, size_t bytes) {
+    m_uploadBudgetMs = milliseconds;
+    m_uploadBudgetBytes = bytes;
+}
+
+void ModelRenderer::QueueUpload(const Model& model) {
+    for (const auto& mesh : model.meshes) {
+        if (!IsMeshResident(mesh) && !IsUploadQueued(mesh)) {
+            m_uploadQueue.emplace_back(&mesh);
+        }
+    }
+}
+
+bool ModelRenderer::IsModelResident(const Model& model) const {
+    for (const auto& mesh : model.meshes) {
+        if (mesh.GetVertexCount() > 0 && mesh.GetIndexCount() > 0 && !IsMeshResident(mesh)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ModelRenderer::ProcessUploads() {
+    if (!m_initialized || m_uploadQueue.empty()) {
+        return 0;
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t uploaded = 0;
+    bool first = true;
+    
+    while (!m_uploadQueue.empty()) {
+        float elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        bool overTime = m_uploadBudgetMs > 0.0f && elapsed >= m_uploadBudgetMs;
+        bool overBytes = m_uploadBudgetBytes > 0 && uploaded >= m_uploadBudgetBytes;
+        if (!first && (overTime || overBytes)) {
+            break;
+        }
+        first = false;
+        
+        UploadJob& job = m_uploadQueue.front();
+        if (!job.started && !ReserveMemory(EstimateMeshBytes(*job.mesh))) {
+            m_residency.RecordDeferredUpload();
+            break;
+        }
+        if (!job.started && !BeginUpload(job)) {
+            std::cerr << "Failed to create buffers for mesh: " << job.mesh->name << std::endl;
+            DeleteMeshBuffers(job.meshData);
+            m_uploadQueue.pop_front();
+            continue;
+        }
+        
+        size_t chunkBytes = STAGING_BUFFER_SIZE;
+        if (m_uploadBudgetBytes > 0 && uploaded < m_uploadBudgetBytes) {
+            chunkBytes = std::min(chunkBytes, m_uploadBudgetBytes - uploaded);
+        }
+        
+        if (job.vertexCursor < job.meshData.sourceVertexCount) {
+            uploaded += UploadVertexChunk(job, chunkBytes);
+        } else if (job.indexLevel < job.meshData.lods.size()) {
+            uploaded += UploadIndexChunk(job, chunkBytes);
+        }
+        
+        if (job.vertexCursor == job.meshData.sourceVertexCount && job.indexLevel == job.meshData.lods.size()) {
+            job.meshData.initialized = true;
+            MeshData& resident = m_meshBuffers[job.mesh];
+            DeleteMeshBuffers(resident);
+            resident = job.meshData;
+            m_residency.SetPinned(job.mesh, false);
+            m_uploadQueue.pop_front();
+        }
     }
     
-    glGenVertexArrays(1, &meshData.VAO);
-    glBindVertexArray(meshData.VAO);
+    return uploaded;
+}
+
+bool ModelRenderer::BeginUpload(UploadJob& job) {
+    const Mesh& mesh = *job.mesh;
+    MeshData& meshData = job.meshData;
+    job.started = true;
     
-    glGenBuffers(1, &meshData.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, meshData.VBO);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), mesh.vertices.data(), GL_STATIC_DRAW);
+    if (mesh.GetVertexCount() == 0 || mesh.GetIndexCount() == 0) {
+        return false;
+    }
     
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glm::vec3& boundsMin = job.boundsMin;
+    glm::vec3& boundsMax = job.boundsMax;
+    mesh.CalculateBounds(boundsMin, boundsMax);
+    meshData.boundsCenter = (boundsMin + boundsMax) * 0.5f;
+    meshData.boundsExtent = (boundsMax - boundsMin) * 0.5f;
+    meshData.boundsRadius = glm::length(boundsMax - boundsMin) * 0.5f;
+    meshData.sourceVertices = mesh.GetVertexData();
+    meshData.sourceVertexCount = mesh.GetVertexCount();
     
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    if (m_vertexFormat == VertexFormat::Packed) {
+        meshData.vertexBytes = mesh.GetVertexCount() * sizeof(PackedVertex);
+        meshData.positionScale = VertexPacker::GetPositionScale(boundsMin, boundsMax);
+        meshData.positionOffset = boundsMin;
+    } else {
+        meshData.vertexBytes = mesh.GetVertexCount() * sizeof(Vertex);
+        meshData.positionScale = glm::vec3(1.0f);
+        meshData.positionOffset = glm::vec3(0.0f);
+    }
     
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+    meshData.indexCount = mesh.GetIndexCount();
+    meshData.lods.assign(mesh.lods.size() + 1, LodLevel());
+    meshData.lods[0].indexCount = meshData.indexCount;
     
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+    size_t totalCount = meshData.indexCount;
+    for (size_t i = 0; i < mesh.lods.size(); ++i) {
+        LodLevel& level = meshData.lods[i + 1];
+        level.indexOffset = totalCount;
+        level.indexCount = mesh.lods[i].GetIndexCount();
+        level.error = mesh.lods[i].error;
+        totalCount += level.indexCount;
+    }
     
-    glGenBuffers(1, &meshData.EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshData.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+    bool shortIndices = m_vertexFormat == VertexFormat::Packed && mesh.GetVertexCount() <= 0xFFFF;
+    size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+    meshData.indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    meshData.indexBytes = totalCount * indexSize;
     
-    meshData.indexCount = mesh.indices.size();
+    if (!m_geometry.Allocate(mesh.GetVertexCount(), totalCount, meshData.indexType, meshData.allocation)) {
+        return false;
+    }
     
-    glBindVertexArray(0);
+    meshData.owner = &mesh;
+    m_residency.Allocate(&mesh, GpuResidency::ResourceType::Buffer, meshData.vertexBytes + meshData.indexBytes);
+    m_residency.SetPinned(&mesh, true);
+    return true;
+}
+
+size_t ModelRenderer::EstimateMeshBytes(const Mesh& mesh) const {
+    size_t indexCount = mesh.GetIndexCount();
+    for (const auto& lod : mesh.lods) {
+        indexCount += lod.GetIndexCount();
+    }
     
-    meshData.initialized = true;
+    bool packed = m_vertexFormat == VertexFormat::Packed;
+    size_t vertexSize = packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    size_t indexSize = packed && mesh.GetVertexCount() <= 0xFFFF ? sizeof(uint16_t) : sizeof(unsigned int);
+    return mesh.GetVertexCount() * vertexSize + indexCount * indexSize;
+}
+
+bool ModelRenderer::ReserveMemory(size_t bytes) {
+    while (!m_residency.HasRoom(bytes)) {
+        const Mesh* victim = static_cast<const Mesh*>(m_residency.SelectVictim());
+        if (!victim) {
+            return m_meshBuffers.empty();
+        }
+        if (!EvictMesh(victim)) {
+            return false;
+        }
+    }
     return true;
 }
 
-void ModelRenderer::DeleteMeshBuffers(MeshData& meshData) {
-    if (meshData.VAO != 0) {
-        glDeleteVertexArrays(1, &meshData.VAO);
-        meshData.VAO = 0;
+bool ModelRenderer::EvictMesh(const Mesh* mesh) {
+    auto it = m_meshBuffers.find(mesh);
+    if (it == m_meshBuffers.end()) {
+        return false;
     }
     
-    if (meshData.VBO != 0) {
-        glDeleteBuffers(1, &meshData.VBO);
-        meshData.VBO = 0;
+    m_residency.RecordEviction(it->second.vertexBytes + it->second.indexBytes);
+    DeleteMeshBuffers(it->second);
+    m_meshBuffers.erase(it);
+    return true;
+}
+
+size_t ModelRenderer::UploadVertexChunk(UploadJob& job, size_t maxBytes) {
+    MeshData& meshData = job.meshData;
+    bool packed = m_vertexFormat == VertexFormat::Packed;
+    size_t vertexSize = packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    size_t count = std::min(meshData.sourceVertexCount - job.vertexCursor, std::max<size_t>(1, maxBytes / vertexSize));
+    size_t bytes = count * vertexSize;
+    const Vertex* source = meshData.sourceVertices + job.vertexCursor;
+    
+    void* staging = MapStaging(bytes);
+    if (packed) {
+        VertexPacker::PackVertices(source, count, job.boundsMin, job.boundsMax, static_cast<PackedVertex*>(staging));
+    } else {
+        std::memcpy(staging, source, bytes);
     }
+    const GeometryArena::Page& page = m_geometry.GetPage(meshData.allocation.page);
+    CommitStaging(page.VBO, (meshData.allocation.baseVertex + job.vertexCursor) * vertexSize, bytes);
+    
+    job.vertexCursor += count;
+    return bytes;
+}
+
+size_t ModelRenderer::UploadIndexChunk(UploadJob& job, size_t maxBytes) {
+    const Mesh& mesh = *job.mesh;
+    MeshData& meshData = job.meshData;
+    const LodLevel& level = meshData.lods[job.indexLevel];
+    const unsigned int* indices = job.indexLevel == 0 ? mesh.GetIndexData() : mesh.lods[job.indexLevel - 1].GetIndexData();
+    
+    bool shortIndices = meshData.indexType == GL_UNSIGNED_SHORT;
+    size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+    size_t count = std::min(level.indexCount - job.indexCursor, std::max<size_t>(1, maxBytes / indexSize));
+    size_t bytes = count * indexSize;
     
-    if (meshData.EBO != 0) {
-        glDeleteBuffers(1, &meshData.EBO);
-        meshData.EBO = 0;
+    if (count > 0) {
+        void* staging = MapStaging(bytes);
+        if (shortIndices) {
+            VertexPacker::PackIndices(indices + job.indexCursor, count, static_cast<uint16_t*>(staging));
+        } else {
+            std::memcpy(staging, indices + job.indexCursor, bytes);
+        }
+        const GeometryArena::Page& page = m_geometry.GetPage(meshData.allocation.page);
+        CommitStaging(page.EBO, (meshData.allocation.firstIndex + level.indexOffset + job.indexCursor) * indexSize, bytes);
+    }
+    
+    job.indexCursor += count;
+    if (job.indexCursor == level.indexCount) {
+        ++job.indexLevel;
+        job.indexCursor = 0;
+    }
+    return bytes;
+}
+
+void* ModelRenderer::MapStaging(size_t bytes) {
+    m_state.BindBuffer(GL_COPY_READ_BUFFER, m_stagingBuffer);
+    void* mapped = nullptr;
+    if (m_stagingBuffer != 0 && bytes <= STAGING_BUFFER_SIZE) {
+        mapped = glMapBufferRange(GL_COPY_READ_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+    
+    m_stagingMapped = mapped != nullptr;
+    if (!m_stagingMapped) {
+        m_stagingFallback.resize(bytes);
+        mapped = m_stagingFallback.data();
+    }
+    return mapped;
+}
+
+void ModelRenderer::CommitStaging(GLuint destination, size_t offset, size_t bytes) {
+    m_state.BindBuffer(GL_COPY_WRITE_BUFFER, destination);
+    if (m_stagingMapped) {
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, offset, bytes);
+        m_stagingMapped = false;
+    } else {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, m_stagingFallback.data());
+    }
+}
+
+void ModelRenderer::ReleaseModel(const Model& model) {
+    ReleaseMaterialSlots(model);
+    for (const auto& mesh : model.meshes) {
+        auto it = m_meshBuffers.find(&mesh);
+        if (it != m_meshBuffers.end()) {
+            DeleteMeshBuffers(it->second);
+            m_meshBuffers.erase(it);
+        }
+        
+        for (auto job = m_uploadQueue.begin(); job != m_uploadQueue.end();) {
+            if (job->mesh == &mesh) {
+                DeleteMeshBuffers(job->meshData);
+                job = m_uploadQueue.erase(job);
+            } else {
+                ++job;
+            }
+        }
+    }
+}
+
+void ModelRenderer::ClearUploads() {
+    for (auto& job : m_uploadQueue) {
+        DeleteMeshBuffers(job.meshData);
+    }
+    m_uploadQueue.clear();
+}
+
+void ModelRenderer::DeleteMeshBuffers(MeshData& meshData) {
+    if (meshData.owner && meshData.allocation.IsValid()) {
+        m_residency.Free(meshData.owner, GpuResidency::ResourceType::Buffer, meshData.vertexBytes + meshData.indexBytes);
+    }
+    
+    if (meshData.allocation.IsValid()) {
+        m_geometry.Free(meshData.allocation);
     }
     
     meshData.indexCount = 0;
+    meshData.lods.clear();
+    meshData.vertexBytes = 0;
+    meshData.indexBytes = 0;
+    meshData.sourceVertices = nullptr;
+    meshData.sourceVertexCount = 0;
+    meshData.owner = nullptr;
     meshData.initialized = false;
 }
 
+const ModelRenderer::LodLevel& ModelRenderer::SelectLod(const MeshData& meshData, const glm::mat4& modelMatrix) const {
+    if (meshData.lods.size() < 2 || m_lodThreshold <= 0.0f) {
+        return meshData.lods[0];
+    }
+    
+    float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+                           std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(meshData.boundsCenter, 1.0f));
+    float distance = glm::length(center - m_cameraPosition) - meshData.boundsRadius * scale;
+    if (distance <= 0.0f) {
+        return meshData.lods[0];
+    }
+    
+    float pixelsPerUnit = m_projectionMatrix[1][1] * 0.5f * m_viewportHeight / distance;
+    size_t level = 0;
+    while (level + 1 < meshData.lods.size()
+           && meshData.lods[level + 1].error * scale * pixelsPerUnit <= m_lodThreshold) {
+        ++level;
+    }
+    return meshData.lods[level];
+}
+
+void ModelRenderer::DrawMeshlets(const Mesh& mesh, const MeshData& meshData, const glm::mat4& modelMatrix, GLuint drawIndex, uint64_t key) {
+    glm::mat4 clip = m_projectionMatrix * m_viewMatrix * modelMatrix;
+    glm::vec4 planes[6];
+    for (int i = 0; i < 3; ++i) {
+        glm::vec4 row(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+        glm::vec4 w(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+        planes[i * 2] = w + row;
+        planes[i * 2 + 1] = w - row;
+    }
+    for (auto& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    
+    glm::vec3 camera = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(m_cameraPosition, 1.0f));
+    const Meshlet* meshlets = mesh.GetMeshletData();
+    size_t meshletCount = mesh.GetMeshletCount();
+    
+    size_t rangeStart = 0;
+    size_t rangeCount = 0;
+    size_t ranges = 0;
+    
+    for (size_t i = 0; i < meshletCount; ++i) {
+        const Meshlet& meshlet = meshlets[i];
+        m_cullingStats.trianglesTested += meshlet.triangleCount;
+        
+        bool visible = true;
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) {
+                visible = false;
+                break;
+            }
+        }
+        
+        glm::vec3 toCenter = meshlet.center - camera;
+        if (visible && glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+            visible = false;
+        }
+        if (!visible) {
+            continue;
+        }
+        
+        ++m_cullingStats.meshletsVisible;
+        m_cullingStats.trianglesSubmitted += meshlet.triangleCount;
+        
+        size_t count = static_cast<size_t>(meshlet.triangleCount) * 3;
+        if (rangeCount > 0 && rangeStart + rangeCount == meshlet.indexOffset) {
+            rangeCount += count;
+            continue;
+        }
+        if (rangeCount > 0) {
+            QueueDraw(meshData, rangeStart, rangeCount, drawIndex, 1, key);
+            ++ranges;
+        }
+        rangeStart = meshlet.indexOffset;
+        rangeCount = count;
+    }
+    if (rangeCount > 0) {
+        QueueDraw(meshData, rangeStart, rangeCount, drawIndex, 1, key);
+        ++ranges;
+    }
+    
+    m_cullingStats.meshletsTested += meshletCount;
+    m_cullingStats.drawRanges += ranges;
+}
+
 bool ModelRenderer::CreateShaders() {
     m_shader = std::make_unique<Shader>();    
-    if (!m_shader->CreateFromFiles("assets/shaders/default/default.vert", "assets/shaders/default/default.frag")) {
+    if (!m_shader->CreateFromFiles(DEFAULT_VERTEX_SHADER, DEFAULT_FRAGMENT_SHADER)) {
         std::cerr << "Failed to create shader program from files" << std::endl;
         return false;
     }
+    BindUniformBlocks(*m_shader);
     return true;
 }
 
-void ModelRenderer::SetShaderUniforms(const Material& material, const glm::mat4& modelMatrix) {
-    if (!m_shader || !m_shader->IsValid()) {
-        return;
+bool ModelRenderer::ReloadShaders() {
+    std::unique_ptr<Shader> shader = std::make_unique<Shader>();
+    if (!shader->CreateFromFiles(DEFAULT_VERTEX_SHADER, DEFAULT_FRAGMENT_SHADER)) {
+        std::cerr << "Failed to reload model shaders, keeping previous version" << std::endl;
+        return false;
+    }
+    BindUniformBlocks(*shader);
+    m_shader = std::move(shader);
+    return true;
+}
+
+bool ModelRenderer::UsesShaderFile(const std::string& path) const {
+    return path == DEFAULT_VERTEX_SHADER || path == DEFAULT_FRAGMENT_SHADER;
+}
+
+void ModelRenderer::GetShaderFiles(std::vector<std::string>& files) const {
+    files.push_back(DEFAULT_VERTEX_SHADER);
+    files.push_back(DEFAULT_FRAGMENT_SHADER);
+}
+
+void ModelRenderer::BindUniformBlocks(Shader& shader) {
+    shader.BindUniformBlock("FrameData", FRAME_UNIFORM_BINDING);
+    shader.BindUniformBlock("MaterialData", MATERIAL_UNIFORM_BINDING);
+}
+
+bool ModelRenderer::CreateUniformBuffers() {
+    glGenBuffers(1, &m_frameUniformBuffer);
+    m_state.BindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    
+    glGenBuffers(1, &m_materialUniformBuffer);
+    m_state.BindBuffer(GL_UNIFORM_BUFFER, m_materialUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, MATERIAL_CAPACITY * sizeof(MaterialUniforms), nullptr, GL_DYNAMIC_DRAW);
+    if (glGetError() == GL_OUT_OF_MEMORY) {
+        DeleteUniformBuffers();
+        return false;
+    }
+    m_residency.Allocate(this, GpuResidency::ResourceType::Buffer, sizeof(FrameUniforms) + MATERIAL_CAPACITY * sizeof(MaterialUniforms));
+    
+    m_materialSlots.clear();
+    m_sharedMaterialSlots.clear();
+    m_freeMaterialSlots.clear();
+    m_transientMaterials.clear();
+    m_materialTableFull = false;
+    for (uint32_t slot = MATERIAL_CAPACITY - 1; slot >= FIRST_MODEL_MATERIAL_SLOT; --slot) {
+        m_freeMaterialSlots.push_back(slot);
+    }
+    UploadMaterial(DEFAULT_MATERIAL_SLOT, MakeMaterialUniforms(m_defaultMaterial));
+    return true;
+}
+
+void ModelRenderer::DeleteUniformBuffers() {
+    if (m_frameUniformBuffer != 0 && m_materialUniformBuffer != 0) {
+        m_residency.Free(this, GpuResidency::ResourceType::Buffer, sizeof(FrameUniforms) + MATERIAL_CAPACITY * sizeof(MaterialUniforms));
     }
+    m_state.DeleteBuffer(m_frameUniformBuffer);
+    m_state.DeleteBuffer(m_materialUniformBuffer);
+    m_materialSlots.clear();
+    m_sharedMaterialSlots.clear();
+    m_freeMaterialSlots.clear();
+    m_transientMaterials.clear();
+}
+
+void ModelRenderer::UpdateFrameUniforms() {
+    FrameUniforms frame;
+    frame.view = m_viewMatrix;
+    frame.projection = m_projectionMatrix;
+    frame.lightPosition = glm::vec4(m_lightPosition, 1.0f);
+    frame.lightColor = glm::vec4(m_lightColor * m_lightIntensity, 1.0f);
+    frame.viewPosition = glm::vec4(m_cameraPosition, 1.0f);
     
-    m_shader->SetMat4("model", modelMatrix);
-    m_shader->SetMat4("view", m_viewMatrix);
-    m_shader->SetMat4("projection", m_projectionMatrix);
+    m_state.BindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    m_state.BindUniformBuffer(FRAME_UNIFORM_BINDING, m_frameUniformBuffer);
+    m_state.BindUniformBuffer(MATERIAL_UNIFORM_BINDING, m_materialUniformBuffer);
+}
+
+uint32_t ModelRenderer::AcquireMaterialSlot(const Model& model, int materialIndex) {
+    MaterialUniforms uniforms = MakeMaterialUniforms(model.materials[materialIndex]);
+    MaterialKey key = { &model, materialIndex };
+    auto it = m_materialSlots.find(key);
+    if (it != m_materialSlots.end()) {
+        if (it->second.uniforms == uniforms) {
+            return it->second.slot;
+        }
+        ReleaseSharedMaterialSlot(it->second.uniforms);
+        m_materialSlots.erase(it);
+    }
     
-    m_shader->SetVec3("lightPos", m_lightPosition);
-    m_shader->SetVec3("lightColor", m_lightColor * m_lightIntensity);
-    m_shader->SetVec3("viewPos", m_cameraPosition);
+    auto shared = m_sharedMaterialSlots.find(uniforms);
+    if (shared != m_sharedMaterialSlots.end()) {
+        ++shared->second.refCount;
+    } else {
+        if (m_freeMaterialSlots.empty()) {
+            if (!m_materialTableFull) {
+                std::cerr << "ModelRenderer: material table full (" << MATERIAL_CAPACITY << " slots, "
+                          << m_sharedMaterialSlots.size() << " distinct materials), drawing " << model.name
+                          << " material " << materialIndex << " with the default material" << std::endl;
+                m_materialTableFull = true;
+            }
+            return DEFAULT_MATERIAL_SLOT;
+        }
+        SharedMaterialSlot entry;
+        entry.slot = m_freeMaterialSlots.back();
+        entry.refCount = 1;
+        m_freeMaterialSlots.pop_back();
+        shared = m_sharedMaterialSlots.emplace(uniforms, entry).first;
+        UploadMaterial(entry.slot, uniforms);
+    }
     
-    SetMaterialUniforms(material);
+    MaterialSlot entry;
+    entry.slot = shared->second.slot;
+    entry.uniforms = uniforms;
+    m_materialSlots[key] = entry;
+    return entry.slot;
 }
 
-void ModelRenderer::SetMaterialUniforms(const Material& material) {
-    if (!m_shader || !m_shader->IsValid()) {
-        return;
+uint32_t ModelRenderer::AcquireTransientMaterialSlot(const Material& material) {
+    MaterialUniforms uniforms = MakeMaterialUniforms(material);
+    for (size_t i = 0; i < m_transientMaterials.size(); ++i) {
+        if (m_transientMaterials[i] == uniforms) {
+            return FIRST_TRANSIENT_MATERIAL_SLOT + static_cast<uint32_t>(i);
+        }
+    }
+    if (m_transientMaterials.size() >= TRANSIENT_MATERIAL_SLOTS) {
+        if (!m_transientMaterialsFull) {
+            std::cerr << "ModelRenderer: more than " << TRANSIENT_MATERIAL_SLOTS
+                      << " loose materials in one frame, using the default material" << std::endl;
+            m_transientMaterialsFull = true;
+        }
+        return DEFAULT_MATERIAL_SLOT;
     }
     
-    m_shader->SetVec3("ambient", material.ambient);
-    m_shader->SetVec3("diffuse", material.diffuse);
-    m_shader->SetVec3("specular", material.specular);
-    m_shader->SetFloat("shininess", material.shininess);
-} 
\ No newline at end of file
+    uint32_t slot = FIRST_TRANSIENT_MATERIAL_SLOT + static_cast<uint32_t>(m_transientMaterials.size());
+    m_transientMaterials.push_back(uniforms);
+    UploadMaterial(slot, uniforms);
+    return slot;
+}
+
+void ModelRenderer::ReleaseMaterialSlots(const Model& model) {
+    for (auto it = m_materialSlots.begin(); it != m_materialSlots.end();) {
+        if (it->first.model == &model) {
+            ReleaseSharedMaterialSlot(it->second.uniforms);
+            it = m_materialSlots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ModelRenderer::ReleaseSharedMaterialSlot(const MaterialUniforms& uniforms) {
+    auto shared = m_sharedMaterialSlots.find(uniforms);
+    if (shared == m_sharedMaterialSlots.end() || --shared->second.refCount > 0) {
+        return;
+    }
+    m_freeMaterialSlots.push_back(shared->second.slot);
+    m_sharedMaterialSlots.erase(shared);
+    m_materialTableFull = false;
+}
+
+ModelRenderer::MaterialUniforms ModelRenderer::MakeMaterialUniforms(const Material& material) {
+    MaterialUniforms uniforms;
+    uniforms.ambient = glm::vec4(material.ambient, 1.0f);
+    uniforms.diffuse = glm::vec4(material.diffuse, 1.0f);
+    uniforms.specular = glm::vec4(material.specular, 1.0f);
+    uniforms.params = glm::vec4(material.shininess, material.transparency, material.refractiveIndex, 0.0f);
+    return uniforms;
+}
+
+void ModelRenderer::UploadMaterial(uint32_t slot, const MaterialUniforms& uniforms) {
+    m_state.BindBuffer(GL_UNIFORM_BUFFER, m_materialUniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, slot * sizeof(MaterialUniforms), sizeof(MaterialUniforms), &uniforms);
+}
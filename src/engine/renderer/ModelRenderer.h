@@ -1,18 +1,67 @@
 #pragma once
 
 #include "../backend/OBJLoader.h"
+#include "VertexPacking.h"
+#include "GpuResidency.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include <deque>
 #include <memory>
+#include <unordered_map>
+#include <string>
+#include <cstring>
 
 class Shader;
+class ThreadPool;
 
 class ModelRenderer {
 public:
-    ModelRenderer();
+    struct CullingStats {
+        size_t meshletsTested;
+        size_t meshletsVisible;
+        size_t trianglesTested;
+        size_t trianglesSubmitted;
+        size_t drawRanges;
+        size_t objectsTested;
+        size_t objectsVisible;
+        size_t objectsCulled;
+        size_t cullJobs;
+        
+        CullingStats() : meshletsTested(0), meshletsVisible(0), trianglesTested(0), trianglesSubmitted(0), drawRanges(0),
+                         objectsTested(0), objectsVisible(0), objectsCulled(0), cullJobs(0) {}
+    };
+    
+    struct InstanceData {
+        glm::mat4 transform;
+        glm::vec4 tint;
+        int materialIndex;
+        
+        InstanceData() : transform(1.0f), tint(1.0f), materialIndex(-1) {}
+        explicit InstanceData(const glm::mat4& matrix) : transform(matrix), tint(1.0f), materialIndex(-1) {}
+    };
+    
+    struct DrawStats {
+        size_t drawCommands;
+        size_t drawCalls;
+        size_t instances;
+        size_t instancedDraws;
+        size_t stateChanges;
+        size_t transparentDraws;
+        size_t residentMaterials;
+        size_t geometryPages;
+        size_t geometryBytes;
+        
+        DrawStats() : drawCommands(0), drawCalls(0), instances(0), instancedDraws(0), stateChanges(0), transparentDraws(0), residentMaterials(0), geometryPages(0), geometryBytes(0) {}
+    };
+    
+    explicit ModelRenderer(GLStateCache& state);
     ~ModelRenderer();
 
     bool Initialize();
@@ -20,34 +69,249 @@ public:
     void SetCamera(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up);
     void SetProjection(float fov, float aspectRatio, float nearPlane, float farPlane);
     void SetLight(const glm::vec3& position, const glm::vec3& color, float intensity = 1.0f);
+    void SetViewportHeight(int height);
+    void SetLodThreshold(float pixels) { m_lodThreshold = pixels; }
+    float GetLodThreshold() const { return m_lodThreshold; }
+    void SetMeshletCulling(bool enable) { m_meshletCulling = enable; }
+    bool GetMeshletCulling() const { return m_meshletCulling; }
+    void SetFrustumCulling(bool enable) { m_frustumCulling = enable; }
+    bool GetFrustumCulling() const { return m_frustumCulling; }
+    void SetThreadPool(ThreadPool* pool) { m_threadPool = pool; }
+    void BeginFrame();
+    const CullingStats& GetCullingStats() const { return m_cullingStats; }
+    const DrawStats& GetDrawStats() const { return m_drawStats; }
+    bool IsUsingIndirectDraws() const { return m_indirectDraws; }
+    void SetUploadBudget(float milliseconds, size_t bytes);
+    void QueueUpload(const Model& model);
+    size_t ProcessUploads();
+    bool IsModelResident(const Model& model) const;
+    void ReleaseModel(const Model& model);
+    bool ReloadShaders();
+    bool UsesShaderFile(const std::string& path) const;
+    void GetShaderFiles(std::vector<std::string>& files) const;
+    size_t GetPendingUploadCount() const { return m_uploadQueue.size(); }
     void RenderModel(const Model& model, const glm::mat4& modelMatrix = glm::mat4(1.0f));
+    void RenderModelInstanced(const Model& model, const InstanceData* instances, size_t count);
+    void RenderModelInstanced(const Model& model, const std::vector<InstanceData>& instances) { RenderModelInstanced(model, instances.data(), instances.size()); }
     void RenderMesh(const Mesh& mesh, const Material& material, const glm::mat4& modelMatrix);
+    void FlushDraws();
+    void SetVertexFormat(VertexFormat format);
+    VertexFormat GetVertexFormat() const { return m_vertexFormat; }
+    size_t GetGpuMemoryUsage() const;
+    size_t GetModelGpuMemory(const Model& model) const;
+    void SetGpuMemoryBudget(size_t bytes) { m_residency.SetBudget(bytes); }
+    const GpuResidency::Stats& GetGpuMemoryStats() const { return m_residency.GetStats(); }
     bool IsInitialized() const { return m_initialized; }
 
 private:
+    struct LodLevel {
+        size_t indexOffset;
+        size_t indexCount;
+        float error;
+        
+        LodLevel() : indexOffset(0), indexCount(0), error(0.0f) {}
+    };
+    
     struct MeshData {
-        GLuint VAO;
-        GLuint VBO;
-        GLuint EBO;
+        GeometryArena::Allocation allocation;
         size_t indexCount;
+        GLenum indexType;
+        size_t vertexBytes;
+        size_t indexBytes;
+        glm::vec3 positionScale;
+        glm::vec3 positionOffset;
+        glm::vec3 boundsCenter;
+        glm::vec3 boundsExtent;
+        float boundsRadius;
+        std::vector<LodLevel> lods;
+        const Vertex* sourceVertices;
+        size_t sourceVertexCount;
+        const Mesh* owner;
         bool initialized;
         
-        MeshData() : VAO(0), VBO(0), EBO(0), indexCount(0), initialized(false) {}
+        MeshData() : indexCount(0), indexType(GL_UNSIGNED_INT),
+                     vertexBytes(0), indexBytes(0), positionScale(1.0f), positionOffset(0.0f),
+                     boundsCenter(0.0f), boundsExtent(0.0f), boundsRadius(0.0f),
+                     sourceVertices(nullptr), sourceVertexCount(0), owner(nullptr), initialized(false) {}
+    };
+    
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+    
+    struct ModelBatch {
+        const Model* model;
+        std::vector<InstanceData> instances;
+        
+        explicit ModelBatch(const Model* source) : model(source) {}
+    };
+    
+    struct CullRange {
+        size_t batch;
+        const Mesh* mesh;
+        size_t first;
+    };
+    
+    struct InstanceRef {
+        uint32_t lod;
+        uint32_t materialSlot;
+        bool translucent;
+        const Material* material;
+        uint32_t instance;
+    };
+    
+    struct FrameUniforms {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 lightPosition;
+        glm::vec4 lightColor;
+        glm::vec4 viewPosition;
+    };
+    
+    struct MaterialUniforms {
+        glm::vec4 ambient;
+        glm::vec4 diffuse;
+        glm::vec4 specular;
+        glm::vec4 params;
+        
+        bool operator==(const MaterialUniforms& other) const {
+            return std::memcmp(this, &other, sizeof(MaterialUniforms)) == 0;
+        }
+    };
+    
+    struct MaterialUniformsHash {
+        size_t operator()(const MaterialUniforms& uniforms) const {
+            const float* values = &uniforms.ambient.x;
+            size_t hash = 0;
+            for (size_t i = 0; i < sizeof(MaterialUniforms) / sizeof(float); ++i) {
+                hash = hash * 31 + std::hash<float>()(values[i]);
+            }
+            return hash;
+        }
+    };
+    
+    struct MaterialKey {
+        const Model* model;
+        int index;
+        
+        bool operator==(const MaterialKey& other) const { return model == other.model && index == other.index; }
+    };
+    
+    struct MaterialKeyHash {
+        size_t operator()(const MaterialKey& key) const {
+            return std::hash<const Model*>()(key.model) * 31 + static_cast<size_t>(key.index);
+        }
+    };
+    
+    struct MaterialSlot {
+        uint32_t slot;
+        MaterialUniforms uniforms;
+    };
+    
+    struct SharedMaterialSlot {
+        uint32_t slot;
+        uint32_t refCount;
+    };
+    
+    struct UploadJob {
+        const Mesh* mesh;
+        MeshData meshData;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        size_t vertexCursor;
+        size_t indexLevel;
+        size_t indexCursor;
+        bool started;
+        
+        explicit UploadJob(const Mesh* source) : mesh(source), boundsMin(0.0f), boundsMax(0.0f), vertexCursor(0), indexLevel(0), indexCursor(0), started(false) {}
     };
     
-    bool CreateMeshBuffers(const Mesh& mesh, MeshData& meshData);
+    MeshData* GetMeshData(const Mesh& mesh);
+    bool IsMeshResident(const Mesh& mesh) const;
+    bool IsUploadQueued(const Mesh& mesh) const;
+    bool BeginUpload(UploadJob& job);
+    size_t EstimateMeshBytes(const Mesh& mesh) const;
+    bool ReserveMemory(size_t bytes);
+    bool EvictMesh(const Mesh* mesh);
+    size_t UploadVertexChunk(UploadJob& job, size_t maxBytes);
+    size_t UploadIndexChunk(UploadJob& job, size_t maxBytes);
+    void* MapStaging(size_t bytes);
+    void CommitStaging(GLuint destination, size_t offset, size_t bytes);
+    void ClearUploads();
     void DeleteMeshBuffers(MeshData& meshData);
+    const LodLevel& SelectLod(const MeshData& meshData, const glm::mat4& modelMatrix) const;
+    void DrawMeshlets(const Mesh& mesh, const MeshData& meshData, const glm::mat4& modelMatrix, GLuint drawIndex, uint64_t key);
+    ModelBatch& GetModelBatch(const Model& model);
+    const Material& ResolveMaterial(const Model& model, int materialIndex, uint32_t& materialSlot);
+    void SubmitModelBatches();
+    void QueueMesh(const Mesh& mesh, const Material& material, uint32_t materialSlot, const glm::mat4& modelMatrix, const glm::vec4& tint);
+    void QueueMeshInstances(const Model& model, const Mesh& mesh, const std::vector<InstanceData>& instances);
+    GLuint PushDrawData(const MeshData& meshData, const glm::mat4& modelMatrix, uint32_t materialSlot, const glm::vec4& tint);
+    float GetViewDepth(const MeshData& meshData, const glm::mat4& modelMatrix) const;
+    uint64_t MakeDrawKey(const MeshData& meshData, const Material& material, uint32_t materialSlot, const glm::mat4& modelMatrix, float alpha) const;
+    void QueueDraw(const MeshData& meshData, size_t indexOffset, size_t indexCount, GLuint drawIndex, GLuint instanceCount, uint64_t key);
+    void ApplyDrawState(uint64_t state, uint64_t previous, bool first);
+    void ClearDraws();
+    void UploadStream(GLenum target, GLuint buffer, size_t& capacity, const void* data, size_t bytes);
+    void ResetGeometry();
     bool CreateShaders();
-    void SetShaderUniforms(const Material& material, const glm::mat4& modelMatrix);
-    void SetMaterialUniforms(const Material& material);
+    void BindUniformBlocks(Shader& shader);
+    bool CreateUniformBuffers();
+    void DeleteUniformBuffers();
+    void UpdateFrameUniforms();
+    uint32_t AcquireMaterialSlot(const Model& model, int materialIndex);
+    uint32_t AcquireTransientMaterialSlot(const Material& material);
+    void ReleaseMaterialSlots(const Model& model);
+    void ReleaseSharedMaterialSlot(const MaterialUniforms& uniforms);
+    static MaterialUniforms MakeMaterialUniforms(const Material& material);
+    void UploadMaterial(uint32_t slot, const MaterialUniforms& uniforms);
 
 private:
     bool m_initialized;
+    GLStateCache& m_state;
     
     std::unique_ptr<Shader> m_shader;
     
     glm::mat4 m_viewMatrix;
     glm::mat4 m_projectionMatrix;
+    float m_farPlane;
+    float m_viewportHeight;
+    float m_lodThreshold;
+    bool m_meshletCulling;
+    bool m_frustumCulling;
+    CullingStats m_cullingStats;
+    FrustumCuller m_frustumCuller;
+    std::vector<CullRange> m_cullRanges;
+    std::vector<InstanceData> m_visibleInstances;
+    ThreadPool* m_threadPool;
+    DrawStats m_drawStats;
+    
+    GeometryArena m_geometry;
+    bool m_indirectDraws;
+    RenderQueue m_renderQueue;
+    std::vector<ModelBatch> m_modelBatches;
+    std::unordered_map<const Model*, size_t> m_modelBatchIndices;
+    std::vector<InstanceRef> m_instanceRefs;
+    std::vector<DrawCommand> m_drawCommands;
+    std::vector<GeometryArena::DrawData> m_drawData;
+    std::vector<DrawCommand> m_indirectCommands;
+    GLuint m_drawDataBuffer;
+    size_t m_drawDataCapacity;
+    GLuint m_indirectBuffer;
+    size_t m_indirectCapacity;
+    
+    GLuint m_frameUniformBuffer;
+    GLuint m_materialUniformBuffer;
+    std::unordered_map<MaterialKey, MaterialSlot, MaterialKeyHash> m_materialSlots;
+    std::unordered_map<MaterialUniforms, SharedMaterialSlot, MaterialUniformsHash> m_sharedMaterialSlots;
+    std::vector<uint32_t> m_freeMaterialSlots;
+    std::vector<MaterialUniforms> m_transientMaterials;
+    bool m_materialTableFull;
+    bool m_transientMaterialsFull;
     
     glm::vec3 m_lightPosition;
     glm::vec3 m_lightColor;
@@ -57,7 +321,18 @@ private:
     glm::vec3 m_cameraTarget;
     glm::vec3 m_cameraUp;
     
-    std::vector<MeshData> m_meshBuffers;
+    std::unordered_map<const Mesh*, MeshData> m_meshBuffers;
+    std::deque<UploadJob> m_uploadQueue;
+    GLuint m_stagingBuffer;
+    bool m_stagingMapped;
+    std::vector<unsigned char> m_stagingFallback;
+    float m_uploadBudgetMs;
+    size_t m_uploadBudgetBytes;
+    VertexFormat m_vertexFormat;
+    GpuResidency m_residency;
     
     Material m_defaultMaterial;
+    
+    static const std::string DEFAULT_VERTEX_SHADER;
+    static const std::string DEFAULT_FRAGMENT_SHADER;
 }; 
\ No newline at end of file
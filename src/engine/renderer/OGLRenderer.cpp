@@ -43,6 +43,7 @@ bool OGLRenderer::SetupWindow(int width, int height, const char* title) {
     }
     
     glfwMakeContextCurrent(m_window);
+    glfwSetWindowUserPointer(m_window, this);
     glfwSetFramebufferSizeCallback(m_window, FramebufferSizeCallback);
     
     return true;
@@ -54,11 +55,11 @@ bool OGLRenderer::SetupOpenGL() {
         return false;
     }
 
-    glViewport(0, 0, m_width, m_height);
+    m_glState.Invalidate();
+    m_glState.SetViewport(0, 0, m_width, m_height);
+    m_glState.SetEnabled(GL_DEPTH_TEST, true);
     
-    glEnable(GL_DEPTH_TEST);
-    
-    m_backgroundRenderer = std::make_unique<BackgroundRenderer>();
+    m_backgroundRenderer = std::make_unique<BackgroundRenderer>(m_glState);
     if (!m_backgroundRenderer->Initialize()) {
         std::cerr << "Failed to initialize BackgroundRenderer\n";
         return false;
@@ -68,7 +69,7 @@ bool OGLRenderer::SetupOpenGL() {
         std::cout << "Using fallback background rendering (no shader)" << std::endl;
     }
     
-    m_modelRenderer = std::make_unique<ModelRenderer>();
+    m_modelRenderer = std::make_unique<ModelRenderer>(m_glState);
     if (!m_modelRenderer->Initialize()) {
         std::cerr << "Failed to initialize ModelRenderer\n";
         return false;
@@ -76,13 +77,19 @@ bool OGLRenderer::SetupOpenGL() {
     
     m_modelRenderer->SetCamera(m_cameraPos, m_cameraTarget, m_cameraUp);
     m_modelRenderer->SetProjection(45.0f, static_cast<float>(m_width)/m_height, 0.1f, 100.0f);
+    m_modelRenderer->SetViewportHeight(m_height);
     m_modelRenderer->SetLight(glm::vec3(5.0f, 5.0f, 5.0f), glm::vec3(1.0f, 1.0f, 1.0f));
     
     return true;
 }
 
 void OGLRenderer::FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    OGLRenderer* renderer = static_cast<OGLRenderer*>(glfwGetWindowUserPointer(window));
+    if (renderer) {
+        renderer->m_glState.SetViewport(0, 0, width, height);
+    } else {
+        glViewport(0, 0, width, height);
+    }
 }
 
 void OGLRenderer::ProcessInput() {
@@ -174,6 +181,8 @@ void OGLRenderer::ProcessInput() {
 }
 
 void OGLRenderer::Render() {
+    m_glState.BeginFrame();
+    m_glState.SetDepthMask(true);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     if (m_backgroundRenderer && m_backgroundRenderer->IsInitialized()) {
@@ -182,9 +191,23 @@ void OGLRenderer::Render() {
         m_backgroundRenderer->Render();
     }
     
-    if (m_model && m_modelRenderer && m_modelRenderer->IsInitialized()) {
-        glm::mat4 modelMatrix = glm::mat4(1.0f);
-        m_modelRenderer->RenderModel(*m_model, modelMatrix);
+    if (m_engine) {
+        m_engine->UpdateHotReload();
+        m_engine->UpdateAsyncLoads();
+        m_engine->UpdateStreaming(m_cameraPos);
+    }
+    
+    if (m_modelRenderer && m_modelRenderer->IsInitialized()) {
+        m_modelRenderer->BeginFrame();
+        if (m_model) {
+            glm::mat4 modelMatrix = glm::mat4(1.0f);
+            m_modelRenderer->RenderModel(*m_model, modelMatrix);
+        }
+        for (const Model* model : m_streamedModels) {
+            m_modelRenderer->RenderModel(*model, glm::mat4(1.0f));
+        }
+        m_modelRenderer->FlushDraws();
+        m_modelRenderer->ProcessUploads();
     }
     
     if (m_engine) {
@@ -220,6 +243,68 @@ void OGLRenderer::UpdateCamera() {
     }
 }
 
+void OGLRenderer::QueueModelUpload(const Model& model) {
+    if (m_modelRenderer && m_modelRenderer->IsInitialized()) {
+        m_modelRenderer->QueueUpload(model);
+    }
+}
+
+bool OGLRenderer::IsModelResident(const Model& model) const {
+    return m_modelRenderer && m_modelRenderer->IsInitialized() && m_modelRenderer->IsModelResident(model);
+}
+
+void OGLRenderer::ReleaseModel(const Model& model) {
+    if (m_modelRenderer) {
+        m_modelRenderer->ReleaseModel(model);
+    }
+}
+
+void OGLRenderer::SetGpuMemoryBudget(size_t bytes) {
+    if (m_modelRenderer) {
+        m_modelRenderer->SetGpuMemoryBudget(bytes);
+    }
+}
+
+GpuResidency::Stats OGLRenderer::GetGpuMemoryStats() const {
+    return m_modelRenderer ? m_modelRenderer->GetGpuMemoryStats() : GpuResidency::Stats();
+}
+
+ModelRenderer::CullingStats OGLRenderer::GetCullingStats() const {
+    return m_modelRenderer ? m_modelRenderer->GetCullingStats() : ModelRenderer::CullingStats();
+}
+
+void OGLRenderer::SetThreadPool(ThreadPool* pool) {
+    if (m_modelRenderer) {
+        m_modelRenderer->SetThreadPool(pool);
+    }
+}
+
+bool OGLRenderer::ReloadShaderFile(const std::string& path) {
+    bool handled = false;
+    if (m_modelRenderer && m_modelRenderer->IsInitialized() && m_modelRenderer->UsesShaderFile(path)) {
+        if (m_modelRenderer->ReloadShaders()) {
+            std::cout << "Reloaded model shaders after change to " << path << std::endl;
+        }
+        handled = true;
+    }
+    if (m_backgroundRenderer && m_backgroundRenderer->UsesShaderFile(path)) {
+        if (m_backgroundRenderer->ReloadShader()) {
+            std::cout << "Reloaded background shader after change to " << path << std::endl;
+        }
+        handled = true;
+    }
+    return handled;
+}
+
+void OGLRenderer::GetShaderFiles(std::vector<std::string>& files) const {
+    if (m_modelRenderer) {
+        m_modelRenderer->GetShaderFiles(files);
+    }
+    if (m_backgroundRenderer) {
+        m_backgroundRenderer->GetShaderFiles(files);
+    }
+}
+
 void OGLRenderer::SetBackgroundColor(const glm::vec4& color) {
     if (m_backgroundRenderer) {
         m_backgroundRenderer->SetColor(color);
@@ -4,6 +4,7 @@
 #include "ModelRenderer.h"
 #include "../Engine.h"
 #include "BackgroundRenderer.h"
+#include "GLStateCache.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
@@ -23,6 +24,17 @@ public:
     int GetHeight() const override { return m_height; }
     
     void SetModel(const Model* model) { m_model = model; }
+    void SetStreamedModels(const std::vector<const Model*>& models) { m_streamedModels = models; }
+    void QueueModelUpload(const Model& model);
+    bool IsModelResident(const Model& model) const;
+    void ReleaseModel(const Model& model);
+    void SetGpuMemoryBudget(size_t bytes);
+    GpuResidency::Stats GetGpuMemoryStats() const;
+    GLStateCache::Stats GetStateCacheStats() const { return m_glState.GetFrameStats(); }
+    ModelRenderer::CullingStats GetCullingStats() const;
+    void SetThreadPool(ThreadPool* pool);
+    bool ReloadShaderFile(const std::string& path);
+    void GetShaderFiles(std::vector<std::string>& files) const;
     
     void SetBackgroundColor(const glm::vec4& color);
     void SetBackgroundGradient(const glm::vec4& topColor, const glm::vec4& bottomColor);
@@ -36,6 +48,8 @@ private:
     int m_width;
     int m_height;
     const Model* m_model;
+    std::vector<const Model*> m_streamedModels;
+    GLStateCache m_glState;
     std::unique_ptr<ModelRenderer> m_modelRenderer;
     std::unique_ptr<BackgroundRenderer> m_backgroundRenderer;
     Engine* m_engine;
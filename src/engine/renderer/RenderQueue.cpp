@@ -0,0 +1,103 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t PASS_SHIFT = 62;
+
+const uint32_t OPAQUE_SHADER_SHIFT = 54;
+const uint32_t OPAQUE_MATERIAL_SHIFT = 38;
+const uint32_t OPAQUE_VAO_SHIFT = 26;
+const uint32_t OPAQUE_DEPTH_SHIFT = 2;
+
+const uint32_t TRANSPARENT_DEPTH_SHIFT = 38;
+const uint32_t TRANSPARENT_SHADER_SHIFT = 30;
+const uint32_t TRANSPARENT_MATERIAL_SHIFT = 14;
+const uint32_t TRANSPARENT_VAO_SHIFT = 2;
+
+uint64_t Field(uint64_t key, uint32_t shift, uint32_t bits) {
+    return (key >> shift) & ((uint64_t(1) << bits) - 1);
+}
+
+uint64_t Pack(uint32_t value, uint32_t shift, uint32_t bits) {
+    uint64_t mask = (uint64_t(1) << bits) - 1;
+    return (static_cast<uint64_t>(value) & mask) << shift;
+}
+
+}
+
+uint64_t RenderQueue::MakeKey(Pass pass, uint32_t shader, uint32_t material, uint32_t vao, float depth) {
+    const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+    uint32_t quantized = static_cast<uint32_t>(clamped * maxDepth);
+
+    uint64_t key = static_cast<uint64_t>(pass) << PASS_SHIFT;
+    if (pass == Pass::Transparent) {
+        key |= Pack(maxDepth - quantized, TRANSPARENT_DEPTH_SHIFT, DEPTH_BITS);
+        key |= Pack(shader, TRANSPARENT_SHADER_SHIFT, SHADER_BITS);
+        key |= Pack(material, TRANSPARENT_MATERIAL_SHIFT, MATERIAL_BITS);
+        key |= Pack(vao, TRANSPARENT_VAO_SHIFT, VAO_BITS);
+    } else {
+        key |= Pack(shader, OPAQUE_SHADER_SHIFT, SHADER_BITS);
+        key |= Pack(material, OPAQUE_MATERIAL_SHIFT, MATERIAL_BITS);
+        key |= Pack(vao, OPAQUE_VAO_SHIFT, VAO_BITS);
+        key |= Pack(quantized, OPAQUE_DEPTH_SHIFT, DEPTH_BITS);
+    }
+    return key;
+}
+
+uint32_t RenderQueue::GetShader(uint64_t key) {
+    uint32_t shift = GetPass(key) == Pass::Transparent ? TRANSPARENT_SHADER_SHIFT : OPAQUE_SHADER_SHIFT;
+    return static_cast<uint32_t>(Field(key, shift, SHADER_BITS));
+}
+
+uint32_t RenderQueue::GetMaterial(uint64_t key) {
+    uint32_t shift = GetPass(key) == Pass::Transparent ? TRANSPARENT_MATERIAL_SHIFT : OPAQUE_MATERIAL_SHIFT;
+    return static_cast<uint32_t>(Field(key, shift, MATERIAL_BITS));
+}
+
+uint32_t RenderQueue::GetVao(uint64_t key) {
+    uint32_t shift = GetPass(key) == Pass::Transparent ? TRANSPARENT_VAO_SHIFT : OPAQUE_VAO_SHIFT;
+    return static_cast<uint32_t>(Field(key, shift, VAO_BITS));
+}
+
+uint64_t RenderQueue::GetStateBits(uint64_t key) {
+    uint32_t shift = GetPass(key) == Pass::Transparent ? TRANSPARENT_DEPTH_SHIFT : OPAQUE_DEPTH_SHIFT;
+    return key & ~(((uint64_t(1) << DEPTH_BITS) - 1) << shift);
+}
+
+void RenderQueue::Push(uint64_t key, uint32_t payload) {
+    Item item;
+    item.key = key;
+    item.payload = payload;
+    m_items.push_back(item);
+}
+
+void RenderQueue::Sort() {
+    if (m_items.size() < 2) {
+        return;
+    }
+
+    m_scratch.resize(m_items.size());
+    size_t counts[256];
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        std::fill(counts, counts + 256, 0);
+        for (const auto& item : m_items) {
+            ++counts[(item.key >> shift) & 0xFF];
+        }
+        if (counts[(m_items[0].key >> shift) & 0xFF] == m_items.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t bucket = count;
+            count = offset;
+            offset += bucket;
+        }
+        for (const auto& item : m_items) {
+            m_scratch[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        m_items.swap(m_scratch);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RenderQueue {
+public:
+    enum class Pass : uint32_t {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    struct Item {
+        uint64_t key;
+        uint32_t payload;
+    };
+
+    static const uint32_t SHADER_BITS = 8;
+    static const uint32_t MATERIAL_BITS = 16;
+    static const uint32_t VAO_BITS = 12;
+    static const uint32_t DEPTH_BITS = 24;
+
+    static uint64_t MakeKey(Pass pass, uint32_t shader, uint32_t material, uint32_t vao, float depth);
+    static Pass GetPass(uint64_t key) { return static_cast<Pass>(key >> 62); }
+    static uint32_t GetShader(uint64_t key);
+    static uint32_t GetMaterial(uint64_t key);
+    static uint32_t GetVao(uint64_t key);
+    static uint64_t GetStateBits(uint64_t key);
+
+    void Push(uint64_t key, uint32_t payload);
+    void Sort();
+    void Clear() { m_items.clear(); }
+
+    const std::vector<Item>& GetItems() const { return m_items; }
+    size_t GetSize() const { return m_items.size(); }
+    bool IsEmpty() const { return m_items.empty(); }
+
+private:
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratch;
+};
@@ -74,6 +74,91 @@ void RendererInit::SetModel(const Model* model) {
     }
 }
 
+void RendererInit::SetStreamedModels(const std::vector<const Model*>& models) {
+    if (m_renderer) {
+        if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
+            oglRenderer->SetStreamedModels(models);
+        }
+    }
+}
+
+void RendererInit::QueueModelUpload(const Model& model) {
+    if (m_renderer) {
+        if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
+            oglRenderer->QueueModelUpload(model);
+        }
+    }
+}
+
+bool RendererInit::IsModelResident(const Model& model) const {
+    if (m_renderer) {
+        if (const OGLRenderer* oglRenderer = dynamic_cast<const OGLRenderer*>(m_renderer)) {
+            return oglRenderer->IsModelResident(model);
+        }
+    }
+    return false;
+}
+
+void RendererInit::ReleaseModel(const Model& model) {
+    if (m_renderer) {
+        if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
+            oglRenderer->ReleaseModel(model);
+        }
+    }
+}
+
+void RendererInit::SetGpuMemoryBudget(size_t bytes) {
+    if (m_renderer) {
+        if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
+            oglRenderer->SetGpuMemoryBudget(bytes);
+        }
+    }
+}
+
+GpuResidency::Stats RendererInit::GetGpuMemoryStats() const {
+    if (m_renderer) {
+        if (const OGLRenderer* oglRenderer = dynamic_cast<const OGLRenderer*>(m_renderer)) {
+            return oglRenderer->GetGpuMemoryStats();
+        }
+    }
+    return GpuResidency::Stats();
+}
+
+GLStateCache::Stats RendererInit::GetStateCacheStats() const {
+    if (m_renderer) {
+        if (const OGLRenderer* oglRenderer = dynamic_cast<const OGLRenderer*>(m_renderer)) {
+            return oglRenderer->GetStateCacheStats();
+        }
+    }
+    return GLStateCache::Stats();
+}
+
+ModelRenderer::CullingStats RendererInit::GetCullingStats() const {
+    if (m_renderer) {
+        if (const OGLRenderer* oglRenderer = dynamic_cast<const OGLRenderer*>(m_renderer)) {
+            return oglRenderer->GetCullingStats();
+        }
+    }
+    return ModelRenderer::CullingStats();
+}
+
+bool RendererInit::ReloadShaderFile(const std::string& path) {
+    if (m_renderer) {
+        if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
+            return oglRenderer->ReloadShaderFile(path);
+        }
+    }
+    return false;
+}
+
+void RendererInit::GetShaderFiles(std::vector<std::string>& files) const {
+    if (m_renderer) {
+        if (const OGLRenderer* oglRenderer = dynamic_cast<const OGLRenderer*>(m_renderer)) {
+            oglRenderer->GetShaderFiles(files);
+        }
+    }
+}
+
 void RendererInit::SetBackgroundColor(const glm::vec4& color) {
     if (m_renderer) {
         if (OGLRenderer* oglRenderer = dynamic_cast<OGLRenderer*>(m_renderer)) {
@@ -19,6 +19,16 @@ public:
     bool IsRendererRunning() const;
     Renderer* GetRenderer() { return m_renderer; }    
     void SetModel(const Model* model);
+    void SetStreamedModels(const std::vector<const Model*>& models);
+    void QueueModelUpload(const Model& model);
+    bool IsModelResident(const Model& model) const;
+    void ReleaseModel(const Model& model);
+    void SetGpuMemoryBudget(size_t bytes);
+    GpuResidency::Stats GetGpuMemoryStats() const;
+    GLStateCache::Stats GetStateCacheStats() const;
+    ModelRenderer::CullingStats GetCullingStats() const;
+    bool ReloadShaderFile(const std::string& path);
+    void GetShaderFiles(std::vector<std::string>& files) const;
     
     void SetBackgroundColor(const glm::vec4& color);
     void SetBackgroundGradient(const glm::vec4& topColor, const glm::vec4& bottomColor);
@@ -1,7 +1,8 @@
 #include "Shader.h"
+#include "../backend/VirtualFileSystem.h"
+#include <algorithm>
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <vector>
 
 Shader::Shader() : m_programID(0), m_initialized(false) {
 }
@@ -17,6 +18,8 @@ bool Shader::Create(const std::string& vertexSource, const std::string& fragment
         glDeleteProgram(m_programID);
         m_programID = 0;
         m_initialized = false;
+        m_uniformLocations.clear();
+        m_uniformBlocks.clear();
     }
     
     GLuint vertexShader;
@@ -46,17 +49,26 @@ bool Shader::Create(const std::string& vertexSource, const std::string& fragment
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
     
+    Reflect();
     m_initialized = true;
     return true;
 }
 
 bool Shader::CreateFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
-    std::string vertexSource = LoadShaderFile(vertexPath);
-    std::string fragmentSource = LoadShaderFile(fragmentPath);
-    if (vertexSource.empty() || fragmentSource.empty()) {
-        return false;
-    }    
-    return Create(vertexSource, fragmentSource);
+    std::vector<VirtualFileSystem::ReadRequest> requests;
+    requests.emplace_back(vertexPath);
+    requests.emplace_back(fragmentPath);
+    VirtualFileSystem::GetDefault().ReadFiles(requests);
+
+    std::string sources[2];
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!requests[i].success || requests[i].data.empty()) {
+            std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << requests[i].path << std::endl;
+            return false;
+        }
+        sources[i].assign(requests[i].data.begin(), requests[i].data.end());
+    }
+    return Create(sources[0], sources[1]);
 }
 
 void Shader::Use() {
@@ -65,51 +77,121 @@ void Shader::Use() {
     }
 }
 
+GLint Shader::GetUniformLocation(const std::string& name) const {
+    auto it = m_uniformLocations.find(name);
+    return it != m_uniformLocations.end() ? it->second : -1;
+}
+
+GLuint Shader::GetUniformBlockIndex(const std::string& name) const {
+    auto it = m_uniformBlocks.find(name);
+    return it != m_uniformBlocks.end() ? it->second : GL_INVALID_INDEX;
+}
+
+bool Shader::BindUniformBlock(const std::string& name, GLuint binding) {
+    GLuint index = GetUniformBlockIndex(name);
+    if (index == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(m_programID, index, binding);
+    return true;
+}
+
+void Shader::Reflect() {
+    m_uniformLocations.clear();
+    m_uniformBlocks.clear();
+    
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<char> name(static_cast<size_t>(std::max(maxNameLength, 1)));
+    
+    for (GLint i = 0; i < uniformCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_programID, static_cast<GLuint>(i), maxNameLength, &length, &size, &type, name.data());
+        
+        std::string uniformName(name.data(), length);
+        GLint location = glGetUniformLocation(m_programID, uniformName.c_str());
+        if (location < 0) {
+            continue;
+        }
+        
+        size_t subscript = uniformName.find('[');
+        if (subscript != std::string::npos) {
+            m_uniformLocations[uniformName] = location;
+            uniformName.erase(subscript);
+        }
+        m_uniformLocations[uniformName] = location;
+    }
+    
+    GLint blockCount = 0;
+    GLint maxBlockNameLength = 0;
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockNameLength);
+    name.resize(static_cast<size_t>(std::max(maxBlockNameLength, 1)));
+    
+    for (GLint i = 0; i < blockCount; ++i) {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(m_programID, static_cast<GLuint>(i), maxBlockNameLength, &length, name.data());
+        m_uniformBlocks[std::string(name.data(), length)] = static_cast<GLuint>(i);
+    }
+}
+
 void Shader::SetBool(const std::string& name, bool value) {
-    if (m_initialized) {
-        glUniform1i(glGetUniformLocation(m_programID, name.c_str()), static_cast<int>(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform1i(location, static_cast<int>(value));
     }
 }
 
 void Shader::SetInt(const std::string& name, int value) {
-    if (m_initialized) {
-        glUniform1i(glGetUniformLocation(m_programID, name.c_str()), value);
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform1i(location, value);
     }
 }
 
 void Shader::SetFloat(const std::string& name, float value) {
-    if (m_initialized) {
-        glUniform1f(glGetUniformLocation(m_programID, name.c_str()), value);
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform1f(location, value);
     }
 }
 
 void Shader::SetVec2(const std::string& name, const glm::vec2& value) {
-    if (m_initialized) {
-        glUniform2fv(glGetUniformLocation(m_programID, name.c_str()), 1, glm::value_ptr(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform2fv(location, 1, glm::value_ptr(value));
     }
 }
 
 void Shader::SetVec3(const std::string& name, const glm::vec3& value) {
-    if (m_initialized) {
-        glUniform3fv(glGetUniformLocation(m_programID, name.c_str()), 1, glm::value_ptr(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
     }
 }
 
 void Shader::SetVec4(const std::string& name, const glm::vec4& value) {
-    if (m_initialized) {
-        glUniform4fv(glGetUniformLocation(m_programID, name.c_str()), 1, glm::value_ptr(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
     }
 }
 
 void Shader::SetMat3(const std::string& name, const glm::mat3& value) {
-    if (m_initialized) {
-        glUniformMatrix3fv(glGetUniformLocation(m_programID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
     }
 }
 
 void Shader::SetMat4(const std::string& name, const glm::mat4& value) {
-    if (m_initialized) {
-        glUniformMatrix4fv(glGetUniformLocation(m_programID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    GLint location = GetUniformLocation(name);
+    if (location >= 0) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
     }
 }
 
@@ -157,19 +239,9 @@ bool Shader::CheckProgramErrors(GLuint programID) {
 
 std::string Shader::LoadShaderFile(const std::string& filepath) {
     std::string shaderCode;
-    std::ifstream shaderFile;
-    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        shaderFile.open(filepath);
-        std::stringstream shaderStream;
-        shaderStream << shaderFile.rdbuf();        
-        shaderFile.close();        
-        shaderCode = shaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
+    if (!VirtualFileSystem::GetDefault().ReadText(filepath, shaderCode)) {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filepath << std::endl;
-        std::cerr << "Error: " << e.what() << std::endl;
         return "";
     }
     return shaderCode;
-} 
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <string>
+#include <unordered_map>
 
 class Shader {
 public:
@@ -21,6 +22,9 @@ public:
     void SetVec4(const std::string& name, const glm::vec4& value);
     void SetMat3(const std::string& name, const glm::mat3& value);
     void SetMat4(const std::string& name, const glm::mat4& value);
+    GLint GetUniformLocation(const std::string& name) const;
+    GLuint GetUniformBlockIndex(const std::string& name) const;
+    bool BindUniformBlock(const std::string& name, GLuint binding);
     GLuint GetProgramID() const { return m_programID; }
     bool IsValid() const { return m_programID != 0; }
 
@@ -29,8 +33,11 @@ private:
     bool CheckShaderErrors(GLuint shaderID);
     bool CheckProgramErrors(GLuint programID);    
     std::string LoadShaderFile(const std::string& filepath);
+    void Reflect();
 
 private:
     GLuint m_programID;
     bool m_initialized;
+    std::unordered_map<std::string, GLint> m_uniformLocations;
+    std::unordered_map<std::string, GLuint> m_uniformBlocks;
 }; 
\ No newline at end of file
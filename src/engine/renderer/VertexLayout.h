@@ -0,0 +1,60 @@
+#pragma once
+
+#include "VertexPacking.h"
+#include <glad/glad.h>
+#include <cstddef>
+
+template<GLuint Location, GLint Components, GLenum Type, GLboolean Normalized, typename Storage>
+struct VertexAttribute {
+    static const GLuint location = Location;
+    static const GLint components = Components;
+    static const GLenum type = Type;
+    static const GLboolean normalized = Normalized;
+    static const size_t size = sizeof(Storage);
+};
+
+template<typename... Attributes>
+struct VertexAttributeList;
+
+template<>
+struct VertexAttributeList<> {
+    static const size_t size = 0;
+
+    static void Apply(GLsizei, size_t) {}
+};
+
+template<typename First, typename... Rest>
+struct VertexAttributeList<First, Rest...> {
+    static const size_t size = First::size + VertexAttributeList<Rest...>::size;
+
+    static void Apply(GLsizei stride, size_t offset) {
+        glEnableVertexAttribArray(First::location);
+        glVertexAttribPointer(First::location, First::components, First::type, First::normalized,
+                              stride, reinterpret_cast<const void*>(offset));
+        VertexAttributeList<Rest...>::Apply(stride, offset + First::size);
+    }
+};
+
+template<typename VertexType, typename... Attributes>
+struct VertexLayout {
+    static_assert(VertexAttributeList<Attributes...>::size == sizeof(VertexType),
+                  "Vertex layout attributes must cover the vertex type exactly");
+
+    static const GLsizei stride = static_cast<GLsizei>(sizeof(VertexType));
+
+    static void Apply() {
+        VertexAttributeList<Attributes...>::Apply(stride, 0);
+    }
+};
+
+typedef VertexLayout<Vertex,
+    VertexAttribute<0, 3, GL_FLOAT, GL_FALSE, glm::vec3>,
+    VertexAttribute<1, 3, GL_FLOAT, GL_FALSE, glm::vec3>,
+    VertexAttribute<2, 2, GL_FLOAT, GL_FALSE, glm::vec2>,
+    VertexAttribute<3, 3, GL_FLOAT, GL_FALSE, glm::vec3>> FullVertexLayout;
+
+typedef VertexLayout<PackedVertex,
+    VertexAttribute<0, 3, GL_UNSIGNED_SHORT, GL_TRUE, uint16_t[4]>,
+    VertexAttribute<1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, uint32_t>,
+    VertexAttribute<3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, uint32_t>,
+    VertexAttribute<2, 2, GL_HALF_FLOAT, GL_FALSE, uint16_t[2]>> PackedVertexLayout;
@@ -0,0 +1,148 @@
+#include "VertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t VertexPacker::FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu) {
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float VertexPacker::HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            int shift = 0;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                ++shift;
+            }
+            mantissa &= 0x3FFu;
+            bits = sign | (static_cast<uint32_t>(127 - 15 + 1 - shift) << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+uint32_t VertexPacker::PackSnorm1010102(const glm::vec3& value, float w) {
+    auto pack = [](float component, float scale, uint32_t mask) {
+        float clamped = std::max(-1.0f, std::min(1.0f, component));
+        int32_t quantized = static_cast<int32_t>(std::lround(clamped * scale));
+        return static_cast<uint32_t>(quantized) & mask;
+    };
+
+    return pack(value.x, 511.0f, 0x3FFu)
+         | (pack(value.y, 511.0f, 0x3FFu) << 10)
+         | (pack(value.z, 511.0f, 0x3FFu) << 20)
+         | (pack(w, 1.0f, 0x3u) << 30);
+}
+
+glm::vec3 VertexPacker::UnpackSnorm1010102(uint32_t value) {
+    auto unpack = [](uint32_t bits) {
+        int32_t signedValue = static_cast<int32_t>(bits << 22) >> 22;
+        return std::max(-1.0f, static_cast<float>(signedValue) / 511.0f);
+    };
+    return glm::vec3(unpack(value & 0x3FFu), unpack((value >> 10) & 0x3FFu), unpack((value >> 20) & 0x3FFu));
+}
+
+uint16_t VertexPacker::QuantizeUnorm16(float value) {
+    float clamped = std::max(0.0f, std::min(1.0f, value));
+    return static_cast<uint16_t>(std::lround(clamped * 65535.0f));
+}
+
+glm::vec3 VertexPacker::GetPositionScale(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    return glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+}
+
+void VertexPacker::PackVertices(const Mesh& mesh, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                                std::vector<PackedVertex>& packed) {
+    packed.resize(mesh.GetVertexCount());
+    PackVertices(mesh.GetVertexData(), packed.size(), boundsMin, boundsMax, packed.data());
+}
+
+void VertexPacker::PackVertices(const Vertex* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                                PackedVertex* packed) {
+    glm::vec3 extent = GetPositionScale(boundsMin, boundsMax);
+    glm::vec3 inverseExtent(
+        extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+        extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& vertex = vertices[i];
+        PackedVertex& out = packed[i];
+
+        glm::vec3 normalized = (vertex.position - boundsMin) * inverseExtent;
+        out.position[0] = QuantizeUnorm16(normalized.x);
+        out.position[1] = QuantizeUnorm16(normalized.y);
+        out.position[2] = QuantizeUnorm16(normalized.z);
+        out.position[3] = 0;
+        out.normal = PackSnorm1010102(vertex.normal, 0.0f);
+        out.tangent = PackSnorm1010102(vertex.tangent, 1.0f);
+        out.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+        out.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+    }
+}
+
+void VertexPacker::PackIndices(const Mesh& mesh, std::vector<uint16_t>& packed) {
+    PackIndices(mesh.GetIndexData(), mesh.GetIndexCount(), packed);
+}
+
+void VertexPacker::PackIndices(const unsigned int* indices, size_t count, std::vector<uint16_t>& packed) {
+    packed.resize(count);
+    PackIndices(indices, count, packed.data());
+}
+
+void VertexPacker::PackIndices(const unsigned int* indices, size_t count, uint16_t* packed) {
+    for (size_t i = 0; i < count; ++i) {
+        packed[i] = static_cast<uint16_t>(indices[i]);
+    }
+}
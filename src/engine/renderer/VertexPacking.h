@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../backend/OBJLoader.h"
+#include <cstdint>
+#include <vector>
+
+enum class VertexFormat {
+    Full,
+    Packed
+};
+
+struct PackedVertex {
+    uint16_t position[4];
+    uint32_t normal;
+    uint32_t tangent;
+    uint16_t texCoord[2];
+};
+
+class VertexPacker {
+public:
+    static uint16_t FloatToHalf(float value);
+    static float HalfToFloat(uint16_t value);
+    static uint32_t PackSnorm1010102(const glm::vec3& value, float w);
+    static glm::vec3 UnpackSnorm1010102(uint32_t value);
+    static uint16_t QuantizeUnorm16(float value);
+
+    static void PackVertices(const Mesh& mesh, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                             std::vector<PackedVertex>& packed);
+    static void PackVertices(const Vertex* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                             PackedVertex* packed);
+    static void PackIndices(const Mesh& mesh, std::vector<uint16_t>& packed);
+    static void PackIndices(const unsigned int* indices, size_t count, std::vector<uint16_t>& packed);
+    static void PackIndices(const unsigned int* indices, size_t count, uint16_t* packed);
+    static glm::vec3 GetPositionScale(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+};
@@ -1,7 +1,16 @@
 #include "engine/Engine.h"
 #include "engine/backend/CommandArgs.h"
+#include "engine/backend/LoaderBenchmark.h"
+#include "engine/backend/PackArchive.h"
+#include "engine/backend/StageBundle.h"
 #include <iostream>
 #include <algorithm>
+#include <climits>
+#include <cstdint>
+
+static void PrintBenchmarkUsage() {
+    std::cerr << "Usage: -benchmark=<file.obj> [-generate=<megabytes> [-force=1]] [-arena=<copies>] [-iterations=<count>]" << std::endl;
+}
 
 int main(int argc, char* argv[]) {
     CommandArgs args;
@@ -9,6 +18,39 @@ int main(int argc, char* argv[]) {
         return -1;
     }
     
+    if (args.HasArg("benchmark")) {
+        std::string filename = args.GetValue("benchmark", "");
+        size_t generate = 0;
+        size_t arena = 0;
+        size_t iterations = 0;
+        if (!args.GetUnsigned("generate", 0, SIZE_MAX / (1024 * 1024), generate)
+            || !args.GetUnsigned("arena", 8, INT_MAX, arena)
+            || !args.GetUnsigned("iterations", 3, INT_MAX, iterations)) {
+            PrintBenchmarkUsage();
+            return -1;
+        }
+        if (args.HasArg("generate") && !LoaderBenchmark::GenerateTestFile(filename, generate, args.GetValue("force", "0") != "0")) {
+            return -1;
+        }
+        if (args.HasArg("arena")) {
+            return LoaderBenchmark::RunArena(filename, static_cast<int>(arena)) ? 0 : -1;
+        }
+        return LoaderBenchmark::Run(filename, static_cast<int>(iterations)) ? 0 : -1;
+    }
+    
+    if (args.HasArg("cook")) {
+        OBJLoader loader;
+        Engine::ConfigureModelLoader(loader);
+        loader.SetUseCache(false);
+        return StageBundle::Cook(args.GetValue("cook", Engine::DEFAULT_STAGE), loader, args.GetValue("force", "0") != "0") ? 0 : -1;
+    }
+    
+    if (args.HasArg("pack")) {
+        PackArchive::WriteOptions options;
+        options.compress = args.GetValue("compress", "1") != "0";
+        return PackArchive::Write(args.GetValue("output", Engine::ASSET_ARCHIVE), args.GetValue("pack", "assets"), options) ? 0 : -1;
+    }
+    
     if (!args.IsRendererValid()) {
         std::cerr << "Invalid renderer specified. Available options:" << std::endl;
         std::cerr << "  -renderer=opengl" << std::endl;
@@ -36,6 +78,7 @@ int main(int argc, char* argv[]) {
         std::cerr << "Failed to initialize engine" << std::endl;
         return -1;
     }    
+    engine.SetHotReload(args.GetValue("hotreload", "0") != "0");
     engine.PrintSystemInfo();    
     engine.Run();
     return 0;